@@ -0,0 +1,76 @@
+#ifndef ASSIGNMENTS_EV_ALIGNED_BUFFER_H_
+#define ASSIGNMENTS_EV_ALIGNED_BUFFER_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <new>
+
+namespace ev::detail {
+
+/*
+ * Alignment (in bytes) of every buffer handed out by AllocateAligned. One cache line, which is
+ * also the width of the widest SIMD register we target.
+ */
+inline constexpr std::size_t kCacheLineSize = 64;
+
+/*
+ * Number of doubles that fit in one cache line. Row strides of batch types are rounded up to a
+ * multiple of this so that every row starts on a cache line.
+ */
+inline constexpr int kDoublesPerCacheLine = static_cast<int>(kCacheLineSize / sizeof(double));
+
+struct AlignedDeleter {
+  void operator()(double* p) const noexcept {
+    ::operator delete[](p, std::align_val_t{kCacheLineSize});
+  }
+};
+
+using AlignedDoubleBuffer = std::unique_ptr<double[], AlignedDeleter>;
+
+/*
+ * Allocates a zero-initialised, cache-line aligned array of count doubles.
+ */
+inline AlignedDoubleBuffer AllocateAligned(std::size_t count) {
+  if (count == 0) {
+    return AlignedDoubleBuffer(nullptr);
+  }
+  auto* p = static_cast<double*>(
+      ::operator new[](count * sizeof(double), std::align_val_t{kCacheLineSize}));
+  for (std::size_t i = 0; i < count; ++i) {
+    p[i] = 0.0;
+  }
+  return AlignedDoubleBuffer(p);
+}
+
+/*
+ * Largest count that can be rounded up to whole cache lines without leaving the range of int.
+ */
+inline constexpr int kMaxPaddedCount =
+    std::numeric_limits<int>::max() / kDoublesPerCacheLine * kDoublesPerCacheLine;
+
+/*
+ * Rounds n up to the next multiple of kDoublesPerCacheLine. Computed in 64 bits so it cannot
+ * overflow; the result fits in an int exactly when n <= kMaxPaddedCount.
+ */
+constexpr std::int64_t PadToCacheLine(std::int64_t n) noexcept {
+  return (n + kDoublesPerCacheLine - 1) / kDoublesPerCacheLine * kDoublesPerCacheLine;
+}
+
+/*
+ * PadToCacheLine for a count about to be allocated and stored as an int. Fails the way new[]
+ * fails on a length it cannot represent.
+ * When: n > kMaxPaddedCount
+ * Throw: std::bad_array_new_length
+ */
+inline int CheckedPadToCacheLine(int n) {
+  if (n > kMaxPaddedCount) {
+    throw std::bad_array_new_length();
+  }
+  return static_cast<int>(PadToCacheLine(n));
+}
+
+}  // namespace ev::detail
+
+#endif  // ASSIGNMENTS_EV_ALIGNED_BUFFER_H_
@@ -0,0 +1,239 @@
+#include "assignments/ev/async_query.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <coroutine>
+#include <cstdint>
+#include <exception>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "assignments/ev/euclidean_vector.h"
+#include "assignments/ev/euclidean_vector_batch.h"
+#include "assignments/ev/kernels.h"
+#include "assignments/ev/neighbor.h"
+#include "assignments/ev/parallel.h"
+#include "assignments/ev/thread_pool.h"
+
+namespace {
+
+// Rows scored against every query of a batch before moving on: 256 rows of up to a few hundred
+// dimensions stay in L2 while each query walks over them.
+constexpr int kRowBlock = 256;
+
+constexpr char kZeroNormCosine[] =
+    "EuclideanVector with euclidean normal of 0 does not have a cosine similarity";
+
+// Whether a ranks ahead of b under metric.
+bool Better(PairwiseMetric metric, const Neighbor& a, const Neighbor& b) noexcept {
+  if (a.score != b.score) {
+    return metric == PairwiseMetric::kSquaredL2 ? a.score < b.score : a.score > b.score;
+  }
+  return a.index < b.index;
+}
+
+// Keeps the k best candidates seen so far as a heap with the worst on top.
+void Offer(PairwiseMetric metric, std::vector<Neighbor>& heap, int k, Neighbor candidate) {
+  auto better = [metric](const Neighbor& a, const Neighbor& b) { return Better(metric, a, b); };
+  if (static_cast<int>(heap.size()) < k) {
+    heap.push_back(candidate);
+    std::push_heap(heap.begin(), heap.end(), better);
+  } else if (better(candidate, heap.front())) {
+    std::pop_heap(heap.begin(), heap.end(), better);
+    heap.back() = candidate;
+    std::push_heap(heap.begin(), heap.end(), better);
+  }
+}
+
+}  // namespace
+
+void AsyncQueryEngine::Awaitable::await_suspend(std::coroutine_handle<> handle) {
+  query_->complete = [handle]() { handle.resume(); };
+  engine_->Enqueue(query_);
+}
+
+AsyncQueryEngine::AsyncQueryEngine(EuclideanVectorBatch dataset, const AsyncQueryOptions& options)
+  : dataset_{std::move(dataset)}, options_{options} {
+  options_.max_batch_size = std::max<std::size_t>(1, options_.max_batch_size);
+  squared_norms_.resize(dataset_.GetNumVectors());
+  for (auto i = 0; i < dataset_.GetNumVectors(); ++i) {
+    squared_norms_[i] =
+        ev::kernels::Dot(dataset_.Row(i), dataset_.Row(i), dataset_.GetNumDimensions());
+    if (options_.metric == PairwiseMetric::kCosine && squared_norms_[i] == 0) {
+      throw EuclideanVectorError(kZeroNormCosine);
+    }
+  }
+  dispatcher_ = std::thread([this]() { DispatchLoop(); });
+}
+
+AsyncQueryEngine::~AsyncQueryEngine() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stopping_ = true;
+  }
+  wake_.notify_all();
+  dispatcher_.join();
+}
+
+AsyncQueryEngine::Awaitable AsyncQueryEngine::Query(const EuclideanVector& query, int k) {
+  return Awaitable(this, MakeQuery(query, k));
+}
+
+std::future<std::vector<Neighbor>> AsyncQueryEngine::SubmitQuery(const EuclideanVector& query,
+                                                                 int k) {
+  auto pending = MakeQuery(query, k);
+  auto promise = std::make_shared<std::promise<std::vector<Neighbor>>>();
+  auto future = promise->get_future();
+  // The callback lives inside the query, so it must not own the query as well.
+  pending->complete = [raw = pending.get(), promise]() {
+    if (raw->error) {
+      promise->set_exception(raw->error);
+    } else {
+      promise->set_value(std::move(raw->result));
+    }
+  };
+  Enqueue(std::move(pending));
+  return future;
+}
+
+std::shared_ptr<ev::detail::PendingQuery> AsyncQueryEngine::MakeQuery(const EuclideanVector& query,
+                                                                      int k) const {
+  if (query.GetNumDimensions() != dataset_.GetNumDimensions()) {
+    throw EuclideanVectorError("Dimensions of LHS(" + std::to_string(dataset_.GetNumDimensions()) +
+                               ") and RHS(" + std::to_string(query.GetNumDimensions()) +
+                               ") do not match");
+  }
+  auto pending = std::make_shared<ev::detail::PendingQuery>();
+  pending->values.assign(query.data(), query.data() + query.GetNumDimensions());
+  pending->squared_norm =
+      ev::kernels::Dot(pending->values.data(), pending->values.data(), query.GetNumDimensions());
+  if (options_.metric == PairwiseMetric::kCosine && pending->squared_norm == 0) {
+    throw EuclideanVectorError(kZeroNormCosine);
+  }
+  pending->k = std::clamp(k, 0, dataset_.GetNumVectors());
+  return pending;
+}
+
+void AsyncQueryEngine::Enqueue(std::shared_ptr<ev::detail::PendingQuery> query) {
+  query->enqueued = std::chrono::steady_clock::now();
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    queue_.push_back(std::move(query));
+  }
+  wake_.notify_one();
+}
+
+void AsyncQueryEngine::DispatchLoop() {
+  std::vector<std::shared_ptr<ev::detail::PendingQuery>> batch;
+  std::unique_lock<std::mutex> lock(mutex_);
+  for (;;) {
+    wake_.wait(lock, [this]() { return stopping_ || !queue_.empty(); });
+    if (queue_.empty()) {
+      return;
+    }
+    // Give the oldest query's batch until its deadline to fill up.
+    const auto deadline = queue_.front()->enqueued + options_.max_wait;
+    wake_.wait_until(lock, deadline, [this]() {
+      return stopping_ || queue_.size() >= options_.max_batch_size;
+    });
+    const auto size = std::min(queue_.size(), options_.max_batch_size);
+    batch.assign(std::make_move_iterator(queue_.begin()),
+                 std::make_move_iterator(queue_.begin() + size));
+    queue_.erase(queue_.begin(), queue_.begin() + size);
+
+    lock.unlock();
+    // An exception escaping this thread would terminate the process and lose every waiter.
+    try {
+      RunBatch(batch);
+    } catch (...) {
+      const auto error = std::current_exception();
+      for (auto& query : batch) {
+        query->error = error;
+      }
+    }
+    ++batches_run_;
+    const auto executor = GetDefaultExecutor();
+    for (auto& query : batch) {
+      executor->Submit([query = std::move(query)]() { query->complete(); });
+    }
+    batch.clear();
+    lock.lock();
+  }
+}
+
+void AsyncQueryEngine::RunBatch(
+    const std::vector<std::shared_ptr<ev::detail::PendingQuery>>& batch) const {
+  const auto n = dataset_.GetNumVectors();
+  const auto d = dataset_.GetNumDimensions();
+  const auto nq = static_cast<int>(batch.size());
+  const auto metric = options_.metric;
+
+  // The dataset is split into one contiguous range per thread; each keeps its own top-k heap per
+  // query and the heaps are merged at the end.
+  const auto num_blocks = (n + kRowBlock - 1) / kRowBlock;
+  const auto parts = std::max(1, std::min(ev::detail::ResolveThreadCount(options_.num_threads),
+                                          num_blocks));
+  const auto blocks_per_part = (num_blocks + parts - 1) / parts;
+  std::vector<std::vector<Neighbor>> heaps(static_cast<std::size_t>(parts) * nq);
+
+  ev::detail::ParallelFor(0, parts, 1, options_.num_threads, [&](std::int64_t lo, std::int64_t hi) {
+    double sums[4];
+    for (auto part = lo; part < hi; ++part) {
+      auto* part_heaps = heaps.data() + part * nq;
+      const auto row_end = std::min<std::int64_t>(n, (part + 1) * blocks_per_part * kRowBlock);
+      for (auto r0 = part * blocks_per_part * kRowBlock; r0 < row_end; r0 += kRowBlock) {
+        const auto r1 = static_cast<int>(std::min<std::int64_t>(row_end, r0 + kRowBlock));
+        for (auto q = 0; q < nq; ++q) {
+          const auto& query = *batch[q];
+          if (query.k == 0) {
+            continue;
+          }
+          const auto* x = query.values.data();
+          auto score = [&](int row, double dot) {
+            if (metric == PairwiseMetric::kCosine) {
+              dot /= std::sqrt(query.squared_norm) * std::sqrt(squared_norms_[row]);
+            }
+            Offer(metric, part_heaps[q], query.k, Neighbor{row, dot});
+          };
+          auto row = static_cast<int>(r0);
+          if (metric == PairwiseMetric::kSquaredL2) {
+            for (; row < r1; ++row) {
+              Offer(metric, part_heaps[q], query.k,
+                    Neighbor{row, ev::kernels::SquaredL2(x, dataset_.Row(row), d)});
+            }
+            continue;
+          }
+          for (; row + 4 <= r1; row += 4) {
+            const double* y[4] = {dataset_.Row(row), dataset_.Row(row + 1), dataset_.Row(row + 2),
+                                  dataset_.Row(row + 3)};
+            ev::kernels::Dot4(x, y, d, sums);
+            for (auto j = 0; j < 4; ++j) {
+              score(row + j, sums[j]);
+            }
+          }
+          for (; row < r1; ++row) {
+            score(row, ev::kernels::Dot(x, dataset_.Row(row), d));
+          }
+        }
+      }
+    }
+  });
+
+  for (auto q = 0; q < nq; ++q) {
+    auto& result = batch[q]->result;
+    result.clear();
+    for (auto part = 0; part < parts; ++part) {
+      const auto& heap = heaps[static_cast<std::size_t>(part) * nq + q];
+      result.insert(result.end(), heap.begin(), heap.end());
+    }
+    std::sort(result.begin(), result.end(), [metric](const Neighbor& a, const Neighbor& b) {
+      return Better(metric, a, b);
+    });
+    result.resize(std::min<std::size_t>(result.size(), batch[q]->k));
+  }
+}
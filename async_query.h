@@ -0,0 +1,159 @@
+#ifndef ASSIGNMENTS_EV_ASYNC_QUERY_H_
+#define ASSIGNMENTS_EV_ASYNC_QUERY_H_
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <coroutine>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "assignments/ev/euclidean_vector.h"
+#include "assignments/ev/euclidean_vector_batch.h"
+#include "assignments/ev/neighbor.h"
+#include "assignments/ev/pairwise.h"
+
+struct AsyncQueryOptions {
+  /*
+   * Largest number of queries answered by one pass over the dataset.
+   */
+  std::size_t max_batch_size = 64;
+
+  /*
+   * Longest a query waits for others to share its pass. A batch is started as soon as it is full
+   * or its oldest query has waited this long, whichever comes first.
+   */
+  std::chrono::microseconds max_wait{200};
+
+  /*
+   * How queries are scored against the dataset. kDot and kCosine rank higher scores first,
+   * kSquaredL2 ranks lower scores first.
+   */
+  PairwiseMetric metric = PairwiseMetric::kDot;
+
+  /*
+   * Maximum number of threads used to scan the dataset for one batch. 0 means one per hardware
+   * thread.
+   */
+  int num_threads = 0;
+};
+
+namespace ev::detail {
+
+struct PendingQuery {
+  std::vector<double> values;
+  double squared_norm;
+  int k;
+  std::chrono::steady_clock::time_point enqueued;
+  std::vector<Neighbor> result;
+  // Set instead of result when the batch could not be answered.
+  std::exception_ptr error;
+  // Hands result (or error) to whoever is waiting; run on the default executor once the batch
+  // is done.
+  std::function<void()> complete;
+};
+
+}  // namespace ev::detail
+
+/*
+ * Answers top-k similarity queries against a fixed collection of vectors. Queries arriving close
+ * together are coalesced into micro-batches and each batch is answered with a single pass over the
+ * dataset, scoring every row against all of the batch's queries while it is in cache, instead of
+ * one memory-bound scan per query.
+ *
+ * Queries can be awaited from a C++20 coroutine:
+ *
+ *   std::vector<Neighbor> top = co_await engine.Query(v, 10);
+ *
+ * or, from ordinary code, collected through a std::future with SubmitQuery. Awaiting coroutines
+ * are resumed on the default executor (see thread_pool.h) once their batch is done. Results are
+ * ordered best first, ties broken by the lower row index.
+ *
+ * If a batch cannot be answered, e.g. because memory runs out, each of its queries gets the
+ * exception instead: co_await rethrows it and the future holds it.
+ *
+ * Queries still pending when the engine is destroyed are answered before the destructor returns.
+ */
+class AsyncQueryEngine {
+ public:
+  class Awaitable {
+   public:
+    bool await_ready() const noexcept { return false; }
+    void await_suspend(std::coroutine_handle<> handle);
+    std::vector<Neighbor> await_resume() {
+      if (query_->error) {
+        std::rethrow_exception(query_->error);
+      }
+      return std::move(query_->result);
+    }
+
+   private:
+    friend class AsyncQueryEngine;
+    Awaitable(AsyncQueryEngine* engine, std::shared_ptr<ev::detail::PendingQuery> query) noexcept
+      : engine_{engine}, query_{std::move(query)} {}
+
+    AsyncQueryEngine* engine_;
+    std::shared_ptr<ev::detail::PendingQuery> query_;
+  };
+
+  /*
+   * Takes ownership of the dataset to search.
+   * When: options.metric is kCosine and some vector in dataset has a norm of 0
+   * Throw: "EuclideanVector with euclidean normal of 0 does not have a cosine similarity"
+   */
+  explicit AsyncQueryEngine(EuclideanVectorBatch dataset, const AsyncQueryOptions& options = {});
+  AsyncQueryEngine(const AsyncQueryEngine&) = delete;
+  AsyncQueryEngine& operator=(const AsyncQueryEngine&) = delete;
+  ~AsyncQueryEngine();
+
+  /*
+   * Returns an awaitable yielding the (at most) k best rows of the dataset for query. The query is
+   * queued when the awaitable is awaited.
+   * When: query does not have the dataset's number of dimensions
+   * Throw: "Dimensions of LHS(X) and RHS(Y) do not match"
+   * When: the metric is kCosine and query has a norm of 0
+   * Throw: "EuclideanVector with euclidean normal of 0 does not have a cosine similarity"
+   */
+  Awaitable Query(const EuclideanVector& query, int k);
+
+  /*
+   * Queues query right away and returns a future for its (at most) k best rows.
+   * Throws in the same cases as Query.
+   */
+  std::future<std::vector<Neighbor>> SubmitQuery(const EuclideanVector& query, int k);
+
+  const EuclideanVectorBatch& GetDataset() const noexcept { return dataset_; }
+
+  /*
+   * Number of passes over the dataset so far. Compared with the number of queries this shows how
+   * well queries are being coalesced.
+   */
+  std::size_t GetNumBatchesRun() const noexcept { return batches_run_.load(); }
+
+ private:
+  std::shared_ptr<ev::detail::PendingQuery> MakeQuery(const EuclideanVector& query, int k) const;
+  void Enqueue(std::shared_ptr<ev::detail::PendingQuery> query);
+  void DispatchLoop();
+  void RunBatch(const std::vector<std::shared_ptr<ev::detail::PendingQuery>>& batch) const;
+
+  EuclideanVectorBatch dataset_;
+  std::vector<double> squared_norms_;
+  AsyncQueryOptions options_;
+
+  std::mutex mutex_;
+  std::condition_variable wake_;
+  std::deque<std::shared_ptr<ev::detail::PendingQuery>> queue_;
+  bool stopping_ = false;
+  std::atomic<std::size_t> batches_run_{0};
+  std::thread dispatcher_;
+};
+
+#endif  // ASSIGNMENTS_EV_ASYNC_QUERY_H_
@@ -0,0 +1,201 @@
+/*
+
+  == Explanation and rational of testing ==
+
+  Results are compared with a brute-force search written with the EuclideanVector operators, for
+  every metric, through both the coroutine and the future interface. The dataset spans several
+  scan blocks split over several threads and is not a multiple of four rows, so every path of the
+  scan and of the merge is used. Coalescing is checked by counting passes over the dataset: with a
+  long wait and a batch size equal to the number of queries, all of them must be answered by one
+  pass. We also test the error cases and that pending queries are answered when the engine is
+  destroyed.
+
+*/
+
+#include "assignments/ev/async_query.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <coroutine>
+#include <exception>
+#include <future>
+#include <memory>
+#include <vector>
+
+#include "assignments/ev/euclidean_vector.h"
+#include "assignments/ev/euclidean_vector_batch.h"
+#include "assignments/ev/neighbor.h"
+#include "assignments/ev/pairwise.h"
+#include "catch.h"
+
+namespace {
+
+// Coroutine type that starts eagerly and is never awaited itself.
+struct DetachedTask {
+  struct promise_type {
+    DetachedTask get_return_object() noexcept { return {}; }
+    std::suspend_never initial_suspend() noexcept { return {}; }
+    std::suspend_never final_suspend() noexcept { return {}; }
+    void return_void() noexcept {}
+    void unhandled_exception() noexcept { std::terminate(); }
+  };
+};
+
+DetachedTask AwaitQuery(AsyncQueryEngine& engine,
+                        EuclideanVector query,
+                        int k,
+                        std::promise<std::vector<Neighbor>>& out) {
+  out.set_value(co_await engine.Query(query, k));
+}
+
+EuclideanVector MakeVector(int dimensions, double phase) {
+  EuclideanVector v(dimensions);
+  for (auto i = 0; i < dimensions; ++i) {
+    v[i] = std::sin(phase * 1.7 + i * 0.3) + 0.1 * i;
+  }
+  return v;
+}
+
+std::vector<EuclideanVector> MakeVectors(int n, int dimensions) {
+  std::vector<EuclideanVector> vectors;
+  for (auto i = 0; i < n; ++i) {
+    vectors.push_back(MakeVector(dimensions, i));
+  }
+  return vectors;
+}
+
+std::vector<Neighbor> BruteForce(const std::vector<EuclideanVector>& dataset,
+                                 const EuclideanVector& query,
+                                 int k,
+                                 PairwiseMetric metric) {
+  std::vector<Neighbor> all;
+  for (auto i = 0; i < static_cast<int>(dataset.size()); ++i) {
+    auto score = dataset[i] * query;
+    if (metric == PairwiseMetric::kSquaredL2) {
+      const auto norm = (dataset[i] - query).GetEuclideanNorm();
+      score = norm * norm;
+    } else if (metric == PairwiseMetric::kCosine) {
+      score /= dataset[i].GetEuclideanNorm() * query.GetEuclideanNorm();
+    }
+    all.push_back({i, score});
+  }
+  std::sort(all.begin(), all.end(), [metric](const Neighbor& a, const Neighbor& b) {
+    if (a.score != b.score) {
+      return metric == PairwiseMetric::kSquaredL2 ? a.score < b.score : a.score > b.score;
+    }
+    return a.index < b.index;
+  });
+  all.resize(std::min<std::size_t>(all.size(), k));
+  return all;
+}
+
+void RequireSameNeighbors(const std::vector<Neighbor>& actual,
+                          const std::vector<Neighbor>& expected) {
+  REQUIRE(actual.size() == expected.size());
+  for (auto i = std::size_t{0}; i < actual.size(); ++i) {
+    REQUIRE(actual[i].index == expected[i].index);
+    REQUIRE(actual[i].score == Approx(expected[i].score));
+  }
+}
+
+}  // namespace
+
+TEST_CASE("Asynchronous queries match a brute-force search") {
+  const auto dataset = MakeVectors(601, 19);
+  const auto queries = MakeVectors(10, 19);
+
+  const auto metrics = {PairwiseMetric::kDot, PairwiseMetric::kSquaredL2, PairwiseMetric::kCosine};
+  auto make_engine = [&dataset](PairwiseMetric metric) {
+    AsyncQueryOptions options;
+    options.metric = metric;
+    options.max_batch_size = 4;
+    options.num_threads = 3;
+    return std::make_unique<AsyncQueryEngine>(EuclideanVectorBatch(dataset), options);
+  };
+
+  SECTION("TEST CASE 1 - Queries awaited from coroutines") {
+    for (auto metric : metrics) {
+      auto engine = make_engine(metric);
+      std::vector<std::promise<std::vector<Neighbor>>> promises(queries.size());
+      for (auto i = std::size_t{0}; i < queries.size(); ++i) {
+        AwaitQuery(*engine, queries[i], 7, promises[i]);
+      }
+      for (auto i = std::size_t{0}; i < queries.size(); ++i) {
+        RequireSameNeighbors(promises[i].get_future().get(),
+                             BruteForce(dataset, queries[i], 7, metric));
+      }
+    }
+  }
+
+  SECTION("TEST CASE 2 - Queries collected through futures") {
+    for (auto metric : metrics) {
+      auto engine = make_engine(metric);
+      std::vector<std::future<std::vector<Neighbor>>> futures;
+      for (const auto& query : queries) {
+        futures.push_back(engine->SubmitQuery(query, 5));
+      }
+      for (auto i = std::size_t{0}; i < queries.size(); ++i) {
+        RequireSameNeighbors(futures[i].get(), BruteForce(dataset, queries[i], 5, metric));
+      }
+    }
+  }
+
+  SECTION("TEST CASE 3 - k larger than the dataset or not positive") {
+    AsyncQueryEngine engine(EuclideanVectorBatch(MakeVectors(3, 2)));
+    REQUIRE(engine.SubmitQuery(MakeVector(2, 0.5), 10).get().size() == 3);
+    REQUIRE(engine.SubmitQuery(MakeVector(2, 0.5), 0).get().empty());
+    REQUIRE(engine.SubmitQuery(MakeVector(2, 0.5), -1).get().empty());
+  }
+}
+
+TEST_CASE("Concurrent queries are coalesced into one pass") {
+  SECTION("TEST CASE 4 - A full batch is answered by a single scan") {
+    AsyncQueryOptions options;
+    options.max_batch_size = 8;
+    options.max_wait = std::chrono::seconds(10);
+    AsyncQueryEngine engine(EuclideanVectorBatch(MakeVectors(100, 4)), options);
+    std::vector<std::future<std::vector<Neighbor>>> futures;
+    for (auto i = 0; i < 8; ++i) {
+      futures.push_back(engine.SubmitQuery(MakeVector(4, i), 3));
+    }
+    for (auto& f : futures) {
+      REQUIRE(f.get().size() == 3);
+    }
+    REQUIRE(engine.GetNumBatchesRun() == 1);
+  }
+
+  SECTION("TEST CASE 5 - Pending queries are answered on destruction") {
+    std::future<std::vector<Neighbor>> future;
+    {
+      AsyncQueryOptions options;
+      options.max_wait = std::chrono::seconds(10);
+      AsyncQueryEngine engine(EuclideanVectorBatch(MakeVectors(10, 3)), options);
+      future = engine.SubmitQuery(MakeVector(3, 1), 2);
+    }
+    REQUIRE(future.get().size() == 2);
+  }
+}
+
+TEST_CASE("Asynchronous query errors") {
+  SECTION("TEST CASE 6 - Query with the wrong number of dimensions") {
+    AsyncQueryEngine engine(EuclideanVectorBatch(MakeVectors(5, 3)));
+    REQUIRE_THROWS_WITH(engine.Query(MakeVector(4, 0), 1),
+                        Catch::Contains("Dimensions of LHS(3) and RHS(4) do not match"));
+    REQUIRE_THROWS_WITH(engine.SubmitQuery(MakeVector(2, 0), 1),
+                        Catch::Contains("Dimensions of LHS(3) and RHS(2) do not match"));
+  }
+
+  SECTION("TEST CASE 7 - Zero vectors under the cosine metric") {
+    AsyncQueryOptions options;
+    options.metric = PairwiseMetric::kCosine;
+    auto vectors = MakeVectors(5, 3);
+    AsyncQueryEngine engine(EuclideanVectorBatch(vectors), options);
+    REQUIRE_THROWS_WITH(engine.SubmitQuery(EuclideanVector(3), 1),
+                        Catch::Contains("does not have a cosine similarity"));
+
+    vectors.push_back(EuclideanVector(3));
+    REQUIRE_THROWS_WITH(AsyncQueryEngine(EuclideanVectorBatch(vectors), options),
+                        Catch::Contains("does not have a cosine similarity"));
+  }
+}
@@ -0,0 +1,369 @@
+#include "assignments/ev/dataset_io.h"
+
+#include <algorithm>
+#include <charconv>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <limits>
+#include <string>
+#include <system_error>
+#include <vector>
+
+#include "assignments/ev/euclidean_vector.h"
+#include "assignments/ev/euclidean_vector_batch.h"
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define EV_HAVE_MMAP 1
+#endif
+
+namespace {
+
+// Every supported format stores its values little-endian. On a big-endian host Load swaps the
+// bytes of each value, and MappedVectorFile reads into memory instead of mapping.
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+constexpr bool kBigEndianHost = true;
+#else
+constexpr bool kBigEndianHost = false;
+#endif
+
+// 64-bit file positioning, so files over 2GB can be read on every platform.
+int SeekTo(std::FILE* file, std::int64_t offset, int whence) {
+#if defined(_WIN32)
+  return _fseeki64(file, offset, whence);
+#else
+  return fseeko(file, static_cast<off_t>(offset), whence);
+#endif
+}
+
+std::int64_t Tell(std::FILE* file) {
+#if defined(_WIN32)
+  return _ftelli64(file);
+#else
+  return static_cast<std::int64_t>(ftello(file));
+#endif
+}
+
+template <typename T>
+T Load(const unsigned char* src) noexcept {
+  unsigned char bytes[sizeof(T)];
+  std::memcpy(bytes, src, sizeof(T));
+  if (kBigEndianHost) {
+    std::reverse(bytes, bytes + sizeof(T));
+  }
+  T value;
+  std::memcpy(&value, bytes, sizeof(T));
+  return value;
+}
+
+template <typename T>
+void ConvertRow(const unsigned char* src, double* dst, int n) noexcept {
+  for (auto i = 0; i < n; ++i) {
+    dst[i] = static_cast<double>(Load<T>(src + static_cast<std::size_t>(i) * sizeof(T)));
+  }
+}
+
+// Converts n values of the given kind ('f', 'i' or 'u') and width into doubles.
+void Convert(char kind, int bytes, const unsigned char* src, double* dst, int n) noexcept {
+  if (kind == 'f' && bytes == 8 && !kBigEndianHost) {
+    std::memcpy(dst, src, static_cast<std::size_t>(n) * sizeof(double));
+  } else if (kind == 'f' && bytes == 8) {
+    ConvertRow<double>(src, dst, n);
+  } else if (kind == 'f') {
+    ConvertRow<float>(src, dst, n);
+  } else if (kind == 'u') {
+    ConvertRow<std::uint8_t>(src, dst, n);
+  } else if (bytes == 1) {
+    ConvertRow<std::int8_t>(src, dst, n);
+  } else if (bytes == 4) {
+    ConvertRow<std::int32_t>(src, dst, n);
+  } else {
+    ConvertRow<std::int64_t>(src, dst, n);
+  }
+}
+
+// Returns the text following "'key':" in a .npy header dictionary, or an empty string.
+std::string NpyField(const std::string& header, const std::string& key) {
+  const auto at = header.find("'" + key + "'");
+  if (at == std::string::npos) {
+    return "";
+  }
+  const auto colon = header.find(':', at);
+  if (colon == std::string::npos) {
+    return "";
+  }
+  const auto start = header.find_first_not_of(' ', colon + 1);
+  return start == std::string::npos ? "" : header.substr(start);
+}
+
+bool EndsWith(const std::string& s, const std::string& suffix) {
+  return s.size() >= suffix.size() &&
+         s.compare(s.size() - suffix.size(), suffix.size(), suffix) == 0;
+}
+
+}  // namespace
+
+VectorFileFormat DetectVectorFileFormat(const std::string& path) {
+  if (EndsWith(path, ".fvecs")) {
+    return VectorFileFormat::kFvecs;
+  }
+  if (EndsWith(path, ".ivecs")) {
+    return VectorFileFormat::kIvecs;
+  }
+  if (EndsWith(path, ".bvecs")) {
+    return VectorFileFormat::kBvecs;
+  }
+  if (EndsWith(path, ".npy")) {
+    return VectorFileFormat::kNpy;
+  }
+  throw EuclideanVectorError("Cannot parse vector file " + path + ": unknown extension");
+}
+
+// Constructors
+VectorFileReader::VectorFileReader(const std::string& path)
+  : VectorFileReader(path, DetectVectorFileFormat(path)) {}
+
+VectorFileReader::VectorFileReader(const std::string& path, VectorFileFormat format)
+  : path_{path}, format_{format}, file_{std::fopen(path.c_str(), "rb")} {
+  if (file_ == nullptr) {
+    throw EuclideanVectorError("Cannot open vector file " + path_);
+  }
+  try {
+    ReadHeader();
+  } catch (...) {
+    std::fclose(file_);
+    throw;
+  }
+}
+
+// Destructor
+VectorFileReader::~VectorFileReader() noexcept {
+  std::fclose(file_);
+}
+
+void VectorFileReader::Fail(const std::string& reason) const {
+  throw EuclideanVectorError("Cannot parse vector file " + path_ + ": " + reason);
+}
+
+void VectorFileReader::ReadHeader() {
+  if (SeekTo(file_, 0, SEEK_END) != 0) {
+    Fail("cannot determine file size");
+  }
+  const auto file_bytes = Tell(file_);
+  SeekTo(file_, 0, SEEK_SET);
+
+  if (format_ == VectorFileFormat::kNpy) {
+    ReadNpyHeader();
+    // Divides rather than multiplies, as the shape may be large enough to overflow.
+    if (file_bytes < data_offset_ ||
+        (record_bytes_ != 0 && num_vectors_ > (file_bytes - data_offset_) / record_bytes_)) {
+      Fail("file is truncated");
+    }
+    return;
+  }
+
+  element_bytes_ = format_ == VectorFileFormat::kBvecs ? 1 : 4;
+  element_kind_ = format_ == VectorFileFormat::kFvecs   ? 'f'
+                  : format_ == VectorFileFormat::kIvecs ? 'i'
+                                                        : 'u';
+  header_bytes_ = sizeof(std::int32_t);
+  if (file_bytes == 0) {
+    return;
+  }
+  unsigned char prefix[sizeof(std::int32_t)];
+  if (std::fread(prefix, 1, sizeof(prefix), file_) != sizeof(prefix)) {
+    Fail("file is truncated");
+  }
+  const auto dimension = Load<std::int32_t>(prefix);
+  if (dimension <= 0) {
+    Fail("invalid number of dimensions " + std::to_string(dimension));
+  }
+  num_dimensions_ = dimension;
+  record_bytes_ = header_bytes_ + static_cast<std::int64_t>(dimension) * element_bytes_;
+  if (file_bytes % record_bytes_ != 0) {
+    Fail("file size is not a whole number of vectors");
+  }
+  num_vectors_ = file_bytes / record_bytes_;
+}
+
+void VectorFileReader::ReadNpyHeader() {
+  // Magic string, then a version, then the length of a Python dict literal describing the array.
+  unsigned char preamble[12];
+  if (std::fread(preamble, 1, 10, file_) != 10 || std::memcmp(preamble, "\x93NUMPY", 6) != 0) {
+    Fail("not a .npy file");
+  }
+  std::int64_t header_length = 0;
+  if (preamble[6] == 1) {
+    header_length = Load<std::uint16_t>(preamble + 8);
+    data_offset_ = 10 + header_length;
+  } else {
+    if (std::fread(preamble + 10, 1, 2, file_) != 2) {
+      Fail("file is truncated");
+    }
+    header_length = Load<std::uint32_t>(preamble + 8);
+    data_offset_ = 12 + header_length;
+  }
+  std::string header(static_cast<std::size_t>(header_length), '\0');
+  if (std::fread(header.data(), 1, header.size(), file_) != header.size()) {
+    Fail("file is truncated");
+  }
+
+  const auto descr = NpyField(header, "descr");
+  if (descr.size() < 4 || (descr[0] != '\'' && descr[0] != '"')) {
+    Fail("missing dtype");
+  }
+  const auto dtype = descr.substr(1, descr.find(descr[0], 1) - 1);
+  if (dtype.size() < 3) {
+    Fail("unsupported dtype " + dtype);
+  }
+  // '=' is the byte order of the machine that wrote the file; assume it was this one.
+  if (dtype[0] == '>' || (dtype[0] == '=' && kBigEndianHost)) {
+    Fail("big-endian data is not supported");
+  }
+  element_kind_ = dtype[1];
+  element_bytes_ = std::atoi(dtype.c_str() + 2);
+  const auto supported = (element_kind_ == 'f' && (element_bytes_ == 4 || element_bytes_ == 8)) ||
+                         (element_kind_ == 'i' && (element_bytes_ == 1 || element_bytes_ == 4 ||
+                                                   element_bytes_ == 8)) ||
+                         (element_kind_ == 'u' && element_bytes_ == 1);
+  if (!supported) {
+    Fail("unsupported dtype " + dtype);
+  }
+
+  if (NpyField(header, "fortran_order").rfind("False", 0) != 0) {
+    Fail("Fortran-order arrays are not supported");
+  }
+
+  const auto shape = NpyField(header, "shape");
+  std::vector<std::int64_t> extents;
+  for (auto i = std::size_t{1}; i < shape.size() && shape[i] != ')'; ++i) {
+    if (shape[i] >= '0' && shape[i] <= '9') {
+      std::int64_t extent = 0;
+      const auto [end, error] =
+          std::from_chars(shape.data() + i, shape.data() + shape.size(), extent);
+      if (error != std::errc()) {
+        Fail("shape is too large");
+      }
+      extents.push_back(extent);
+      i = static_cast<std::size_t>(end - shape.data()) - 1;
+    }
+  }
+  if (shape.empty() || shape[0] != '(' || extents.empty() || extents.size() > 2) {
+    Fail("expected a 1 or 2 dimensional array");
+  }
+  num_vectors_ = extents.size() == 2 ? extents[0] : 1;
+  const auto dimension = extents.back();
+  if (dimension > std::numeric_limits<int>::max()) {
+    Fail("too many dimensions");
+  }
+  num_dimensions_ = static_cast<int>(dimension);
+  record_bytes_ = dimension * element_bytes_;
+}
+
+EuclideanVectorBatch VectorFileReader::ReadChunk(int max_vectors) {
+  const auto count =
+      static_cast<int>(std::min(GetNumRemaining(), std::max<std::int64_t>(max_vectors, 0)));
+  if (count <= 0) {
+    return EuclideanVectorBatch();
+  }
+  EuclideanVectorBatch batch(count, num_dimensions_);
+  scratch_.resize(static_cast<std::size_t>(count) * record_bytes_);
+  if (SeekTo(file_, data_offset_ + next_vector_ * record_bytes_, SEEK_SET) != 0 ||
+      std::fread(scratch_.data(), 1, scratch_.size(), file_) != scratch_.size()) {
+    Fail("file is truncated");
+  }
+  for (auto i = 0; i < count; ++i) {
+    const auto* record = scratch_.data() + static_cast<std::size_t>(i) * record_bytes_;
+    if (header_bytes_ != 0 && Load<std::int32_t>(record) != num_dimensions_) {
+      Fail("vector " + std::to_string(next_vector_ + i) + " has " +
+           std::to_string(Load<std::int32_t>(record)) + " dimensions, expected " +
+           std::to_string(num_dimensions_));
+    }
+    Convert(element_kind_, element_bytes_, record + header_bytes_, batch.Row(i), num_dimensions_);
+  }
+  next_vector_ += count;
+  return batch;
+}
+
+void VectorFileReader::Seek(std::int64_t index) {
+  next_vector_ = std::clamp<std::int64_t>(index, 0, num_vectors_);
+}
+
+EuclideanVectorBatch LoadVectorFile(const std::string& path, std::int64_t max_vectors) {
+  VectorFileReader reader(path);
+  const auto count = max_vectors < 0 ? reader.GetNumVectors()
+                                     : std::min(max_vectors, reader.GetNumVectors());
+  if (count > std::numeric_limits<int>::max()) {
+    throw EuclideanVectorError("Cannot parse vector file " + path +
+                               ": too many vectors for one EuclideanVectorBatch");
+  }
+  return reader.ReadChunk(static_cast<int>(count));
+}
+
+// Constructors
+MappedVectorFile::MappedVectorFile(const std::string& path) {
+  VectorFileReader reader(path, VectorFileFormat::kNpy);
+  if (reader.element_kind_ != 'f' || reader.element_bytes_ != 8) {
+    reader.Fail("only float64 files can be mapped");
+  }
+  num_dimensions_ = reader.num_dimensions_;
+  num_vectors_ = reader.num_vectors_;
+  const auto offset = static_cast<std::size_t>(reader.data_offset_);
+  const auto bytes = static_cast<std::size_t>(num_vectors_ * reader.record_bytes_);
+
+#ifdef EV_HAVE_MMAP
+  // The format pads its header so the data is aligned, but double-check before handing out
+  // double pointers into the mapping.
+  if (!kBigEndianHost && offset % alignof(double) == 0 && bytes > 0) {
+    const auto fd = ::open(path.c_str(), O_RDONLY);
+    if (fd >= 0) {
+      auto* mapping = ::mmap(nullptr, offset + bytes, PROT_READ, MAP_PRIVATE, fd, 0);
+      ::close(fd);
+      if (mapping != MAP_FAILED) {
+        ::madvise(mapping, offset + bytes, MADV_SEQUENTIAL);
+        mapping_ = mapping;
+        mapping_bytes_ = offset + bytes;
+        data_ = reinterpret_cast<const double*>(static_cast<const char*>(mapping) + offset);
+        return;
+      }
+    }
+  }
+#endif
+
+  fallback_.resize(bytes / sizeof(double));
+  if (SeekTo(reader.file_, reader.data_offset_, SEEK_SET) != 0 ||
+      std::fread(fallback_.data(), 1, bytes, reader.file_) != bytes) {
+    reader.Fail("file is truncated");
+  }
+  if (kBigEndianHost) {
+    for (auto& value : fallback_) {
+      value = Load<double>(reinterpret_cast<const unsigned char*>(&value));
+    }
+  }
+  data_ = fallback_.data();
+}
+
+// Destructor
+MappedVectorFile::~MappedVectorFile() noexcept {
+#ifdef EV_HAVE_MMAP
+  if (mapping_ != nullptr) {
+    ::munmap(mapping_, mapping_bytes_);
+  }
+#endif
+}
+
+EuclideanVectorBatch MappedVectorFile::ToBatch(std::int64_t begin, int count) const {
+  begin = std::clamp<std::int64_t>(begin, 0, num_vectors_);
+  count = static_cast<int>(std::clamp<std::int64_t>(num_vectors_ - begin, 0, count));
+  EuclideanVectorBatch batch(count, num_dimensions_);
+  for (auto i = 0; i < count; ++i) {
+    std::copy(Row(begin + i), Row(begin + i) + num_dimensions_, batch.Row(i));
+  }
+  return batch;
+}
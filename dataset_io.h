@@ -0,0 +1,143 @@
+#ifndef ASSIGNMENTS_EV_DATASET_IO_H_
+#define ASSIGNMENTS_EV_DATASET_IO_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include "assignments/ev/euclidean_vector_batch.h"
+
+enum class VectorFileFormat {
+  // Each vector is an int32 dimension followed by that many float32 values.
+  kFvecs,
+  // Each vector is an int32 dimension followed by that many int32 values.
+  kIvecs,
+  // Each vector is an int32 dimension followed by that many uint8 values.
+  kBvecs,
+  // A NumPy .npy array of shape (n, d) or (d,), in C order, of float32, float64, int8, uint8,
+  // int32 or int64.
+  kNpy,
+};
+
+/*
+ * Picks the format from the file extension (.fvecs, .ivecs, .bvecs or .npy).
+ * When: the extension is none of those
+ * Throw: "Cannot parse vector file PATH: unknown extension"
+ */
+VectorFileFormat DetectVectorFileFormat(const std::string& path);
+
+/*
+ * Reads a file of vectors sequentially, a chunk at a time, converting each value to double as it
+ * is copied into an EuclideanVectorBatch. Only one chunk is held in memory, so files larger than
+ * RAM can be processed. All files are read as little-endian, whatever the byte order of the host.
+ *
+ * Every constructor and read throws EuclideanVectorError with one of:
+ *   "Cannot open vector file PATH"
+ *   "Cannot parse vector file PATH: REASON"
+ */
+class VectorFileReader {
+ public:
+  /*
+   * Opens path and reads its header. The format is detected from the extension unless given.
+   */
+  explicit VectorFileReader(const std::string& path);
+  VectorFileReader(const std::string& path, VectorFileFormat format);
+  VectorFileReader(const VectorFileReader&) = delete;
+  VectorFileReader& operator=(const VectorFileReader&) = delete;
+  ~VectorFileReader() noexcept;
+
+  VectorFileFormat GetFormat() const noexcept { return format_; }
+
+  /*
+   * Number of dimensions of every vector in the file (0 for an empty .fvecs/.ivecs/.bvecs file).
+   */
+  int GetNumDimensions() const noexcept { return num_dimensions_; }
+
+  /*
+   * Total number of vectors in the file.
+   */
+  std::int64_t GetNumVectors() const noexcept { return num_vectors_; }
+
+  /*
+   * Number of vectors not read yet.
+   */
+  std::int64_t GetNumRemaining() const noexcept { return num_vectors_ - next_vector_; }
+
+  /*
+   * Reads the next (at most) max_vectors vectors. Returns an empty batch once the file is
+   * exhausted. Values of .ivecs and integer .npy files are converted to double exactly up to 2^53.
+   */
+  EuclideanVectorBatch ReadChunk(int max_vectors);
+
+  /*
+   * Moves the read position to the vector at index (clamped to [0, GetNumVectors()]).
+   */
+  void Seek(std::int64_t index);
+
+ private:
+  friend class MappedVectorFile;
+
+  void ReadHeader();
+  void ReadNpyHeader();
+  [[noreturn]] void Fail(const std::string& reason) const;
+
+  std::string path_;
+  VectorFileFormat format_;
+  std::FILE* file_;
+  std::int64_t data_offset_ = 0;
+  std::int64_t record_bytes_ = 0;
+  std::int64_t header_bytes_ = 0;
+  int element_bytes_ = 0;
+  char element_kind_ = 'f';
+  int num_dimensions_ = 0;
+  std::int64_t num_vectors_ = 0;
+  std::int64_t next_vector_ = 0;
+  std::vector<unsigned char> scratch_;
+};
+
+/*
+ * Reads every vector of path (or the first max_vectors if max_vectors >= 0) into one batch.
+ */
+EuclideanVectorBatch LoadVectorFile(const std::string& path, std::int64_t max_vectors = -1);
+
+/*
+ * A float64 .npy file mapped into memory, so its rows can be read in place without copying or
+ * converting. Only files whose data is already little-endian float64 in C order can be mapped;
+ * rows are then packed (stride == dimensions) and only 8-byte aligned. Where the platform has no
+ * mmap, or the host is big-endian, the data is read into memory (byte-swapped if need be) instead.
+ *
+ * When: the file is not a C-order little-endian float64 .npy file
+ * Throw: "Cannot parse vector file PATH: REASON"
+ */
+class MappedVectorFile {
+ public:
+  explicit MappedVectorFile(const std::string& path);
+  MappedVectorFile(const MappedVectorFile&) = delete;
+  MappedVectorFile& operator=(const MappedVectorFile&) = delete;
+  ~MappedVectorFile() noexcept;
+
+  int GetNumDimensions() const noexcept { return num_dimensions_; }
+  std::int64_t GetNumVectors() const noexcept { return num_vectors_; }
+
+  /*
+   * Returns a pointer to the magnitudes of the i-th vector. No bounds checking.
+   */
+  const double* Row(std::int64_t i) const noexcept { return data_ + i * num_dimensions_; }
+
+  /*
+   * Copies rows [begin, begin + count) into a batch (clamped to the end of the file).
+   */
+  EuclideanVectorBatch ToBatch(std::int64_t begin, int count) const;
+
+ private:
+  void* mapping_ = nullptr;
+  std::size_t mapping_bytes_ = 0;
+  std::vector<double> fallback_;
+  const double* data_ = nullptr;
+  int num_dimensions_ = 0;
+  std::int64_t num_vectors_ = 0;
+};
+
+#endif  // ASSIGNMENTS_EV_DATASET_IO_H_
@@ -0,0 +1,221 @@
+/*
+
+  == Explanation and rational of testing ==
+
+  Small files of every supported format and element type are written to a temporary directory
+  byte by byte, so the tests do not depend on any external tool, and read back through the chunked
+  reader, the whole-file loader and (for float64 .npy) the memory mapping. Chunk sizes that do not
+  divide the number of vectors check the last partial chunk. Malformed files (truncated data,
+  inconsistent dimensions, unsupported dtypes, Fortran order) must be rejected with a message
+  naming the file.
+
+*/
+
+#include "assignments/ev/dataset_io.h"
+
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "assignments/ev/euclidean_vector_batch.h"
+#include "catch.h"
+
+namespace {
+
+using Bytes = std::vector<unsigned char>;
+
+template <typename T>
+void Append(Bytes& bytes, T value) {
+  unsigned char raw[sizeof(T)];
+  std::memcpy(raw, &value, sizeof(T));
+  bytes.insert(bytes.end(), raw, raw + sizeof(T));
+}
+
+std::string WriteFile(const std::string& name, const Bytes& bytes) {
+  const auto path = (std::filesystem::temp_directory_path() / ("ev_dataset_io_" + name)).string();
+  std::ofstream out(path, std::ios::binary);
+  out.write(reinterpret_cast<const char*>(bytes.data()),
+            static_cast<std::streamsize>(bytes.size()));
+  return path;
+}
+
+// Value of element (i, j) in every test file; small integers so every type holds it exactly.
+double Value(int i, int j) {
+  return i * 10 + j;
+}
+
+// An .xvecs file of n vectors of d elements of type T.
+template <typename T>
+Bytes MakeXvecs(int n, int d) {
+  Bytes bytes;
+  for (auto i = 0; i < n; ++i) {
+    Append<std::int32_t>(bytes, d);
+    for (auto j = 0; j < d; ++j) {
+      Append<T>(bytes, static_cast<T>(Value(i, j)));
+    }
+  }
+  return bytes;
+}
+
+// The header of a version 1.0 .npy file, with shape given as text, e.g. "(3, 4)".
+Bytes MakeNpyHeader(const std::string& descr, const std::string& shape, bool fortran = false) {
+  auto header = "{'descr': '" + descr + "', 'fortran_order': " + (fortran ? "True" : "False") +
+                ", 'shape': " + shape + ", }";
+  // Pad so the data starts on a 64-byte boundary, as NumPy does.
+  while ((10 + header.size() + 1) % 64 != 0) {
+    header += ' ';
+  }
+  header += '\n';
+  Bytes bytes{0x93, 'N', 'U', 'M', 'P', 'Y', 1, 0};
+  Append<std::uint16_t>(bytes, static_cast<std::uint16_t>(header.size()));
+  bytes.insert(bytes.end(), header.begin(), header.end());
+  return bytes;
+}
+
+// A version 1.0 .npy file holding an n x d array of type T.
+template <typename T>
+Bytes MakeNpy(const std::string& descr, int n, int d, bool fortran = false) {
+  auto bytes = MakeNpyHeader(
+      descr, "(" + std::to_string(n) + ", " + std::to_string(d) + ")", fortran);
+  for (auto i = 0; i < n; ++i) {
+    for (auto j = 0; j < d; ++j) {
+      Append<T>(bytes, static_cast<T>(Value(i, j)));
+    }
+  }
+  return bytes;
+}
+
+void RequireRows(const EuclideanVectorBatch& batch, int first_row, int n, int d) {
+  REQUIRE(batch.GetNumVectors() == n);
+  REQUIRE(batch.GetNumDimensions() == d);
+  for (auto i = 0; i < n; ++i) {
+    for (auto j = 0; j < d; ++j) {
+      REQUIRE(batch.Row(i)[j] == Value(first_row + i, j));
+    }
+  }
+}
+
+// Reads the whole file in chunks of chunk vectors and checks every row.
+void RequireChunkedRead(const std::string& path, int n, int d, int chunk) {
+  VectorFileReader reader(path);
+  REQUIRE(reader.GetNumVectors() == n);
+  REQUIRE(reader.GetNumDimensions() == d);
+  auto first = 0;
+  for (auto batch = reader.ReadChunk(chunk); batch.GetNumVectors() > 0;
+       batch = reader.ReadChunk(chunk)) {
+    RequireRows(batch, first, batch.GetNumVectors(), d);
+    first += batch.GetNumVectors();
+  }
+  REQUIRE(first == n);
+  REQUIRE(reader.GetNumRemaining() == 0);
+}
+
+}  // namespace
+
+TEST_CASE("Reading .fvecs, .ivecs and .bvecs files") {
+  SECTION("TEST CASE 1 - Every xvecs element type, in chunks") {
+    RequireChunkedRead(WriteFile("a.fvecs", MakeXvecs<float>(23, 5)), 23, 5, 4);
+    RequireChunkedRead(WriteFile("a.ivecs", MakeXvecs<std::int32_t>(23, 5)), 23, 5, 7);
+    RequireChunkedRead(WriteFile("a.bvecs", MakeXvecs<std::uint8_t>(23, 5)), 23, 5, 100);
+  }
+
+  SECTION("TEST CASE 2 - Whole-file loading and seeking") {
+    const auto path = WriteFile("b.fvecs", MakeXvecs<float>(10, 3));
+    RequireRows(LoadVectorFile(path), 0, 10, 3);
+    RequireRows(LoadVectorFile(path, 4), 0, 4, 3);
+
+    VectorFileReader reader(path);
+    reader.Seek(6);
+    RequireRows(reader.ReadChunk(10), 6, 4, 3);
+    reader.Seek(0);
+    RequireRows(reader.ReadChunk(2), 0, 2, 3);
+  }
+
+  SECTION("TEST CASE 3 - An empty file has no vectors") {
+    VectorFileReader reader(WriteFile("empty.fvecs", {}));
+    REQUIRE(reader.GetNumVectors() == 0);
+    REQUIRE(reader.ReadChunk(10).GetNumVectors() == 0);
+  }
+}
+
+TEST_CASE("Reading .npy files") {
+  SECTION("TEST CASE 4 - Every supported dtype") {
+    RequireChunkedRead(WriteFile("f8.npy", MakeNpy<double>("<f8", 9, 4)), 9, 4, 2);
+    RequireChunkedRead(WriteFile("f4.npy", MakeNpy<float>("<f4", 9, 4)), 9, 4, 2);
+    RequireChunkedRead(WriteFile("i1.npy", MakeNpy<std::int8_t>("|i1", 9, 4)), 9, 4, 5);
+    RequireChunkedRead(WriteFile("u1.npy", MakeNpy<std::uint8_t>("|u1", 9, 4)), 9, 4, 5);
+    RequireChunkedRead(WriteFile("i4.npy", MakeNpy<std::int32_t>("<i4", 9, 4)), 9, 4, 9);
+    RequireChunkedRead(WriteFile("i8.npy", MakeNpy<std::int64_t>("<i8", 9, 4)), 9, 4, 3);
+  }
+
+  SECTION("TEST CASE 5 - Memory-mapped float64 file") {
+    const auto path = WriteFile("mapped.npy", MakeNpy<double>("<f8", 12, 6));
+    MappedVectorFile mapped(path);
+    REQUIRE(mapped.GetNumVectors() == 12);
+    REQUIRE(mapped.GetNumDimensions() == 6);
+    for (auto i = 0; i < 12; ++i) {
+      for (auto j = 0; j < 6; ++j) {
+        REQUIRE(mapped.Row(i)[j] == Value(i, j));
+      }
+    }
+    RequireRows(mapped.ToBatch(10, 5), 10, 2, 6);
+  }
+}
+
+TEST_CASE("Malformed vector files") {
+  SECTION("TEST CASE 6 - Missing files and unknown extensions") {
+    REQUIRE_THROWS_WITH(VectorFileReader("/nonexistent/x.fvecs"),
+                        Catch::Contains("Cannot open vector file /nonexistent/x.fvecs"));
+    REQUIRE_THROWS_WITH(LoadVectorFile("x.txt"),
+                        Catch::Contains("Cannot parse vector file x.txt: unknown extension"));
+  }
+
+  SECTION("TEST CASE 7 - Truncated and inconsistent xvecs files") {
+    auto bytes = MakeXvecs<float>(3, 4);
+    bytes.pop_back();
+    REQUIRE_THROWS_WITH(VectorFileReader(WriteFile("short.fvecs", bytes)),
+                        Catch::Contains("file size is not a whole number of vectors"));
+
+    bytes = MakeXvecs<float>(3, 4);
+    bytes[2 * 20] = 3;
+    const auto path = WriteFile("mixed.fvecs", bytes);
+    VectorFileReader reader(path);
+    REQUIRE_THROWS_WITH(reader.ReadChunk(3),
+                        Catch::Contains("vector 2 has 3 dimensions, expected 4"));
+  }
+
+  SECTION("TEST CASE 8 - Unsupported .npy files") {
+    REQUIRE_THROWS_WITH(VectorFileReader(WriteFile("f2.npy", MakeNpy<std::int16_t>("<f2", 2, 2))),
+                        Catch::Contains("unsupported dtype <f2"));
+    REQUIRE_THROWS_WITH(VectorFileReader(WriteFile("be.npy", MakeNpy<double>(">f8", 2, 2))),
+                        Catch::Contains("big-endian data is not supported"));
+    REQUIRE_THROWS_WITH(
+        VectorFileReader(WriteFile("fortran.npy", MakeNpy<double>("<f8", 2, 2, true))),
+        Catch::Contains("Fortran-order arrays are not supported"));
+    REQUIRE_THROWS_WITH(MappedVectorFile(WriteFile("f4map.npy", MakeNpy<float>("<f4", 2, 2))),
+                        Catch::Contains("only float64 files can be mapped"));
+
+    auto bytes = MakeNpy<double>("<f8", 3, 3);
+    bytes.resize(bytes.size() - 8);
+    REQUIRE_THROWS_WITH(VectorFileReader(WriteFile("short.npy", bytes)),
+                        Catch::Contains("file is truncated"));
+  }
+
+  SECTION("TEST CASE 9 - Shapes that do not fit are rejected") {
+    const auto huge = WriteFile("huge.npy", MakeNpyHeader("<f8", "(99999999999999999999, 3)"));
+    REQUIRE_THROWS_WITH(VectorFileReader(huge), Catch::Contains("shape is too large"));
+    // The number of vectors times the bytes per vector overflows 64 bits.
+    const auto overflow =
+        WriteFile("overflow.npy", MakeNpyHeader("<f8", "(4611686018427387904, 4)"));
+    REQUIRE_THROWS_WITH(VectorFileReader(overflow), Catch::Contains("file is truncated"));
+  }
+
+  SECTION("TEST CASE 10 - A negative chunk size reads nothing") {
+    VectorFileReader reader(WriteFile("negative.npy", MakeNpy<double>("<f8", 3, 2)));
+    REQUIRE(reader.ReadChunk(-1).GetNumVectors() == 0);
+    REQUIRE(reader.GetNumRemaining() == 3);
+  }
+}
@@ -0,0 +1,60 @@
+#include "assignments/ev/epoch.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <thread>
+#include <utility>
+
+namespace ev::detail {
+
+EpochDomain::~EpochDomain() {
+  for (auto& [epoch, deleter] : retired_) {
+    deleter();
+  }
+}
+
+EpochDomain::Guard EpochDomain::Enter() noexcept {
+  // Threads start at different slots so they rarely compete for the same one.
+  static thread_local const auto home = std::hash<std::thread::id>{}(std::this_thread::get_id());
+  for (auto i = home;; ++i) {
+    auto& slot = slots_[i % kMaxReaders].epoch;
+    auto expected = std::uint64_t{0};
+    // Sequentially consistent, so the announcement is ordered before the reader's loads of shared
+    // pointers and against the writer's scan in Reclaim.
+    if (slot.load(std::memory_order_relaxed) == 0 &&
+        slot.compare_exchange_strong(expected, epoch_.load())) {
+      return Guard(&slot);
+    }
+    if ((i - home) % kMaxReaders == kMaxReaders - 1) {
+      std::this_thread::yield();
+    }
+  }
+}
+
+void EpochDomain::Retire(std::function<void()> deleter) {
+  // Readers that announce a later epoch started after the object was unlinked.
+  retired_.emplace_back(epoch_.fetch_add(1), std::move(deleter));
+  Reclaim();
+}
+
+void EpochDomain::Reclaim() {
+  auto oldest = std::numeric_limits<std::uint64_t>::max();
+  for (const auto& slot : slots_) {
+    const auto epoch = slot.epoch.load();
+    if (epoch != 0) {
+      oldest = std::min(oldest, epoch);
+    }
+  }
+  // A reader that announced epoch e may hold anything retired at e or later.
+  const auto safe = std::find_if(retired_.begin(), retired_.end(),
+                                 [oldest](const auto& r) { return r.first >= oldest; });
+  for (auto r = retired_.begin(); r != safe; ++r) {
+    r->second();
+  }
+  retired_.erase(retired_.begin(), safe);
+}
+
+}  // namespace ev::detail
@@ -0,0 +1,85 @@
+#ifndef ASSIGNMENTS_EV_EPOCH_H_
+#define ASSIGNMENTS_EV_EPOCH_H_
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <utility>
+#include <vector>
+
+namespace ev::detail {
+
+/*
+ * Epoch-based reclamation. Readers wrap every access to shared objects in a Guard. Writers unlink
+ * an object so new readers cannot reach it, then Retire it; it is destroyed once every reader that
+ * might still hold it has dropped its Guard. Readers never wait for writers: entering announces
+ * the current epoch in a free reader slot with a single compare-and-swap, and leaving clears it.
+ */
+class EpochDomain {
+ public:
+  // Readers that can hold a Guard at the same time. Further readers spin until a slot is free.
+  static constexpr int kMaxReaders = 256;
+
+  class Guard {
+   public:
+    Guard(const Guard&) = delete;
+    Guard& operator=(const Guard&) = delete;
+    Guard(Guard&& o) noexcept : slot_{std::exchange(o.slot_, nullptr)} {}
+    ~Guard() {
+      if (slot_ != nullptr) {
+        slot_->store(0, std::memory_order_release);
+      }
+    }
+
+   private:
+    friend class EpochDomain;
+    explicit Guard(std::atomic<std::uint64_t>* slot) noexcept : slot_{slot} {}
+
+    std::atomic<std::uint64_t>* slot_;
+  };
+
+  EpochDomain() = default;
+  EpochDomain(const EpochDomain&) = delete;
+  EpochDomain& operator=(const EpochDomain&) = delete;
+
+  /*
+   * Runs every deleter still pending. No Guard may be alive.
+   */
+  ~EpochDomain();
+
+  /*
+   * Pins the current epoch until the returned Guard is destroyed. Lock-free.
+   */
+  Guard Enter() noexcept;
+
+  /*
+   * Schedules deleter to run once no reader can still see the object it frees, which must already
+   * be unreachable from shared state. Also runs whatever earlier deleters have become safe. Calls
+   * must be serialised by the caller (one writer at a time); Enter may run concurrently.
+   */
+  void Retire(std::function<void()> deleter);
+
+  /*
+   * Number of deleters waiting for readers to move on.
+   */
+  std::size_t GetNumPending() const noexcept { return retired_.size(); }
+
+ private:
+  // Each reader slot has its own cache line so readers on different cores do not contend.
+  struct alignas(64) Slot {
+    // Epoch announced by the reader using the slot, 0 when free.
+    std::atomic<std::uint64_t> epoch{0};
+  };
+
+  void Reclaim();
+
+  std::atomic<std::uint64_t> epoch_{1};
+  std::array<Slot, kMaxReaders> slots_;
+  // (epoch at retirement, deleter), oldest first.
+  std::vector<std::pair<std::uint64_t, std::function<void()>>> retired_;
+};
+
+}  // namespace ev::detail
+
+#endif  // ASSIGNMENTS_EV_EPOCH_H_
@@ -0,0 +1,283 @@
+#include "assignments/ev/euclidean_matrix.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "assignments/ev/aligned_buffer.h"
+#include "assignments/ev/euclidean_vector.h"
+#include "assignments/ev/euclidean_vector_batch.h"
+#include "assignments/ev/kernels.h"
+#include "assignments/ev/parallel.h"
+
+namespace {
+
+// GEMM blocking: a kRowBlock x kDepthBlock panel of A (128KB) is multiplied into a
+// kRowBlock x kColBlock panel of C while the kDepthBlock x kColBlock panel of B (512KB) is
+// streamed through L2 row by row.
+constexpr int kRowBlock = 64;
+constexpr int kDepthBlock = 256;
+constexpr int kColBlock = 256;
+
+// Products smaller than this many multiply-adds are not worth handing to other threads.
+constexpr std::int64_t kParallelThreshold = 1 << 18;
+
+void DimensionMismatch(int lhs, int rhs) {
+  throw EuclideanVectorError("Dimensions of LHS(" + std::to_string(lhs) + ") and RHS(" +
+                             std::to_string(rhs) + ") do not match");
+}
+
+// C[m x n] += A[m x k] * B[k x n] for the rows [i0, i1) of C. The innermost loop (Axpy4) runs
+// along a row of B and C with no reduction, and four rows of C share each load of B.
+void GemmRows(const double* a,
+              int lda,
+              const double* b,
+              int ldb,
+              double* c,
+              int ldc,
+              int i0,
+              int i1,
+              int n,
+              int k) {
+  for (auto k0 = 0; k0 < k; k0 += kDepthBlock) {
+    const auto k1 = std::min(k, k0 + kDepthBlock);
+    for (auto j0 = 0; j0 < n; j0 += kColBlock) {
+      const auto jn = std::min(n, j0 + kColBlock) - j0;
+      auto i = i0;
+      for (; i + 4 <= i1; i += 4) {
+        double* rows[4];
+        for (auto r = 0; r < 4; ++r) {
+          rows[r] = c + static_cast<std::int64_t>(i + r) * ldc + j0;
+        }
+        for (auto p = k0; p < k1; ++p) {
+          double alpha[4];
+          for (auto r = 0; r < 4; ++r) {
+            alpha[r] = a[static_cast<std::int64_t>(i + r) * lda + p];
+          }
+          ev::kernels::Axpy4(rows, alpha, b + static_cast<std::int64_t>(p) * ldb + j0, jn);
+        }
+      }
+      for (; i < i1; ++i) {
+        auto* ci = c + static_cast<std::int64_t>(i) * ldc + j0;
+        for (auto p = k0; p < k1; ++p) {
+          ev::kernels::Axpy(ci, a[static_cast<std::int64_t>(i) * lda + p],
+                            b + static_cast<std::int64_t>(p) * ldb + j0, jn);
+        }
+      }
+    }
+  }
+}
+
+void Gemm(const double* a,
+          int lda,
+          const double* b,
+          int ldb,
+          double* c,
+          int ldc,
+          int m,
+          int n,
+          int k,
+          int num_threads) {
+  const auto work = static_cast<std::int64_t>(m) * n * k;
+  const auto threads = work < kParallelThreshold ? 1 : num_threads;
+  const auto blocks = (m + kRowBlock - 1) / kRowBlock;
+  ev::detail::ParallelFor(0, blocks, 1, threads, [&](std::int64_t lo, std::int64_t hi) {
+    for (auto blk = lo; blk < hi; ++blk) {
+      const auto i0 = static_cast<int>(blk * kRowBlock);
+      GemmRows(a, lda, b, ldb, c, ldc, i0, std::min(m, i0 + kRowBlock), n, k);
+    }
+  });
+}
+
+}  // namespace
+
+// Constructors
+EuclideanMatrix::EuclideanMatrix(int rows, int cols)
+  : data_{ev::detail::AllocateAligned(static_cast<std::size_t>(rows) *
+                                      ev::detail::CheckedPadToCacheLine(cols))},
+    rows_{rows}, cols_{cols}, stride_{static_cast<int>(ev::detail::PadToCacheLine(cols))} {}
+
+EuclideanMatrix::EuclideanMatrix(int rows, int cols, const std::vector<double>& values)
+  : EuclideanMatrix(rows, cols) {
+  if (values.size() != static_cast<std::size_t>(rows) * cols) {
+    throw EuclideanVectorError("Number of values(" + std::to_string(values.size()) +
+                               ") does not match a " + std::to_string(rows) + " x " +
+                               std::to_string(cols) + " matrix");
+  }
+  for (auto r = 0; r < rows_; ++r) {
+    std::copy(values.begin() + static_cast<std::int64_t>(r) * cols_,
+              values.begin() + static_cast<std::int64_t>(r + 1) * cols_, Row(r));
+  }
+}
+
+EuclideanMatrix::EuclideanMatrix(const std::vector<EuclideanVector>& rows)
+  : EuclideanMatrix(static_cast<int>(rows.size()), ev::detail::CommonDimension(rows)) {
+  for (auto r = 0; r < rows_; ++r) {
+    std::copy(rows[r].data(), rows[r].data() + cols_, Row(r));
+  }
+}
+
+EuclideanMatrix EuclideanMatrix::Identity(int n) {
+  EuclideanMatrix result(n, n);
+  for (auto i = 0; i < n; ++i) {
+    result.Row(i)[i] = 1.0;
+  }
+  return result;
+}
+
+EuclideanMatrix::EuclideanMatrix(const EuclideanMatrix& matrix)
+  : EuclideanMatrix(matrix.rows_, matrix.cols_) {
+  std::copy(matrix.data_.get(), matrix.data_.get() + static_cast<std::int64_t>(rows_) * stride_,
+            data_.get());
+}
+
+EuclideanMatrix::EuclideanMatrix(EuclideanMatrix&& matrix) noexcept
+  : data_{std::move(matrix.data_)}, rows_{matrix.rows_}, cols_{matrix.cols_},
+    stride_{matrix.stride_} {
+  matrix.rows_ = 0;
+  matrix.cols_ = 0;
+  matrix.stride_ = 0;
+}
+
+// Assignment
+EuclideanMatrix& EuclideanMatrix::operator=(const EuclideanMatrix& o) {
+  if (this != &o) {
+    *this = EuclideanMatrix(o);
+  }
+  return *this;
+}
+
+EuclideanMatrix& EuclideanMatrix::operator=(EuclideanMatrix&& o) noexcept {
+  data_ = std::move(o.data_);
+  rows_ = o.rows_;
+  cols_ = o.cols_;
+  stride_ = o.stride_;
+  o.rows_ = 0;
+  o.cols_ = 0;
+  o.stride_ = 0;
+  return *this;
+}
+
+// Getters
+double EuclideanMatrix::at(int r, int c) const {
+  CheckIndex(r, c);
+  return Row(r)[c];
+}
+
+double& EuclideanMatrix::at(int r, int c) {
+  CheckIndex(r, c);
+  return Row(r)[c];
+}
+
+void EuclideanMatrix::CheckIndex(int r, int c) const {
+  if (r < 0 || r >= rows_ || c < 0 || c >= cols_) {
+    throw EuclideanVectorError("Index (" + std::to_string(r) + ", " + std::to_string(c) +
+                               ") is not valid for this EuclideanMatrix object");
+  }
+}
+
+EuclideanMatrix EuclideanMatrix::Transpose() const {
+  EuclideanMatrix result(cols_, rows_);
+  // Transposed in 8x8 blocks so both the reads and the writes touch whole cache lines.
+  for (auto r0 = 0; r0 < rows_; r0 += ev::detail::kDoublesPerCacheLine) {
+    for (auto c0 = 0; c0 < cols_; c0 += ev::detail::kDoublesPerCacheLine) {
+      const auto r1 = std::min(rows_, r0 + ev::detail::kDoublesPerCacheLine);
+      const auto c1 = std::min(cols_, c0 + ev::detail::kDoublesPerCacheLine);
+      for (auto r = r0; r < r1; ++r) {
+        for (auto c = c0; c < c1; ++c) {
+          result.Row(c)[r] = Row(r)[c];
+        }
+      }
+    }
+  }
+  return result;
+}
+
+// Friends
+std::ostream& operator<<(std::ostream& os, const EuclideanMatrix& m) {
+  for (auto r = 0; r < m.rows_; ++r) {
+    os << "[";
+    for (auto c = 0; c < m.cols_; ++c) {
+      os << m.Row(r)[c] << (c == m.cols_ - 1 ? "" : " ");
+    }
+    os << "]\n";
+  }
+  return os;
+}
+
+bool operator==(const EuclideanMatrix& lhs, const EuclideanMatrix& rhs) noexcept {
+  if (lhs.rows_ != rhs.rows_ || lhs.cols_ != rhs.cols_) {
+    return false;
+  }
+  for (auto r = 0; r < lhs.rows_; ++r) {
+    if (!std::equal(lhs.Row(r), lhs.Row(r) + lhs.cols_, rhs.Row(r))) {
+      return false;
+    }
+  }
+  return true;
+}
+
+EuclideanVector operator*(const EuclideanMatrix& m, const EuclideanVector& v) {
+  if (m.cols_ != v.GetNumDimensions()) {
+    DimensionMismatch(m.cols_, v.GetNumDimensions());
+  }
+  EuclideanVector result(m.rows_);
+  auto* out = result.data();
+  const auto* x = v.data();
+  const auto threads =
+      static_cast<std::int64_t>(m.rows_) * m.cols_ < kParallelThreshold ? 1 : 0;
+  ev::detail::ParallelFor(0, m.rows_, kRowBlock, threads, [&](std::int64_t lo, std::int64_t hi) {
+    for (auto r = lo; r < hi; ++r) {
+      out[r] = ev::kernels::Dot(m.Row(static_cast<int>(r)), x, m.cols_);
+    }
+  });
+  return result;
+}
+
+EuclideanMatrix operator*(const EuclideanMatrix& lhs, const EuclideanMatrix& rhs) {
+  if (lhs.cols_ != rhs.rows_) {
+    DimensionMismatch(lhs.cols_, rhs.rows_);
+  }
+  EuclideanMatrix result(lhs.rows_, rhs.cols_);
+  Gemm(lhs.data_.get(), lhs.stride_, rhs.data_.get(), rhs.stride_, result.data_.get(),
+       result.stride_, lhs.rows_, rhs.cols_, lhs.cols_, 0);
+  return result;
+}
+
+EuclideanVectorBatch Apply(const EuclideanMatrix& m,
+                           const EuclideanVectorBatch& batch,
+                           int num_threads) {
+  EuclideanVectorBatch result(batch.GetNumVectors(), m.GetNumRows());
+  Apply(m, batch, result, num_threads);
+  return result;
+}
+
+void Apply(const EuclideanMatrix& m,
+           const EuclideanVectorBatch& batch,
+           EuclideanVectorBatch& out,
+           int num_threads) {
+  if (m.GetNumCols() != batch.GetNumDimensions()) {
+    DimensionMismatch(m.GetNumCols(), batch.GetNumDimensions());
+  }
+  if (out.GetNumDimensions() != m.GetNumRows()) {
+    DimensionMismatch(out.GetNumDimensions(), m.GetNumRows());
+  }
+  if (out.GetNumVectors() < batch.GetNumVectors()) {
+    throw EuclideanVectorError("Output batch has fewer rows(" +
+                               std::to_string(out.GetNumVectors()) + ") than input batch(" +
+                               std::to_string(batch.GetNumVectors()) + ")");
+  }
+  if (batch.GetNumVectors() == 0) {
+    return;
+  }
+  // out[n x rows] = batch[n x cols] * m^T[cols x rows]; Gemm accumulates, so clear out first.
+  const auto transposed = m.Transpose();
+  for (auto i = 0; i < batch.GetNumVectors(); ++i) {
+    std::fill(out.Row(i), out.Row(i) + out.GetNumDimensions(), 0.0);
+  }
+  Gemm(batch.Row(0), batch.GetStride(), transposed.Row(0), transposed.GetStride(), out.Row(0),
+       out.GetStride(), batch.GetNumVectors(), m.GetNumRows(), m.GetNumCols(), num_threads);
+}
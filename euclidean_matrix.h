@@ -0,0 +1,133 @@
+#ifndef ASSIGNMENTS_EV_EUCLIDEAN_MATRIX_H_
+#define ASSIGNMENTS_EV_EUCLIDEAN_MATRIX_H_
+
+#include <ostream>
+#include <vector>
+
+#include "assignments/ev/aligned_buffer.h"
+#include "assignments/ev/euclidean_vector.h"
+#include "assignments/ev/euclidean_vector_batch.h"
+
+/*
+ * A dense row-major matrix of doubles, used to apply linear maps to EuclideanVectors. Rows start
+ * on a cache line and are padded with zeros up to GetStride() doubles.
+ */
+class EuclideanMatrix {
+ public:
+  EuclideanMatrix() noexcept : EuclideanMatrix(0, 0) {}
+
+  /*
+   * A constructor that takes the number of rows and columns and sets every entry to 0.0.
+   */
+  EuclideanMatrix(int rows, int cols);
+
+  /*
+   * A constructor that takes the number of rows and columns and the row-major entries.
+   * When: values.size() != rows * cols
+   * Throw: "Number of values(X) does not match a R x C matrix"
+   */
+  EuclideanMatrix(int rows, int cols, const std::vector<double>& values);
+
+  /*
+   * A constructor that uses the vectors as the rows of the matrix.
+   * When: the vectors do not all have the same number of dimensions
+   * Throw: "Dimensions of LHS(X) and RHS(Y) do not match"
+   */
+  explicit EuclideanMatrix(const std::vector<EuclideanVector>& rows);
+
+  /*
+   * Returns the n x n identity matrix.
+   */
+  static EuclideanMatrix Identity(int n);
+
+  EuclideanMatrix(const EuclideanMatrix& matrix);
+  EuclideanMatrix(EuclideanMatrix&& matrix) noexcept;
+  ~EuclideanMatrix() noexcept = default;
+
+  EuclideanMatrix& operator=(const EuclideanMatrix& o);
+  EuclideanMatrix& operator=(EuclideanMatrix&& o) noexcept;
+
+  int GetNumRows() const noexcept { return rows_; }
+  int GetNumCols() const noexcept { return cols_; }
+
+  /*
+   * Distance, in doubles, between the starts of two consecutive rows.
+   */
+  int GetStride() const noexcept { return stride_; }
+
+  /*
+   * Returns a pointer to the r-th row. No bounds checking.
+   */
+  const double* Row(int r) const noexcept { return data_.get() + static_cast<long>(r) * stride_; }
+  double* Row(int r) noexcept { return data_.get() + static_cast<long>(r) * stride_; }
+
+  /*
+   * Returns the entry in row r and column c.
+   * When: r or c is out of range
+   * Throw: "Index (R, C) is not valid for this EuclideanMatrix object"
+   */
+  double at(int r, int c) const;
+  double& at(int r, int c);
+
+  /*
+   * Returns the transpose of the matrix.
+   */
+  EuclideanMatrix Transpose() const;
+
+  /*
+   * Prints the matrix one row per line, each row formatted like an EuclideanVector.
+   */
+  friend std::ostream& operator<<(std::ostream& os, const EuclideanMatrix& m);
+
+  friend bool operator==(const EuclideanMatrix& lhs, const EuclideanMatrix& rhs) noexcept;
+  friend bool operator!=(const EuclideanMatrix& lhs, const EuclideanMatrix& rhs) noexcept {
+    return !(lhs == rhs);
+  }
+
+  /*
+   * Matrix-vector product (GEMV), e.g. a projection of v into GetNumRows() dimensions.
+   * When: m.GetNumCols() != v.GetNumDimensions()
+   * Throw: "Dimensions of LHS(X) and RHS(Y) do not match"
+   */
+  friend EuclideanVector operator*(const EuclideanMatrix& m, const EuclideanVector& v);
+
+  /*
+   * Matrix-matrix product (GEMM). Cache blocked and multithreaded for large sizes.
+   * When: lhs.GetNumCols() != rhs.GetNumRows()
+   * Throw: "Dimensions of LHS(X) and RHS(Y) do not match"
+   */
+  friend EuclideanMatrix operator*(const EuclideanMatrix& lhs, const EuclideanMatrix& rhs);
+
+ private:
+  void CheckIndex(int r, int c) const;
+
+  ev::detail::AlignedDoubleBuffer data_;
+  int rows_;
+  int cols_;
+  int stride_;
+};
+
+/*
+ * Applies m to every vector of the batch, i.e. row i of the result is m * batch.GetVector(i).
+ * This is one GEMM against the transpose of m rather than one GEMV per vector.
+ * When: m.GetNumCols() != batch.GetNumDimensions()
+ * Throw: "Dimensions of LHS(X) and RHS(Y) do not match"
+ */
+EuclideanVectorBatch Apply(const EuclideanMatrix& m,
+                           const EuclideanVectorBatch& batch,
+                           int num_threads = 0);
+
+/*
+ * As above, but writes into the first batch.GetNumVectors() rows of out, which must already have
+ * m.GetNumRows() dimensions, so a stream of batches can reuse one output buffer.
+ * When: out.GetNumDimensions() != m.GetNumRows()
+ * Throw: "Dimensions of LHS(X) and RHS(Y) do not match"
+ * When: out has fewer rows than batch
+ * Throw: "Output batch has fewer rows(X) than input batch(Y)"
+ */
+void Apply(const EuclideanMatrix& m,
+           const EuclideanVectorBatch& batch,
+           EuclideanVectorBatch& out,
+           int num_threads = 0);
+
+#endif  // ASSIGNMENTS_EV_EUCLIDEAN_MATRIX_H_
@@ -0,0 +1,166 @@
+/*
+
+  == Explanation and rational of testing ==
+
+  Small products are checked against values worked out by hand. Larger products, with sizes that
+  are not multiples of the block sizes and large enough to take the multithreaded path, are
+  checked against rows of operator* dot products, which is what the matrix type replaces. We also
+  test construction, element access, transposition and the exceptions.
+
+*/
+
+#include "assignments/ev/euclidean_matrix.h"
+
+#include <cmath>
+#include <cstdint>
+#include <sstream>
+#include <utility>
+#include <vector>
+
+#include "assignments/ev/euclidean_vector_batch.h"
+#include "catch.h"
+
+namespace {
+
+EuclideanMatrix MakeMatrix(int rows, int cols, double phase) {
+  EuclideanMatrix m(rows, cols);
+  for (auto r = 0; r < rows; ++r) {
+    for (auto c = 0; c < cols; ++c) {
+      m.at(r, c) = std::cos(phase + r * 0.13 + c * 0.29);
+    }
+  }
+  return m;
+}
+
+EuclideanVector RowOf(const EuclideanMatrix& m, int r) {
+  EuclideanVector v(m.GetNumCols());
+  for (auto c = 0; c < m.GetNumCols(); ++c) {
+    v[c] = m.at(r, c);
+  }
+  return v;
+}
+
+}  // namespace
+
+TEST_CASE("Euclidean Matrix Constructors and Access") {
+  SECTION("TEST CASE 1 Constructed from values in row-major order") {
+    EuclideanMatrix m(2, 3, {1, 2, 3, 4, 5, 6});
+    REQUIRE(m.GetNumRows() == 2);
+    REQUIRE(m.GetNumCols() == 3);
+    REQUIRE(m.at(0, 2) == 3);
+    REQUIRE(m.at(1, 0) == 4);
+    REQUIRE(reinterpret_cast<std::uintptr_t>(m.Row(1)) % 64 == 0);
+  }
+
+  SECTION("TEST CASE 2 Constructed from rows") {
+    std::vector<double> l{1, 2};
+    EuclideanMatrix m(std::vector<EuclideanVector>{EuclideanVector{l.begin(), l.end()},
+                                                   EuclideanVector(2, 5.0)});
+    REQUIRE(m == EuclideanMatrix(2, 2, {1, 2, 5, 5}));
+  }
+
+  SECTION("TEST CASE 3 Copy and move") {
+    EuclideanMatrix a(2, 2, {1, 2, 3, 4});
+    EuclideanMatrix b = a;
+    REQUIRE(b == a);
+    EuclideanMatrix c = std::move(a);
+    REQUIRE(c == b);
+    REQUIRE(a.GetNumRows() == 0);
+  }
+
+  SECTION("TEST CASE 4 Printing") {
+    std::ostringstream os;
+    os << EuclideanMatrix(2, 2, {1, 2, 3, 4});
+    REQUIRE(os.str() == "[1 2]\n[3 4]\n");
+  }
+
+  SECTION("TEST CASE 5 Exceptions") {
+    REQUIRE_THROWS_WITH(EuclideanMatrix(2, 2, {1, 2, 3}),
+                        Catch::Contains("Number of values(3) does not match a 2 x 2 matrix"));
+    EuclideanMatrix m(2, 2);
+    REQUIRE_THROWS_WITH(m.at(2, 0), Catch::Contains("Index (2, 0) is not valid"));
+  }
+}
+
+TEST_CASE("Euclidean Matrix Transpose") {
+  const auto m = MakeMatrix(13, 21, 0.0);
+  const auto t = m.Transpose();
+  REQUIRE(t.GetNumRows() == 21);
+  REQUIRE(t.GetNumCols() == 13);
+  for (auto r = 0; r < 13; ++r) {
+    for (auto c = 0; c < 21; ++c) {
+      REQUIRE(t.at(c, r) == m.at(r, c));
+    }
+  }
+  REQUIRE(t.Transpose() == m);
+}
+
+TEST_CASE("Euclidean Matrix times Euclidean Vector") {
+  SECTION("TEST CASE 1 Small product") {
+    EuclideanMatrix m(2, 3, {1, 2, 3, 4, 5, 6});
+    std::vector<double> l{1, 0, -1};
+    const auto y = m * EuclideanVector{l.begin(), l.end()};
+    REQUIRE(y.GetNumDimensions() == 2);
+    REQUIRE(y.at(0) == -2);
+    REQUIRE(y.at(1) == -2);
+  }
+
+  SECTION("TEST CASE 2 Large product matches row dot products") {
+    const auto m = MakeMatrix(700, 500, 0.0);
+    const auto x = RowOf(MakeMatrix(1, 500, 2.0), 0);
+    const auto y = m * x;
+    for (auto r = 0; r < 700; ++r) {
+      REQUIRE(y.at(r) == Approx(RowOf(m, r) * x).margin(1e-9));
+    }
+  }
+
+  SECTION("TEST CASE 3 Exception will be thrown when dimensions differ") {
+    REQUIRE_THROWS_WITH(EuclideanMatrix(2, 3) * EuclideanVector(2),
+                        Catch::Contains("Dimensions of LHS(3) and RHS(2)"));
+  }
+}
+
+TEST_CASE("Euclidean Matrix times Euclidean Matrix") {
+  SECTION("TEST CASE 1 Small product") {
+    EuclideanMatrix a(2, 3, {1, 2, 3, 4, 5, 6});
+    EuclideanMatrix b(3, 2, {7, 8, 9, 10, 11, 12});
+    REQUIRE(a * b == EuclideanMatrix(2, 2, {58, 64, 139, 154}));
+    REQUIRE(a * EuclideanMatrix::Identity(3) == a);
+  }
+
+  SECTION("TEST CASE 2 Large product matches row dot products") {
+    const auto a = MakeMatrix(131, 300, 0.0);
+    const auto b = MakeMatrix(300, 270, 1.0);
+    const auto c = a * b;
+    const auto bt = b.Transpose();
+    for (auto r = 0; r < 131; ++r) {
+      for (auto col = 0; col < 270; ++col) {
+        REQUIRE(c.at(r, col) == Approx(RowOf(a, r) * RowOf(bt, col)).margin(1e-9));
+      }
+    }
+  }
+
+  SECTION("TEST CASE 3 Exception will be thrown when dimensions differ") {
+    REQUIRE_THROWS_WITH(EuclideanMatrix(2, 3) * EuclideanMatrix(2, 3),
+                        Catch::Contains("Dimensions of LHS(3) and RHS(2)"));
+  }
+}
+
+TEST_CASE("Applying an Euclidean Matrix to a batch") {
+  const auto m = MakeMatrix(20, 33, 0.5);
+  const auto rows = MakeMatrix(45, 33, 1.5);
+  EuclideanVectorBatch input(45, 33);
+  for (auto i = 0; i < 45; ++i) {
+    input.SetVector(i, RowOf(rows, i));
+  }
+  const auto output = Apply(m, input, 2);
+  REQUIRE(output.GetNumVectors() == 45);
+  REQUIRE(output.GetNumDimensions() == 20);
+  for (auto i = 0; i < 45; ++i) {
+    const auto expected = m * input.GetVector(i);
+    for (auto r = 0; r < 20; ++r) {
+      REQUIRE(output.Row(i)[r] == Approx(expected.at(r)).margin(1e-12));
+    }
+  }
+  REQUIRE_THROWS_WITH(Apply(m, EuclideanVectorBatch(2, 5)), Catch::Contains("Dimensions of LHS"));
+}
@@ -13,12 +13,17 @@
 #include <utility>
 #include <vector>
 
+#include "assignments/ev/aligned_buffer.h"
+#include "assignments/ev/kernels.h"
+#include "assignments/ev/vector_pool.h"
+
 // Constructors
 EuclideanVector::EuclideanVector(const int dimension, const double num) noexcept
-  : magnitudes_{std::make_unique<double[]>(dimension)}, num_dimension_{dimension} {
+  : magnitudes_{ev::detail::AllocateVectorBuffer(dimension)}, num_dimension_{dimension} {
   for (auto i = 0; i < this->GetNumDimensions(); ++i) {
     magnitudes_[i] = num;
   }
+  ZeroPadding();
 }
 
 EuclideanVector::EuclideanVector(const std::vector<double>::const_iterator begin,
@@ -57,11 +62,17 @@ double& EuclideanVector::operator[](const int index) noexcept {
 
 // Overloading '=' by copying
 EuclideanVector& EuclideanVector::operator=(const EuclideanVector& o) noexcept {
-  this->magnitudes_ = std::make_unique<double[]>(o.num_dimension_);
+  // Vectors of the same size class keep their buffer, so the assignment does not allocate.
+  if (!this->magnitudes_ ||
+      this->magnitudes_.get_deleter().capacity != ev::detail::PadToCacheLine(o.num_dimension_)) {
+    this->magnitudes_ = ev::detail::AllocateVectorBuffer(o.num_dimension_);
+  }
   this->num_dimension_ = o.num_dimension_;
   for (auto i = 0; i < o.num_dimension_; ++i) {
     this->magnitudes_[i] = o.magnitudes_[i];
   }
+  // A kept buffer may have held more magnitudes than o.
+  ZeroPadding();
   return *this;
 }
 
@@ -75,46 +86,22 @@ EuclideanVector& EuclideanVector::operator=(EuclideanVector&& o) noexcept {
 
 // '+-*/' overloading
 EuclideanVector& EuclideanVector::operator+=(const EuclideanVector& o) {
-  if (o.GetNumDimensions() != this->GetNumDimensions()) {
-    throw EuclideanVectorError("Dimensions of LHS(" + std::to_string(this->GetNumDimensions()) +
-                               ") and RHS(" + std::to_string(o.GetNumDimensions()) +
-                               ") do not match");
-  }
-
-  for (auto i = 0; i < o.num_dimension_; ++i) {
-    this->magnitudes_[i] += o.magnitudes_[i];
-  }
+  TryAddAssign(o).ThrowIfError();
   return *this;
 }
 
 EuclideanVector& EuclideanVector::operator-=(const EuclideanVector& o) {
-  if (o.GetNumDimensions() != this->GetNumDimensions()) {
-    throw EuclideanVectorError("Dimensions of LHS(" + std::to_string(this->GetNumDimensions()) +
-                               ") and RHS(" + std::to_string(o.GetNumDimensions()) +
-                               ") do not match");
-  }
-
-  for (auto i = 0; i < o.num_dimension_; ++i) {
-    this->magnitudes_[i] -= o.magnitudes_[i];
-  }
+  TrySubtractAssign(o).ThrowIfError();
   return *this;
 }
 
 EuclideanVector& EuclideanVector::operator*=(const double o) noexcept {
-  for (auto i = 0; i < this->num_dimension_; ++i) {
-    this->magnitudes_[i] *= o;
-  }
+  ev::kernels::Scale(this->magnitudes_.get(), o, KernelLength(std::isfinite(o)));
   return *this;
 }
 
 EuclideanVector& EuclideanVector::operator/=(const double o) {
-  if (o == 0) {
-    throw EuclideanVectorError("Invalid vector division by 0");
-  }
-
-  for (auto i = 0; i < this->num_dimension_; ++i) {
-    this->magnitudes_[i] /= o;
-  }
+  TryDivideAssign(o).ThrowIfError();
   return *this;
 }
 
@@ -137,18 +124,12 @@ EuclideanVector::operator std::list<double>() const noexcept {
 
 // Getters
 double EuclideanVector::at(int i) const {
-  if (i < 0 || i >= this->GetNumDimensions()) {
-    throw EuclideanVectorError(std::string("Index ") + std::to_string(i) +
-                               std::string(" is not valid for this EuclideanVector object"));
-  }
+  CheckIndex(i).ThrowIfError();
   return magnitudes_[i];
 }
 
 double& EuclideanVector::at(int i) {
-  if (i < 0 || i >= this->GetNumDimensions()) {
-    throw EuclideanVectorError(std::string("Index ") + std::to_string(i) +
-                               std::string(" is not valid for this EuclideanVector object"));
-  }
+  CheckIndex(i).ThrowIfError();
   return magnitudes_[i];
 }
 
@@ -157,31 +138,160 @@ int EuclideanVector::GetNumDimensions() const noexcept {
 }
 
 double EuclideanVector::GetEuclideanNorm() const {
-  if (this->GetNumDimensions() == 0) {
-    throw EuclideanVectorError("EuclideanVector with no dimensions does not have a norm");
+  return TryGetEuclideanNorm().GetValue();
+}
+
+EuclideanVector EuclideanVector::CreateUnitVector() const {
+  return TryCreateUnitVector().GetValue();
+}
+
+EuclideanVector& EuclideanVector::Axpy(double alpha, const EuclideanVector& x) {
+  CheckSameDimensions(*this, x).ThrowIfError();
+  ev::kernels::Axpy(magnitudes_.get(), alpha, x.magnitudes_.get(),
+                    KernelLength(std::isfinite(alpha)));
+  return *this;
+}
+
+EuclideanVector& EuclideanVector::Axpby(double alpha, const EuclideanVector& x, double beta) {
+  CheckSameDimensions(*this, x).ThrowIfError();
+  ev::kernels::Axpby(magnitudes_.get(), alpha, x.magnitudes_.get(), beta,
+                     KernelLength(std::isfinite(alpha) && std::isfinite(beta)));
+  return *this;
+}
+
+EuclideanVector& EuclideanVector::Lerp(const EuclideanVector& other, double t) {
+  CheckSameDimensions(*this, other).ThrowIfError();
+  ev::kernels::Lerp(magnitudes_.get(), other.magnitudes_.get(), t, KernelLength(std::isfinite(t)));
+  return *this;
+}
+
+double EuclideanVector::GetL1Norm() const {
+  CheckNotEmpty(EuclideanVectorErrc::kNoDimensionsNorm).ThrowIfError();
+  return ev::kernels::AbsSum(magnitudes_.get(), num_dimension_);
+}
+
+double EuclideanVector::GetLInfNorm() const {
+  CheckNotEmpty(EuclideanVectorErrc::kNoDimensionsNorm).ThrowIfError();
+  return ev::kernels::MaxAbs(magnitudes_.get(), num_dimension_);
+}
+
+double EuclideanVector::GetPNorm(double p) const {
+  CheckNotEmpty(EuclideanVectorErrc::kNoDimensionsNorm).ThrowIfError();
+  if (!(p >= 1)) {
+    EuclideanVectorStatus(EuclideanVectorErrc::kInvalidNormOrder).ThrowIfError();
   }
-  double sum = 0;
-  for (auto i = 0; i < this->GetNumDimensions(); ++i) {
-    sum += (this->magnitudes_[i] * this->magnitudes_[i]);
+  if (p == 1) {
+    return GetL1Norm();
+  }
+  if (p == 2) {
+    return GetEuclideanNorm();
+  }
+  const auto largest = GetLInfNorm();
+  if (std::isinf(p) || largest == 0 || std::isinf(largest)) {
+    return largest;
+  }
+  auto sum = 0.0;
+  for (auto i = 0; i < num_dimension_; ++i) {
+    sum += std::pow(std::fabs(magnitudes_[i]) / largest, p);
   }
-  return sqrt(sum);
+  return largest * std::pow(sum, 1 / p);
 }
 
-EuclideanVector EuclideanVector::CreateUnitVector() const {
+double EuclideanVector::Sum() const noexcept {
+  return ev::kernels::Sum(magnitudes_.get(), num_dimension_);
+}
+
+double EuclideanVector::Min() const {
+  return magnitudes_[ArgMin()];
+}
+
+double EuclideanVector::Max() const {
+  return magnitudes_[ArgMax()];
+}
+
+int EuclideanVector::ArgMin() const {
+  CheckNotEmpty(EuclideanVectorErrc::kNoDimensionsExtremum).ThrowIfError();
+  return ev::kernels::ArgMin(magnitudes_.get(), num_dimension_);
+}
+
+int EuclideanVector::ArgMax() const {
+  CheckNotEmpty(EuclideanVectorErrc::kNoDimensionsExtremum).ThrowIfError();
+  return ev::kernels::ArgMax(magnitudes_.get(), num_dimension_);
+}
+
+EuclideanVector& EuclideanVector::Abs() noexcept {
+  ev::kernels::Abs(magnitudes_.get(), GetPaddedDimensions());
+  return *this;
+}
+
+EuclideanVector& EuclideanVector::Clamp(double lo, double hi) {
+  if (!(lo <= hi)) {
+    EuclideanVectorStatus(EuclideanVectorErrc::kEmptyClampRange).ThrowIfError();
+  }
+  ev::kernels::Clamp(magnitudes_.get(), lo, hi, num_dimension_);
+  return *this;
+}
+
+// Non-throwing versions
+EuclideanVectorStatus EuclideanVector::TryAddAssign(const EuclideanVector& o) noexcept {
+  if (auto status = CheckSameDimensions(*this, o); !status) {
+    return status;
+  }
+  ev::kernels::Add(this->magnitudes_.get(), o.magnitudes_.get(), o.GetPaddedDimensions());
+  return EuclideanVectorStatus();
+}
+
+EuclideanVectorStatus EuclideanVector::TrySubtractAssign(const EuclideanVector& o) noexcept {
+  if (auto status = CheckSameDimensions(*this, o); !status) {
+    return status;
+  }
+  ev::kernels::Sub(this->magnitudes_.get(), o.magnitudes_.get(), o.GetPaddedDimensions());
+  return EuclideanVectorStatus();
+}
+
+EuclideanVectorStatus EuclideanVector::TryDivideAssign(const double o) noexcept {
+  if (o == 0) {
+    return EuclideanVectorStatus(EuclideanVectorErrc::kDivisionByZero);
+  }
+  ev::kernels::Divide(this->magnitudes_.get(), o, KernelLength(std::isfinite(o)));
+  return EuclideanVectorStatus();
+}
+
+EuclideanVectorResult<double> EuclideanVector::TryAt(int i) const noexcept {
+  if (auto status = CheckIndex(i); !status) {
+    return status;
+  }
+  return magnitudes_[i];
+}
+
+EuclideanVectorStatus EuclideanVector::TrySet(int i, double value) noexcept {
+  if (auto status = CheckIndex(i); !status) {
+    return status;
+  }
+  magnitudes_[i] = value;
+  return EuclideanVectorStatus();
+}
+
+EuclideanVectorResult<double> EuclideanVector::TryGetEuclideanNorm() const noexcept {
   if (this->GetNumDimensions() == 0) {
-    throw EuclideanVectorError("EuclideanVector with no dimensions does not have a unit vector");
+    return EuclideanVectorStatus(EuclideanVectorErrc::kNoDimensionsNorm);
+  }
+  return sqrt(ev::kernels::Dot(this->magnitudes_.get(), this->magnitudes_.get(),
+                              this->GetNumDimensions()));
+}
+
+EuclideanVectorResult<EuclideanVector> EuclideanVector::TryCreateUnitVector() const noexcept {
+  if (this->GetNumDimensions() == 0) {
+    return EuclideanVectorStatus(EuclideanVectorErrc::kNoDimensionsUnitVector);
   }
 
   // Get euclidean norm and see if it's zero.
-  double norm = this->GetEuclideanNorm();
+  double norm = this->TryGetEuclideanNorm().GetValueOr(0);
   if (norm == 0) {
-    throw EuclideanVectorError(
-        "EuclideanVector with euclidean normal of 0 does not have a unit vector");
+    return EuclideanVectorStatus(EuclideanVectorErrc::kZeroNormUnitVector);
   }
 
   EuclideanVector result(*this);
-  for (auto i = 0; i < result.GetNumDimensions(); ++i) {
-    result.magnitudes_[i] /= norm;
-  }
+  ev::kernels::Divide(result.magnitudes_.get(), norm, result.KernelLength(std::isfinite(norm)));
   return result;
 }
@@ -1,21 +1,20 @@
 #ifndef ASSIGNMENTS_EV_EUCLIDEAN_VECTOR_H_
 #define ASSIGNMENTS_EV_EUCLIDEAN_VECTOR_H_
 
+#include <cmath>
+#include <cstddef>
 #include <exception>
+#include <functional>
 #include <list>
 #include <memory>
 #include <ostream>
 #include <string>
 #include <vector>
 
-class EuclideanVectorError : public std::exception {
- public:
-  explicit EuclideanVectorError(const std::string& what) : what_(what) {}
-  const char* what() const noexcept { return what_.c_str(); }
-
- private:
-  std::string what_;
-};
+#include "assignments/ev/aligned_buffer.h"
+#include "assignments/ev/euclidean_vector_status.h"
+#include "assignments/ev/kernels.h"
+#include "assignments/ev/vector_pool.h"
 
 class EuclideanVector {
  public:
@@ -100,6 +99,20 @@ class EuclideanVector {
    */
   EuclideanVector& operator*=(const double o) noexcept;
 
+  /*
+   * Fused in-place updates that make one pass over the magnitudes and no temporary vector, unlike
+   * e.g. a += x * alpha. Each returns *this.
+   *   Axpy(alpha, x):         *this += alpha * x
+   *   Axpby(alpha, x, beta):  *this = alpha * x + beta * *this
+   *   Lerp(other, t):         *this += t * (other - *this)
+   * Given: X = this->GetNumDimensions(), Y = x.GetNumDimensions()
+   * When: X != Y
+   * Throw: "Dimensions of LHS(X) and RHS(Y) do not match"
+   */
+  EuclideanVector& Axpy(double alpha, const EuclideanVector& x);
+  EuclideanVector& Axpby(double alpha, const EuclideanVector& x, double beta);
+  EuclideanVector& Lerp(const EuclideanVector& other, double t);
+
   /*
    * For scalar division, e.g. [3 6] / 2 = [1.5 3]
    * When: b == 0
@@ -136,6 +149,25 @@ class EuclideanVector {
    */
   int GetNumDimensions() const noexcept;
 
+  /*
+   * Returns a pointer to the contiguous magnitudes, GetNumDimensions() doubles long. Intended for
+   * the batch kernels that would otherwise go through operator[] one element at a time. The
+   * pointer is aligned to a cache line (64 bytes), and the magnitudes are followed by padding up
+   * to GetPaddedDimensions() doubles that is always 0 (or -0), so a kernel may load whole SIMD
+   * vectors without a scalar tail. Writes through data() must leave the padding 0.
+   */
+  const double* data() const noexcept { return magnitudes_.get(); }
+  double* data() noexcept { return magnitudes_.get(); }
+
+  /*
+   * Number of doubles behind data(): GetNumDimensions() rounded up to a whole cache line, which
+   * is a multiple of the widest SIMD register.
+   */
+  int GetPaddedDimensions() const noexcept {
+    // Fits: the buffer could not have been allocated otherwise.
+    return static_cast<int>(ev::detail::PadToCacheLine(num_dimension_));
+  }
+
   /*
    * Returns the Euclidean norm of the vector as a double. The Euclidean norm is the square root of
    * the sum of the squares of the magnitudes in each dimension. E.g, for the vector [1 2 3] the
@@ -154,6 +186,82 @@ class EuclideanVector {
    */
   EuclideanVector CreateUnitVector() const;
 
+  /*
+   * Returns the L1 norm (sum of the absolute magnitudes) and the L-infinity norm (largest absolute
+   * magnitude) of the vector.
+   * When: this->GetNumDimensions() == 0
+   * Throw: "EuclideanVector with no dimensions does not have a norm"
+   */
+  double GetL1Norm() const;
+  double GetLInfNorm() const;
+
+  /*
+   * Returns the p-norm of the vector, (sum of |magnitude|^p)^(1/p). p may be infinite, which gives
+   * GetLInfNorm(). p = 1 and p = 2 use the same kernels as GetL1Norm and GetEuclideanNorm; other
+   * values scale by the largest magnitude first so the powers neither overflow nor underflow.
+   * When: this->GetNumDimensions() == 0
+   * Throw: "EuclideanVector with no dimensions does not have a norm"
+   * When: p < 1 or p is NaN
+   * Throw: "The p-norm of an EuclideanVector needs p >= 1"
+   */
+  double GetPNorm(double p) const;
+
+  /*
+   * Returns the sum of the magnitudes, 0 for a vector with no dimensions.
+   */
+  double Sum() const noexcept;
+
+  /*
+   * Return the smallest and largest magnitude, and the lowest dimension holding it. NaNs are
+   * skipped, unless every magnitude is NaN.
+   * When: this->GetNumDimensions() == 0
+   * Throw: "EuclideanVector with no dimensions does not have a minimum or maximum"
+   */
+  double Min() const;
+  double Max() const;
+  int ArgMin() const;
+  int ArgMax() const;
+
+  /*
+   * Replaces every magnitude with its absolute value, and returns *this.
+   */
+  EuclideanVector& Abs() noexcept;
+
+  /*
+   * Limits every magnitude to [lo, hi], and returns *this.
+   * When: lo > hi, or either is NaN
+   * Throw: "Cannot clamp an EuclideanVector to an empty range"
+   */
+  EuclideanVector& Clamp(double lo, double hi);
+
+  /*
+   * Replaces every magnitude x with f(x), and returns *this. Defined here so f is inlined into a
+   * plain loop, which the compiler vectorises when f is simple enough, e.g.
+   *   v.Transform([](double x) { return x > 0 ? x : 0.01 * x; });
+   */
+  template <typename F>
+  EuclideanVector& Transform(F f) {
+    auto* magnitudes = magnitudes_.get();
+    for (auto i = 0; i < num_dimension_; ++i) {
+      magnitudes[i] = f(magnitudes[i]);
+    }
+    return *this;
+  }
+
+  /*
+   * Non-throwing versions of the operations above, for validating untrusted input without paying
+   * for exceptions. Each reports the error the throwing version would have thrown through an
+   * EuclideanVectorStatus (or an EuclideanVectorResult holding the value); the message is only
+   * formatted if GetMessage() is called. On error *this is left unchanged.
+   */
+  EuclideanVectorStatus TryAddAssign(const EuclideanVector& o) noexcept;       // *this += o
+  EuclideanVectorStatus TrySubtractAssign(const EuclideanVector& o) noexcept;  // *this -= o
+  EuclideanVectorStatus TryDivideAssign(const double o) noexcept;              // *this /= o
+  EuclideanVectorResult<double> TryAt(int i) const noexcept;                   // at(i)
+  EuclideanVectorStatus TrySet(int i, double value) noexcept;                  // at(i) = value
+  EuclideanVectorResult<double> TryGetEuclideanNorm() const noexcept;
+  EuclideanVectorResult<EuclideanVector> TryCreateUnitVector() const noexcept;
+
   /*
    * Prints out the magnitude in each dimension of the Euclidean Vector (surrounded by [ and ]),
    * e.g. for a 3-dimensional vector: [1 2 3]
@@ -173,18 +281,12 @@ class EuclideanVector {
 
   /*
    * True if the two vectors are equal in the number of dimensions and the magnitude in each
-   * dimension is equal.
+   * dimension is equal. Magnitudes compare as doubles: 0 equals -0, and a vector holding a NaN
+   * is not equal to any vector, itself included.
    */
   friend bool operator==(const EuclideanVector& rhs, const EuclideanVector& lhs) noexcept {
-    if (rhs.GetNumDimensions() != lhs.GetNumDimensions()) {
-      return false;
-    }
-    for (auto i = 0; i < rhs.GetNumDimensions(); ++i) {
-      if (rhs[i] != lhs[i]) {
-        return false;
-      }
-    }
-    return true;
+    return rhs.GetNumDimensions() == lhs.GetNumDimensions() &&
+           ev::kernels::Equal(rhs.data(), lhs.data(), rhs.GetNumDimensions());
   }
 
   /*
@@ -199,16 +301,9 @@ class EuclideanVector {
    * For adding vectors of the same dimension.
    */
   friend EuclideanVector operator+(const EuclideanVector& rhs, const EuclideanVector& lhs) {
-    if (rhs.GetNumDimensions() != lhs.GetNumDimensions()) {
-      throw EuclideanVectorError("Dimensions of LHS(" + std::to_string(rhs.GetNumDimensions()) +
-                                 ") and RHS(" + std::to_string(lhs.GetNumDimensions()) +
-                                 ") do not match");
-    }
-
+    CheckSameDimensions(rhs, lhs).ThrowIfError();
     EuclideanVector result(rhs);
-    for (auto i = 0; i < rhs.GetNumDimensions(); ++i) {
-      result[i] += lhs[i];
-    }
+    ev::kernels::Add(result.data(), lhs.data(), rhs.GetPaddedDimensions());
     return result;
   }
 
@@ -216,16 +311,9 @@ class EuclideanVector {
    * For substracting vectors of the same dimension.
    */
   friend EuclideanVector operator-(const EuclideanVector& rhs, const EuclideanVector& lhs) {
-    if (rhs.GetNumDimensions() != lhs.GetNumDimensions()) {
-      throw EuclideanVectorError("Dimensions of LHS(" + std::to_string(rhs.GetNumDimensions()) +
-                                 ") and RHS(" + std::to_string(lhs.GetNumDimensions()) +
-                                 ") do not match");
-    }
-
+    CheckSameDimensions(rhs, lhs).ThrowIfError();
     EuclideanVector result(rhs);
-    for (auto i = 0; i < rhs.GetNumDimensions(); ++i) {
-      result[i] -= lhs[i];
-    }
+    ev::kernels::Sub(result.data(), lhs.data(), rhs.GetPaddedDimensions());
     return result;
   }
 
@@ -234,17 +322,8 @@ class EuclideanVector {
    * E.g., [1 2] * [3 4] = 1 * 3 + 2 * 4 = 11
    */
   friend double operator*(const EuclideanVector& rhs, const EuclideanVector& lhs) {
-    if (rhs.GetNumDimensions() != lhs.GetNumDimensions()) {
-      throw EuclideanVectorError("Dimensions of LHS(" + std::to_string(rhs.GetNumDimensions()) +
-                                 ") and RHS(" + std::to_string(lhs.GetNumDimensions()) +
-                                 ") do not match");
-    }
-
-    double result = 0;
-    for (auto i = 0; i < rhs.GetNumDimensions(); ++i) {
-      result += (rhs[i] * lhs[i]);
-    }
-    return result;
+    CheckSameDimensions(rhs, lhs).ThrowIfError();
+    return ev::kernels::Dot(rhs.data(), lhs.data(), rhs.GetNumDimensions());
   }
 
   /*
@@ -252,9 +331,7 @@ class EuclideanVector {
    */
   friend EuclideanVector operator*(const EuclideanVector& rhs, double scalar) noexcept {
     EuclideanVector result(rhs);
-    for (auto i = 0; i < rhs.GetNumDimensions(); ++i) {
-      result[i] *= scalar;
-    }
+    result *= scalar;
     return result;
   }
 
@@ -263,9 +340,7 @@ class EuclideanVector {
    */
   friend EuclideanVector operator*(double scalar, const EuclideanVector& rhs) noexcept {
     EuclideanVector result(rhs);
-    for (auto i = 0; i < rhs.GetNumDimensions(); ++i) {
-      result[i] = result[i] * scalar;
-    }
+    result *= scalar;
     return result;
   }
 
@@ -275,20 +350,149 @@ class EuclideanVector {
    *  Throw: "Invalid vector division by 0"
    */
   friend EuclideanVector operator/(const EuclideanVector& rhs, double scalar) {
-    if (scalar == 0) {
-      throw EuclideanVectorError("Invalid vector division by 0");
+    EuclideanVector result(rhs);
+    result /= scalar;
+    return result;
+  }
+
+  /*
+   * Element-wise (Hadamard) product and quotient of vectors of the same dimension. Dividing by a
+   * magnitude of 0 follows IEEE arithmetic rather than throwing.
+   * Given: X = a.GetNumDimensions(), Y = b.GetNumDimensions()
+   * When: X != Y
+   * Throw: "Dimensions of LHS(X) and RHS(Y) do not match"
+   */
+  friend EuclideanVector ElementwiseMultiply(const EuclideanVector& rhs,
+                                             const EuclideanVector& lhs) {
+    CheckSameDimensions(rhs, lhs).ThrowIfError();
+    EuclideanVector result(rhs);
+    ev::kernels::Multiply(result.data(), lhs.data(), rhs.GetPaddedDimensions());
+    return result;
+  }
+
+  friend EuclideanVector ElementwiseDivide(const EuclideanVector& rhs, const EuclideanVector& lhs) {
+    CheckSameDimensions(rhs, lhs).ThrowIfError();
+    EuclideanVector result(rhs);
+    ev::kernels::DivideElements(result.data(), lhs.data(), rhs.GetNumDimensions());
+    return result;
+  }
+
+  /*
+   * True if the two vectors are equal in the number of dimensions and, in each dimension,
+   *   |x - y| <= max(abs_tol, rel_tol * max(|x|, |y|))
+   * as Python's math.isclose. NaN is close to nothing, and an infinity only to itself.
+   * When: abs_tol or rel_tol is negative or NaN
+   * Throw: "Tolerances of ApproxEqual must be non-negative"
+   */
+  friend bool ApproxEqual(const EuclideanVector& rhs,
+                          const EuclideanVector& lhs,
+                          double abs_tol = 0,
+                          double rel_tol = 1e-9) {
+    if (!(abs_tol >= 0) || !(rel_tol >= 0)) {
+      EuclideanVectorStatus(EuclideanVectorErrc::kNegativeTolerance).ThrowIfError();
     }
+    return rhs.GetNumDimensions() == lhs.GetNumDimensions() &&
+           ev::kernels::ApproxEqual(rhs.data(), lhs.data(), rhs.GetNumDimensions(), abs_tol,
+                                    rel_tol);
+  }
+
+  /*
+   * Non-throwing versions of the friend operators above; see TryAddAssign.
+   */
+  friend EuclideanVectorResult<EuclideanVector> TryAdd(const EuclideanVector& rhs,
+                                                       const EuclideanVector& lhs) noexcept {
+    if (auto status = CheckSameDimensions(rhs, lhs); !status) {
+      return status;
+    }
+    EuclideanVector result(rhs);
+    ev::kernels::Add(result.data(), lhs.data(), rhs.GetPaddedDimensions());
+    return result;
+  }
 
+  friend EuclideanVectorResult<EuclideanVector> TrySubtract(const EuclideanVector& rhs,
+                                                            const EuclideanVector& lhs) noexcept {
+    if (auto status = CheckSameDimensions(rhs, lhs); !status) {
+      return status;
+    }
     EuclideanVector result(rhs);
-    for (auto i = 0; i < rhs.GetNumDimensions(); ++i) {
-      result[i] = result[i] / scalar;
+    ev::kernels::Sub(result.data(), lhs.data(), rhs.GetPaddedDimensions());
+    return result;
+  }
+
+  friend EuclideanVectorResult<double> TryDot(const EuclideanVector& rhs,
+                                              const EuclideanVector& lhs) noexcept {
+    if (auto status = CheckSameDimensions(rhs, lhs); !status) {
+      return status;
     }
+    return ev::kernels::Dot(rhs.data(), lhs.data(), rhs.GetNumDimensions());
+  }
+
+  friend EuclideanVectorResult<EuclideanVector> TryDivide(const EuclideanVector& rhs,
+                                                          double scalar) noexcept {
+    if (scalar == 0) {
+      return EuclideanVectorStatus(EuclideanVectorErrc::kDivisionByZero);
+    }
+    EuclideanVector result(rhs);
+    ev::kernels::Divide(result.data(), scalar, result.KernelLength(std::isfinite(scalar)));
     return result;
   }
 
  private:
-  std::unique_ptr<double[]> magnitudes_;
+  static EuclideanVectorStatus CheckSameDimensions(const EuclideanVector& lhs,
+                                                   const EuclideanVector& rhs) noexcept {
+    if (lhs.GetNumDimensions() != rhs.GetNumDimensions()) {
+      return EuclideanVectorStatus(EuclideanVectorErrc::kDimensionMismatch,
+                                   lhs.GetNumDimensions(), rhs.GetNumDimensions());
+    }
+    return EuclideanVectorStatus();
+  }
+
+  EuclideanVectorStatus CheckNotEmpty(EuclideanVectorErrc code) const noexcept {
+    if (GetNumDimensions() == 0) {
+      return EuclideanVectorStatus(code);
+    }
+    return EuclideanVectorStatus();
+  }
+
+  // Number of doubles an element-wise kernel runs over: all of GetPaddedDimensions() when the
+  // operation maps 0 to 0, which keeps the padding 0 and skips the kernel's scalar tail, else
+  // only the magnitudes. Scaling by a scalar that is not finite would turn the padding into NaN.
+  int KernelLength(bool keeps_zero) const noexcept {
+    return keeps_zero ? GetPaddedDimensions() : num_dimension_;
+  }
+
+  // Sets the padding after the magnitudes to 0; buffers from the pool come uninitialised.
+  void ZeroPadding() noexcept {
+    for (auto i = num_dimension_ < 0 ? 0 : num_dimension_; i < GetPaddedDimensions(); ++i) {
+      magnitudes_[i] = 0.0;
+    }
+  }
+
+  EuclideanVectorStatus CheckIndex(int i) const noexcept {
+    if (i < 0 || i >= GetNumDimensions()) {
+      return EuclideanVectorStatus(EuclideanVectorErrc::kInvalidIndex, i);
+    }
+    return EuclideanVectorStatus();
+  }
+
+  // Cache-line aligned, from the vector pool (see vector_pool.h).
+  ev::detail::VectorBuffer magnitudes_;
   int num_dimension_;
 };
 
+/*
+ * Hashes the number of dimensions and the magnitudes (ev::kernels::Hash), so vectors can be kept
+ * in unordered containers. Equal vectors hash alike, 0 and -0 included.
+ */
+namespace std {
+
+template <>
+struct hash<EuclideanVector> {
+  std::size_t operator()(const EuclideanVector& v) const noexcept {
+    return static_cast<std::size_t>(ev::kernels::Hash(v.data(), v.GetNumDimensions()));
+  }
+};
+
+}  // namespace std
+
 #endif  // ASSIGNMENTS_EV_EUCLIDEAN_VECTOR_H_
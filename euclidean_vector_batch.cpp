@@ -0,0 +1,108 @@
+#include "assignments/ev/euclidean_vector_batch.h"
+
+#include <algorithm>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "assignments/ev/aligned_buffer.h"
+#include "assignments/ev/euclidean_vector.h"
+
+namespace ev::detail {
+
+int CommonDimension(const std::vector<EuclideanVector>& vectors) {
+  if (vectors.empty()) {
+    return 0;
+  }
+  const auto dimension = vectors.front().GetNumDimensions();
+  for (const auto& v : vectors) {
+    if (v.GetNumDimensions() != dimension) {
+      throw EuclideanVectorError("Dimensions of LHS(" + std::to_string(dimension) + ") and RHS(" +
+                                 std::to_string(v.GetNumDimensions()) + ") do not match");
+    }
+  }
+  return dimension;
+}
+
+}  // namespace ev::detail
+
+// Constructors
+EuclideanVectorBatch::EuclideanVectorBatch(int num_vectors, int num_dimensions)
+  : data_{ev::detail::AllocateAligned(static_cast<std::size_t>(num_vectors) *
+                                      ev::detail::CheckedPadToCacheLine(num_dimensions))},
+    num_vectors_{num_vectors}, num_dimensions_{num_dimensions},
+    stride_{static_cast<int>(ev::detail::PadToCacheLine(num_dimensions))} {}
+
+EuclideanVectorBatch::EuclideanVectorBatch(const std::vector<EuclideanVector>& vectors)
+  : EuclideanVectorBatch(static_cast<int>(vectors.size()), ev::detail::CommonDimension(vectors)) {
+  for (auto i = 0; i < num_vectors_; ++i) {
+    std::copy(vectors[i].data(), vectors[i].data() + num_dimensions_, Row(i));
+  }
+}
+
+EuclideanVectorBatch::EuclideanVectorBatch(const EuclideanVectorBatch& batch)
+  : EuclideanVectorBatch(batch.num_vectors_, batch.num_dimensions_) {
+  std::copy(batch.data_.get(), batch.data_.get() + static_cast<long>(num_vectors_) * stride_,
+            data_.get());
+}
+
+EuclideanVectorBatch::EuclideanVectorBatch(EuclideanVectorBatch&& batch) noexcept
+  : data_{std::move(batch.data_)}, num_vectors_{batch.num_vectors_},
+    num_dimensions_{batch.num_dimensions_}, stride_{batch.stride_} {
+  batch.num_vectors_ = 0;
+  batch.num_dimensions_ = 0;
+  batch.stride_ = 0;
+}
+
+// Assignment
+EuclideanVectorBatch& EuclideanVectorBatch::operator=(const EuclideanVectorBatch& o) {
+  if (this != &o) {
+    *this = EuclideanVectorBatch(o);
+  }
+  return *this;
+}
+
+EuclideanVectorBatch& EuclideanVectorBatch::operator=(EuclideanVectorBatch&& o) noexcept {
+  data_ = std::move(o.data_);
+  num_vectors_ = o.num_vectors_;
+  num_dimensions_ = o.num_dimensions_;
+  stride_ = o.stride_;
+  o.num_vectors_ = 0;
+  o.num_dimensions_ = 0;
+  o.stride_ = 0;
+  return *this;
+}
+
+// Row access
+EuclideanVector EuclideanVectorBatch::GetVector(int i) const {
+  CheckIndex(i);
+  EuclideanVector result(num_dimensions_);
+  std::copy(Row(i), Row(i) + num_dimensions_, result.data());
+  return result;
+}
+
+void EuclideanVectorBatch::SetVector(int i, const EuclideanVector& vector) {
+  CheckIndex(i);
+  if (vector.GetNumDimensions() != num_dimensions_) {
+    throw EuclideanVectorError("Dimensions of LHS(" + std::to_string(num_dimensions_) +
+                               ") and RHS(" + std::to_string(vector.GetNumDimensions()) +
+                               ") do not match");
+  }
+  std::copy(vector.data(), vector.data() + num_dimensions_, Row(i));
+}
+
+std::vector<EuclideanVector> EuclideanVectorBatch::ToVectors() const {
+  std::vector<EuclideanVector> result;
+  result.reserve(num_vectors_);
+  for (auto i = 0; i < num_vectors_; ++i) {
+    result.push_back(GetVector(i));
+  }
+  return result;
+}
+
+void EuclideanVectorBatch::CheckIndex(int i) const {
+  if (i < 0 || i >= num_vectors_) {
+    throw EuclideanVectorError(std::string("Index ") + std::to_string(i) +
+                               std::string(" is not valid for this EuclideanVectorBatch object"));
+  }
+}
@@ -0,0 +1,101 @@
+#ifndef ASSIGNMENTS_EV_EUCLIDEAN_VECTOR_BATCH_H_
+#define ASSIGNMENTS_EV_EUCLIDEAN_VECTOR_BATCH_H_
+
+#include <vector>
+
+#include "assignments/ev/aligned_buffer.h"
+#include "assignments/ev/euclidean_vector.h"
+
+/*
+ * A fixed number of EuclideanVectors of the same dimension stored contiguously, one row per
+ * vector. Every row starts on a cache line and is padded with zeros up to GetStride() doubles, so
+ * a scan over the batch is a single linear walk through memory rather than one pointer chase per
+ * vector.
+ */
+class EuclideanVectorBatch {
+ public:
+  EuclideanVectorBatch() noexcept : EuclideanVectorBatch(0, 0) {}
+
+  /*
+   * A constructor that takes the number of vectors and the number of dimensions of each vector,
+   * and sets every magnitude to 0.0.
+   */
+  EuclideanVectorBatch(int num_vectors, int num_dimensions);
+
+  /*
+   * A constructor that copies a collection of EuclideanVectors into contiguous storage.
+   * When: the vectors do not all have the same number of dimensions
+   * Throw: "Dimensions of LHS(X) and RHS(Y) do not match"
+   */
+  explicit EuclideanVectorBatch(const std::vector<EuclideanVector>& vectors);
+
+  EuclideanVectorBatch(const EuclideanVectorBatch& batch);
+  EuclideanVectorBatch(EuclideanVectorBatch&& batch) noexcept;
+  ~EuclideanVectorBatch() noexcept = default;
+
+  EuclideanVectorBatch& operator=(const EuclideanVectorBatch& o);
+  EuclideanVectorBatch& operator=(EuclideanVectorBatch&& o) noexcept;
+
+  /*
+   * Number of vectors (rows) in the batch.
+   */
+  int GetNumVectors() const noexcept { return num_vectors_; }
+
+  /*
+   * Number of dimensions of every vector in the batch.
+   */
+  int GetNumDimensions() const noexcept { return num_dimensions_; }
+
+  /*
+   * Distance, in doubles, between the starts of two consecutive rows.
+   */
+  int GetStride() const noexcept { return stride_; }
+
+  /*
+   * Returns a pointer to the magnitudes of the i-th vector. No bounds checking.
+   */
+  const double* Row(int i) const noexcept { return data_.get() + static_cast<long>(i) * stride_; }
+  double* Row(int i) noexcept { return data_.get() + static_cast<long>(i) * stride_; }
+
+  /*
+   * Returns a copy of the i-th vector.
+   * When: For Input X: when X is < 0 or X is >= number of vectors
+   * Throw: "Index X is not valid for this EuclideanVectorBatch object"
+   */
+  EuclideanVector GetVector(int i) const;
+
+  /*
+   * Overwrites the i-th vector.
+   * When: For Input X: when X is < 0 or X is >= number of vectors
+   * Throw: "Index X is not valid for this EuclideanVectorBatch object"
+   * When: the vector does not have GetNumDimensions() dimensions
+   * Throw: "Dimensions of LHS(X) and RHS(Y) do not match"
+   */
+  void SetVector(int i, const EuclideanVector& vector);
+
+  /*
+   * Copies every row back out into individual EuclideanVectors.
+   */
+  std::vector<EuclideanVector> ToVectors() const;
+
+ private:
+  void CheckIndex(int i) const;
+
+  ev::detail::AlignedDoubleBuffer data_;
+  int num_vectors_;
+  int num_dimensions_;
+  int stride_;
+};
+
+namespace ev::detail {
+
+/*
+ * Returns the number of dimensions shared by all the vectors, or 0 for an empty collection.
+ * When: the vectors do not all have the same number of dimensions
+ * Throw: "Dimensions of LHS(X) and RHS(Y) do not match"
+ */
+int CommonDimension(const std::vector<EuclideanVector>& vectors);
+
+}  // namespace ev::detail
+
+#endif  // ASSIGNMENTS_EV_EUCLIDEAN_VECTOR_BATCH_H_
@@ -0,0 +1,104 @@
+/*
+
+  == Explanation and rational of testing ==
+
+  The batch is a storage type, so we test that what goes in comes back out unchanged: through the
+  constructors, the row pointers and GetVector/SetVector. We also check the layout promises made
+  in the header (aligned, padded rows) and the exceptions thrown on bad input.
+
+*/
+
+#include "assignments/ev/euclidean_vector_batch.h"
+
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+#include "catch.h"
+
+TEST_CASE("Euclidean Vector Batch Constructor Using Sizes") {
+  EuclideanVectorBatch a(3, 5);
+
+  SECTION("Batch constructed has the right size") {
+    REQUIRE(a.GetNumVectors() == 3);
+    REQUIRE(a.GetNumDimensions() == 5);
+    REQUIRE(a.GetStride() >= 5);
+  }
+
+  SECTION("Batch contains the right constant 0.0") {
+    for (auto i = 0; i < a.GetNumVectors(); ++i) {
+      for (auto j = 0; j < a.GetNumDimensions(); ++j) {
+        REQUIRE(a.Row(i)[j] == 0.0);
+      }
+    }
+  }
+
+  SECTION("Every row starts on a cache line") {
+    for (auto i = 0; i < a.GetNumVectors(); ++i) {
+      REQUIRE(reinterpret_cast<std::uintptr_t>(a.Row(i)) % 64 == 0);
+    }
+  }
+}
+
+TEST_CASE("Euclidean Vector Batch Constructor Using a STD Vector of Euclidean Vectors") {
+  std::vector<double> l1{1, 2, 3};
+  std::vector<double> l2{4, 5, 6};
+  std::vector<EuclideanVector> vectors{EuclideanVector{l1.begin(), l1.end()},
+                                       EuclideanVector{l2.begin(), l2.end()}};
+
+  SECTION("TEST CASE 1 Batch contains the right content") {
+    EuclideanVectorBatch a(vectors);
+    REQUIRE(a.GetNumVectors() == 2);
+    REQUIRE(a.GetNumDimensions() == 3);
+    REQUIRE(a.GetVector(0) == vectors[0]);
+    REQUIRE(a.GetVector(1) == vectors[1]);
+  }
+
+  SECTION("TEST CASE 2 ToVectors gives back the original vectors") {
+    EuclideanVectorBatch a(vectors);
+    REQUIRE(a.ToVectors() == vectors);
+  }
+
+  SECTION("TEST CASE 3 Exception will be thrown when dimensions differ") {
+    vectors.push_back(EuclideanVector(2));
+    REQUIRE_THROWS_WITH(EuclideanVectorBatch(vectors), Catch::Contains("Dimensions of LHS"));
+  }
+}
+
+TEST_CASE("Euclidean Vector Batch Copying and Moving") {
+  EuclideanVectorBatch a(2, 3);
+  a.SetVector(1, EuclideanVector(3, 7.0));
+
+  SECTION("TEST CASE 1 Copy has the same content and the original is unchanged") {
+    EuclideanVectorBatch b = a;
+    REQUIRE(b.GetVector(1) == EuclideanVector(3, 7.0));
+    REQUIRE(a.GetVector(1) == EuclideanVector(3, 7.0));
+    REQUIRE(b.Row(0) != a.Row(0));
+  }
+
+  SECTION("TEST CASE 2 Moved from batch is now empty") {
+    EuclideanVectorBatch b = std::move(a);
+    REQUIRE(b.GetVector(1) == EuclideanVector(3, 7.0));
+    REQUIRE(a.GetNumVectors() == 0);
+    REQUIRE(a.GetNumDimensions() == 0);
+  }
+}
+
+TEST_CASE("Euclidean Vector Batch GetVector and SetVector") {
+  EuclideanVectorBatch a(2, 3);
+
+  SECTION("TEST CASE 1 SetVector only changes the given row") {
+    a.SetVector(0, EuclideanVector(3, 1.5));
+    REQUIRE(a.GetVector(0) == EuclideanVector(3, 1.5));
+    REQUIRE(a.GetVector(1) == EuclideanVector(3, 0.0));
+  }
+
+  SECTION("TEST CASE 2 Exception will be thrown when index is out of range") {
+    REQUIRE_THROWS_WITH(a.GetVector(2), Catch::Contains("Index 2 is not valid"));
+    REQUIRE_THROWS_WITH(a.SetVector(-1, EuclideanVector(3)), Catch::Contains("Index -1"));
+  }
+
+  SECTION("TEST CASE 3 Exception will be thrown when dimensions differ") {
+    REQUIRE_THROWS_WITH(a.SetVector(0, EuclideanVector(4)), Catch::Contains("Dimensions of LHS"));
+  }
+}
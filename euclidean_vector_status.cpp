@@ -0,0 +1,34 @@
+#include "assignments/ev/euclidean_vector_status.h"
+
+#include <string>
+
+std::string EuclideanVectorStatus::GetMessage() const {
+  switch (code_) {
+  case EuclideanVectorErrc::kOk: return "";
+  case EuclideanVectorErrc::kDimensionMismatch:
+    return "Dimensions of LHS(" + std::to_string(x_) + ") and RHS(" + std::to_string(y_) +
+           ") do not match";
+  case EuclideanVectorErrc::kInvalidIndex:
+    return "Index " + std::to_string(x_) + " is not valid for this EuclideanVector object";
+  case EuclideanVectorErrc::kDivisionByZero: return "Invalid vector division by 0";
+  case EuclideanVectorErrc::kNoDimensionsNorm:
+    return "EuclideanVector with no dimensions does not have a norm";
+  case EuclideanVectorErrc::kNoDimensionsUnitVector:
+    return "EuclideanVector with no dimensions does not have a unit vector";
+  case EuclideanVectorErrc::kZeroNormUnitVector:
+    return "EuclideanVector with euclidean normal of 0 does not have a unit vector";
+  case EuclideanVectorErrc::kNoDimensionsExtremum:
+    return "EuclideanVector with no dimensions does not have a minimum or maximum";
+  case EuclideanVectorErrc::kInvalidNormOrder:
+    return "The p-norm of an EuclideanVector needs p >= 1";
+  case EuclideanVectorErrc::kEmptyClampRange:
+    return "Cannot clamp an EuclideanVector to an empty range";
+  case EuclideanVectorErrc::kNegativeTolerance:
+    return "Tolerances of ApproxEqual must be non-negative";
+  }
+  return "";
+}
+
+void EuclideanVectorStatus::Throw() const {
+  throw EuclideanVectorError(GetMessage());
+}
@@ -0,0 +1,117 @@
+#ifndef ASSIGNMENTS_EV_EUCLIDEAN_VECTOR_STATUS_H_
+#define ASSIGNMENTS_EV_EUCLIDEAN_VECTOR_STATUS_H_
+
+#include <exception>
+#include <optional>
+#include <string>
+#include <utility>
+
+class EuclideanVectorError : public std::exception {
+ public:
+  explicit EuclideanVectorError(const std::string& what) : what_(what) {}
+  const char* what() const noexcept { return what_.c_str(); }
+
+ private:
+  std::string what_;
+};
+
+enum class EuclideanVectorErrc {
+  kOk,
+  // "Dimensions of LHS(X) and RHS(Y) do not match"
+  kDimensionMismatch,
+  // "Index X is not valid for this EuclideanVector object"
+  kInvalidIndex,
+  // "Invalid vector division by 0"
+  kDivisionByZero,
+  // "EuclideanVector with no dimensions does not have a norm"
+  kNoDimensionsNorm,
+  // "EuclideanVector with no dimensions does not have a unit vector"
+  kNoDimensionsUnitVector,
+  // "EuclideanVector with euclidean normal of 0 does not have a unit vector"
+  kZeroNormUnitVector,
+  // "EuclideanVector with no dimensions does not have a minimum or maximum"
+  kNoDimensionsExtremum,
+  // "The p-norm of an EuclideanVector needs p >= 1"
+  kInvalidNormOrder,
+  // "Cannot clamp an EuclideanVector to an empty range"
+  kEmptyClampRange,
+  // "Tolerances of ApproxEqual must be non-negative"
+  kNegativeTolerance,
+};
+
+/*
+ * Outcome of a non-throwing EuclideanVector operation. Only the error code and the (at most two)
+ * integers needed to describe it are stored; the message is formatted when GetMessage() is
+ * called, so rejecting bad input costs no allocation.
+ */
+class EuclideanVectorStatus {
+ public:
+  constexpr EuclideanVectorStatus() noexcept = default;
+  constexpr explicit EuclideanVectorStatus(EuclideanVectorErrc code, int x = 0, int y = 0) noexcept
+    : code_{code}, x_{x}, y_{y} {}
+
+  constexpr bool IsOk() const noexcept { return code_ == EuclideanVectorErrc::kOk; }
+  constexpr explicit operator bool() const noexcept { return IsOk(); }
+  constexpr EuclideanVectorErrc GetCode() const noexcept { return code_; }
+
+  /*
+   * Returns the message the throwing operation would have thrown, or "" when IsOk().
+   */
+  std::string GetMessage() const;
+
+  /*
+   * Throws EuclideanVectorError(GetMessage()) unless IsOk(). The throw itself lives out of line,
+   * so callers inline only the check.
+   */
+  void ThrowIfError() const {
+    if (!IsOk()) {
+      Throw();
+    }
+  }
+
+ private:
+  [[noreturn]] void Throw() const;
+
+  EuclideanVectorErrc code_ = EuclideanVectorErrc::kOk;
+  int x_ = 0;
+  int y_ = 0;
+};
+
+/*
+ * Either a value of type T or the EuclideanVectorStatus explaining why there is none.
+ */
+template <typename T>
+class EuclideanVectorResult {
+ public:
+  EuclideanVectorResult(T value) noexcept : value_{std::move(value)} {}
+  EuclideanVectorResult(EuclideanVectorStatus status) noexcept : status_{status} {}
+
+  bool IsOk() const noexcept { return status_.IsOk(); }
+  explicit operator bool() const noexcept { return IsOk(); }
+  const EuclideanVectorStatus& GetStatus() const noexcept { return status_; }
+
+  /*
+   * Returns the value.
+   * When: !IsOk()
+   * Throw: the message of GetStatus()
+   */
+  const T& GetValue() const& {
+    status_.ThrowIfError();
+    return *value_;
+  }
+  T&& GetValue() && {
+    status_.ThrowIfError();
+    return std::move(*value_);
+  }
+
+  /*
+   * Returns the value, or fallback when !IsOk().
+   */
+  T GetValueOr(T fallback) const& { return IsOk() ? *value_ : std::move(fallback); }
+
+ private:
+  std::optional<T> value_;
+  EuclideanVectorStatus status_;
+};
+
+#endif  // ASSIGNMENTS_EV_EUCLIDEAN_VECTOR_STATUS_H_
@@ -15,9 +15,16 @@
 
 #include "assignments/ev/euclidean_vector.h"
 
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <new>
 #include <sstream>
+#include <unordered_set>
 #include <utility>
+#include <vector>
 
+#include "assignments/ev/vector_pool.h"
 #include "catch.h"
 
 TEST_CASE("Euclidean Vector Constructors Using Dimensionality and Constant") {
@@ -311,6 +318,18 @@ TEST_CASE("Overloading '+='") {
       REQUIRE(a.at(i) == constant);
     }
   }
+
+  SECTION("TEST CASE 4 Euclidean vector b can be added to itself") {
+    std::vector<double> values(19);
+    for (auto i = 0; i < 19; ++i) {
+      values[i] = i - 7.5;
+    }
+    EuclideanVector b{values.begin(), values.end()};
+    b += b;
+    for (auto i = 0; i < b.GetNumDimensions(); ++i) {
+      REQUIRE(b.at(i) == 2 * values[i]);
+    }
+  }
 }
 
 TEST_CASE("Overloading '-='") {
@@ -386,6 +405,18 @@ TEST_CASE("Overloading '-='") {
       REQUIRE(a.at(i) == constant);
     }
   }
+
+  SECTION("TEST CASE 4 Euclidean vector b can be subtracted from itself") {
+    std::vector<double> values(19);
+    for (auto i = 0; i < 19; ++i) {
+      values[i] = i - 7.5;
+    }
+    EuclideanVector b{values.begin(), values.end()};
+    b -= b;
+    for (auto i = 0; i < b.GetNumDimensions(); ++i) {
+      REQUIRE(b.at(i) == 0.0);
+    }
+  }
 }
 
 TEST_CASE("Overloading '*='") {
@@ -1006,3 +1037,331 @@ TEST_CASE("Creating Unit Vector") {
         Catch::Contains("EuclideanVector with no dimensions does not have a unit vector"));
   }
 }
+
+TEST_CASE("Non-throwing operations report errors through a status") {
+  const double constant = 1.0;
+  const int numDim = 5;
+  EuclideanVector a(numDim, constant);
+  EuclideanVector c(numDim - 1, constant);
+
+  SECTION("TEST CASE 1 TryAdd, TrySubtract and TryDot succeed on matching dimensions") {
+    auto sum = TryAdd(a, a);
+    REQUIRE(sum.IsOk());
+    REQUIRE(sum.GetValue() == a + a);
+    REQUIRE(TrySubtract(a, a).GetValue() == a - a);
+    REQUIRE(TryDot(a, a).GetValue() == a * a);
+  }
+
+  SECTION("TEST CASE 2 TryAdd, TrySubtract and TryDot fail on different dimensions") {
+    auto sum = TryAdd(a, c);
+    REQUIRE_FALSE(sum.IsOk());
+    REQUIRE(sum.GetStatus().GetCode() == EuclideanVectorErrc::kDimensionMismatch);
+    REQUIRE(sum.GetStatus().GetMessage() == "Dimensions of LHS(5) and RHS(4) do not match");
+    REQUIRE_FALSE(TrySubtract(a, c));
+    REQUIRE(TryDot(a, c).GetValueOr(-1.0) == -1.0);
+    REQUIRE_THROWS_WITH(TryDot(a, c).GetValue(), Catch::Contains("Dimensions of LHS"));
+  }
+
+  SECTION("TEST CASE 3 In-place versions leave the vector unchanged on error") {
+    REQUIRE(a.TryAddAssign(a).IsOk());
+    REQUIRE(a == EuclideanVector(numDim, 2 * constant));
+    REQUIRE(a.TrySubtractAssign(c).GetCode() == EuclideanVectorErrc::kDimensionMismatch);
+    REQUIRE(a.TryDivideAssign(0).GetCode() == EuclideanVectorErrc::kDivisionByZero);
+    REQUIRE(a == EuclideanVector(numDim, 2 * constant));
+    REQUIRE(TryDivide(a, 0).GetStatus().GetMessage() == "Invalid vector division by 0");
+    REQUIRE(TryDivide(a, 2).GetValue() == EuclideanVector(numDim, constant));
+  }
+
+  SECTION("TEST CASE 4 TryAt and TrySet check the index") {
+    REQUIRE(a.TryAt(4).GetValue() == constant);
+    REQUIRE(a.TryAt(5).GetStatus().GetMessage() ==
+            "Index 5 is not valid for this EuclideanVector object");
+    REQUIRE(a.TrySet(0, 3.0).IsOk());
+    REQUIRE(a.at(0) == 3.0);
+    REQUIRE(a.TrySet(-1, 3.0).GetCode() == EuclideanVectorErrc::kInvalidIndex);
+  }
+
+  SECTION("TEST CASE 5 Norm and unit vector") {
+    EuclideanVector zero(numDim);
+    EuclideanVector empty(0);
+    REQUIRE(EuclideanVector(4, 1.0).TryGetEuclideanNorm().GetValue() == 2.0);
+    REQUIRE(empty.TryGetEuclideanNorm().GetStatus().GetCode() ==
+            EuclideanVectorErrc::kNoDimensionsNorm);
+    REQUIRE(EuclideanVector(4, 1.0).TryCreateUnitVector().GetValue() ==
+            EuclideanVector(4, 0.5));
+    REQUIRE(zero.TryCreateUnitVector().GetStatus().GetCode() ==
+            EuclideanVectorErrc::kZeroNormUnitVector);
+    REQUIRE(empty.TryCreateUnitVector().GetStatus().GetCode() ==
+            EuclideanVectorErrc::kNoDimensionsUnitVector);
+  }
+}
+
+TEST_CASE("Other norms") {
+  std::vector<double> l{3, -4, 0, 12};
+  EuclideanVector a{l.begin(), l.end()};
+
+  SECTION("TEST CASE 1 L1, L-infinity and p-norms") {
+    REQUIRE(a.GetL1Norm() == 19);
+    REQUIRE(a.GetLInfNorm() == 12);
+    REQUIRE(a.GetPNorm(1) == 19);
+    REQUIRE(a.GetPNorm(2) == 13);
+    REQUIRE(a.GetPNorm(std::numeric_limits<double>::infinity()) == 12);
+    REQUIRE(a.GetPNorm(3) == Approx(std::cbrt(27 + 64 + 1728)));
+  }
+
+  SECTION("TEST CASE 2 p-norms of huge and tiny magnitudes do not overflow or underflow") {
+    EuclideanVector huge(4, 1e300);
+    REQUIRE(huge.GetPNorm(4) == Approx(std::sqrt(2.0) * 1e300));
+    EuclideanVector tiny(4, 1e-300);
+    REQUIRE(tiny.GetPNorm(4) == Approx(std::sqrt(2.0) * 1e-300));
+    REQUIRE(EuclideanVector(3).GetPNorm(5) == 0);
+  }
+
+  SECTION("Exception will be thrown for no dimensions or p below 1") {
+    EuclideanVector b(0);
+    REQUIRE_THROWS_WITH(b.GetL1Norm(),
+                        Catch::Contains("EuclideanVector with no dimensions does not have a norm"));
+    REQUIRE_THROWS_WITH(b.GetLInfNorm(),
+                        Catch::Contains("EuclideanVector with no dimensions does not have a norm"));
+    REQUIRE_THROWS_WITH(b.GetPNorm(3),
+                        Catch::Contains("EuclideanVector with no dimensions does not have a norm"));
+    REQUIRE_THROWS_WITH(a.GetPNorm(0.5),
+                        Catch::Contains("The p-norm of an EuclideanVector needs p >= 1"));
+    REQUIRE_THROWS_WITH(a.GetPNorm(std::nan("")),
+                        Catch::Contains("The p-norm of an EuclideanVector needs p >= 1"));
+  }
+}
+
+TEST_CASE("Sum, minimum and maximum") {
+  std::vector<double> l{2, -7, 5, -7, 9, 1, 9};
+  EuclideanVector a{l.begin(), l.end()};
+
+  SECTION("TEST CASE 1 Values and the first dimension holding them") {
+    REQUIRE(a.Sum() == 12);
+    REQUIRE(a.Min() == -7);
+    REQUIRE(a.ArgMin() == 1);
+    REQUIRE(a.Max() == 9);
+    REQUIRE(a.ArgMax() == 4);
+    REQUIRE(EuclideanVector(0).Sum() == 0);
+  }
+
+  SECTION("TEST CASE 2 NaNs are skipped") {
+    a[0] = std::nan("");
+    REQUIRE(a.ArgMin() == 1);
+    REQUIRE(a.ArgMax() == 4);
+    REQUIRE(std::isnan(EuclideanVector(3, std::nan("")).Min()));
+  }
+
+  SECTION("Exception will be thrown if euclidean vector's dimension is zero") {
+    EuclideanVector b(0);
+    REQUIRE_THROWS_WITH(b.Min(), Catch::Contains("EuclideanVector with no dimensions does not "
+                                                 "have a minimum or maximum"));
+    REQUIRE_THROWS_WITH(b.ArgMax(), Catch::Contains("EuclideanVector with no dimensions does not "
+                                                    "have a minimum or maximum"));
+  }
+}
+
+TEST_CASE("Element-wise operations") {
+  std::vector<double> l{2, -6, 0.5, -1};
+  std::vector<double> m{4, 3, -2, 8};
+  EuclideanVector a{l.begin(), l.end()};
+  EuclideanVector b{m.begin(), m.end()};
+
+  SECTION("TEST CASE 1 Hadamard product and quotient") {
+    std::vector<double> product{8, -18, -1, -8};
+    std::vector<double> quotient{0.5, -2, -0.25, -0.125};
+    REQUIRE(ElementwiseMultiply(a, b) == EuclideanVector(product.begin(), product.end()));
+    REQUIRE(ElementwiseDivide(a, b) == EuclideanVector(quotient.begin(), quotient.end()));
+    REQUIRE(std::isinf(ElementwiseDivide(a, EuclideanVector(4))[0]));
+  }
+
+  SECTION("TEST CASE 2 Abs, Clamp and Transform work in place") {
+    std::vector<double> abs{2, 6, 0.5, 1};
+    std::vector<double> clamped{1, -1, 0.5, -1};
+    std::vector<double> squared{4, 36, 0.25, 1};
+    REQUIRE(EuclideanVector(a).Abs() == EuclideanVector(abs.begin(), abs.end()));
+    REQUIRE(EuclideanVector(a).Clamp(-1, 1) == EuclideanVector(clamped.begin(), clamped.end()));
+    auto c = a;
+    c.Transform([](double x) { return x * x; });
+    REQUIRE(c == EuclideanVector(squared.begin(), squared.end()));
+  }
+
+  SECTION("Exception will be thrown for different dimensions or an empty range") {
+    EuclideanVector c(3);
+    REQUIRE_THROWS_WITH(ElementwiseMultiply(a, c),
+                        Catch::Contains("Dimensions of LHS(4) and RHS(3) do not match"));
+    REQUIRE_THROWS_WITH(ElementwiseDivide(c, a),
+                        Catch::Contains("Dimensions of LHS(3) and RHS(4) do not match"));
+    REQUIRE_THROWS_WITH(a.Clamp(1, -1),
+                        Catch::Contains("Cannot clamp an EuclideanVector to an empty range"));
+    REQUIRE(a == EuclideanVector(l.begin(), l.end()));
+  }
+}
+
+TEST_CASE("Fused updates") {
+  std::vector<double> l{1, 2, -3, 4};
+  std::vector<double> m{8, -2, 5, 0};
+  EuclideanVector a{l.begin(), l.end()};
+  EuclideanVector x{m.begin(), m.end()};
+
+  SECTION("TEST CASE 1 Axpy, Axpby and Lerp update in place") {
+    std::vector<double> axpy{5, 1, -0.5, 4};
+    std::vector<double> axpby{-6, 6, -11, 8};
+    std::vector<double> lerp{4.5, 0, 1, 2};
+    REQUIRE(EuclideanVector(a).Axpy(0.5, x) == EuclideanVector(axpy.begin(), axpy.end()));
+    REQUIRE(EuclideanVector(a).Axpby(-1, x, 2) == EuclideanVector(axpby.begin(), axpby.end()));
+    REQUIRE(EuclideanVector(a).Lerp(x, 0.5) == EuclideanVector(lerp.begin(), lerp.end()));
+    REQUIRE(EuclideanVector(a).Lerp(x, 0) == a);
+    REQUIRE(EuclideanVector(a).Lerp(x, 1) == x);
+  }
+
+  SECTION("TEST CASE 2 Updates match the unfused operators") {
+    auto fused = a;
+    fused.Axpy(0.1, x).Axpy(0.1, x);
+    REQUIRE(fused[0] == Approx((a + x * 0.1 + x * 0.1)[0]));
+    REQUIRE(fused[2] == Approx((a + x * 0.1 + x * 0.1)[2]));
+  }
+
+  SECTION("TEST CASE 3 A vector can be updated with itself") {
+    std::vector<double> values(19);
+    for (auto i = 0; i < 19; ++i) {
+      values[i] = i - 7.5;
+    }
+    const EuclideanVector v{values.begin(), values.end()};
+    auto self = v;
+    REQUIRE(self.Axpy(2, self) == v * 3.0);
+    self = v;
+    REQUIRE(self.Axpby(2, self, 3) == v * 5.0);
+    self = v;
+    REQUIRE(self.Lerp(self, 0.3) == v);
+  }
+
+  SECTION("Exception will be thrown if the dimensions differ") {
+    EuclideanVector c(3);
+    REQUIRE_THROWS_WITH(a.Axpy(1, c),
+                        Catch::Contains("Dimensions of LHS(4) and RHS(3) do not match"));
+    REQUIRE_THROWS_WITH(a.Axpby(1, c, 1),
+                        Catch::Contains("Dimensions of LHS(4) and RHS(3) do not match"));
+    REQUIRE_THROWS_WITH(c.Lerp(a, 0.5),
+                        Catch::Contains("Dimensions of LHS(3) and RHS(4) do not match"));
+  }
+}
+
+TEST_CASE("Equality, approximate equality and hashing") {
+  std::vector<double> l{1, 0, -3, 4};
+  std::vector<double> m{1, -0.0, -3, 4};
+  EuclideanVector a{l.begin(), l.end()};
+  EuclideanVector b{m.begin(), m.end()};
+
+  SECTION("TEST CASE 1 Equality compares magnitudes as doubles") {
+    REQUIRE(a == b);
+    REQUIRE_FALSE(a != b);
+    REQUIRE(a != EuclideanVector(3));
+    auto c = a;
+    c[3] = std::nan("");
+    REQUIRE(c != c);
+    REQUIRE(EuclideanVector(0) == EuclideanVector(0));
+  }
+
+  SECTION("TEST CASE 2 ApproxEqual uses the larger of the two tolerances") {
+    auto c = a;
+    c[0] += 1e-12;
+    REQUIRE(ApproxEqual(a, c));
+    REQUIRE_FALSE(ApproxEqual(a, c, 0, 1e-13));
+    c[1] = 1e-12;
+    REQUIRE_FALSE(ApproxEqual(a, c));
+    REQUIRE(ApproxEqual(a, c, 1e-11));
+    REQUIRE_FALSE(ApproxEqual(a, EuclideanVector(3), 1, 1));
+  }
+
+  SECTION("TEST CASE 3 Equal vectors hash alike and deduplicate in an unordered_set") {
+    const std::hash<EuclideanVector> hash;
+    REQUIRE(hash(a) == hash(b));
+    REQUIRE(hash(a) != hash(a * 2.0));
+    REQUIRE(hash(EuclideanVector(2)) != hash(EuclideanVector(3)));
+    std::unordered_set<EuclideanVector> set{a, b, a * 2.0, EuclideanVector(4)};
+    REQUIRE(set.size() == 3);
+    REQUIRE(set.count(b * 2.0 / 2.0) == 1);
+    REQUIRE(set.count(a + a) == 1);
+    REQUIRE(set.count(a * 3.0) == 0);
+  }
+
+  SECTION("Exception will be thrown if a tolerance is negative") {
+    REQUIRE_THROWS_WITH(ApproxEqual(a, b, -1),
+                        Catch::Contains("Tolerances of ApproxEqual must be non-negative"));
+    REQUIRE_THROWS_WITH(ApproxEqual(a, b, 0, std::nan("")),
+                        Catch::Contains("Tolerances of ApproxEqual must be non-negative"));
+  }
+}
+
+TEST_CASE("Aligned and zero-padded storage") {
+  const auto require_zero_padding = [](const EuclideanVector& v) {
+    REQUIRE(reinterpret_cast<std::uintptr_t>(v.data()) % 64 == 0);
+    for (auto i = v.GetNumDimensions(); i < v.GetPaddedDimensions(); ++i) {
+      REQUIRE(v.data()[i] == 0.0);
+    }
+  };
+
+  SECTION("TEST CASE 1 Dimensions are padded to whole cache lines") {
+    REQUIRE(EuclideanVector(0).GetPaddedDimensions() == 0);
+    REQUIRE(EuclideanVector(1).GetPaddedDimensions() == 8);
+    REQUIRE(EuclideanVector(8).GetPaddedDimensions() == 8);
+    REQUIRE(EuclideanVector(9).GetPaddedDimensions() == 16);
+    for (auto n : {1, 3, 8, 9, 100}) {
+      require_zero_padding(EuclideanVector(n, 2.5));
+    }
+
+    // Near INT_MAX the padded size no longer fits an int, and allocating fails cleanly.
+    const auto max = std::numeric_limits<int>::max();
+    REQUIRE(ev::detail::PadToCacheLine(max) == std::int64_t{max} + 1);
+    REQUIRE(ev::detail::CheckedPadToCacheLine(ev::detail::kMaxPaddedCount) ==
+            ev::detail::kMaxPaddedCount);
+    REQUIRE_THROWS_AS(ev::detail::AllocateVectorBuffer(max - 3), std::bad_array_new_length);
+  }
+
+  SECTION("TEST CASE 2 Reused buffers get their padding cleared") {
+    VectorPoolOptions options;
+    options.enabled = true;
+    SetVectorPoolOptions(options);
+    const double* first;
+    {
+      const EuclideanVector dirty(16, 7.0);
+      first = dirty.data();
+    }
+    const EuclideanVector reused(10, 1.0);
+    const auto same_buffer = reused.data() == first;
+    SetVectorPoolOptions({});
+    REQUIRE(same_buffer);
+    require_zero_padding(reused);
+
+    EuclideanVector target(11, 3.0);
+    target = EuclideanVector(9, 1.0);
+    REQUIRE(target.Sum() == 9);
+    require_zero_padding(target);
+  }
+
+  SECTION("TEST CASE 3 Operations keep the padding 0") {
+    const std::vector<double> values{1, -2, 3, -4, 5};
+    EuclideanVector v(values.begin(), values.end());
+    const EuclideanVector w(5, 0.5);
+    v += w;
+    require_zero_padding(v);
+    v *= -2;
+    require_zero_padding(v);
+    require_zero_padding(v + w);
+    require_zero_padding(ElementwiseMultiply(v, w));
+    require_zero_padding(ElementwiseDivide(v, w));
+    require_zero_padding(v.CreateUnitVector());
+    auto clamped = v;
+    clamped.Clamp(1, 2);
+    require_zero_padding(clamped);
+    auto transformed = v;
+    transformed.Transform([](double x) { return x + 1; });
+    require_zero_padding(transformed);
+    v *= std::numeric_limits<double>::infinity();
+    REQUIRE(std::isinf(v[0]));
+    require_zero_padding(v);
+    v /= std::numeric_limits<double>::infinity();
+    require_zero_padding(v);
+  }
+}
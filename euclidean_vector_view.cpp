@@ -0,0 +1,217 @@
+#include "assignments/ev/euclidean_vector_view.h"
+
+#include <algorithm>
+#include <cmath>
+#include <string>
+#include <vector>
+
+#include "assignments/ev/euclidean_vector.h"
+#include "assignments/ev/euclidean_vector_status.h"
+#include "assignments/ev/kernels.h"
+
+namespace {
+
+void CheckSameDimensions(int lhs, int rhs) {
+  if (lhs != rhs) {
+    EuclideanVectorStatus(EuclideanVectorErrc::kDimensionMismatch, lhs, rhs).ThrowIfError();
+  }
+}
+
+}  // namespace
+
+// Constructors
+EuclideanVectorView::EuclideanVectorView(const EuclideanVector& vector)
+  : EuclideanVectorView(vector.data(), vector.GetNumDimensions()) {}
+
+EuclideanVectorView::EuclideanVectorView(const double* data, int size, int stride) {
+  Append({data, size, stride});
+}
+
+double EuclideanVectorView::operator[](int i) const noexcept {
+  for (const auto& segment : segments_) {
+    if (i < segment.size) {
+      return segment.data[static_cast<long>(i) * segment.stride];
+    }
+    i -= segment.size;
+  }
+  return 0.0;
+}
+
+double EuclideanVectorView::at(int i) const {
+  if (i < 0 || i >= num_dimensions_) {
+    throw EuclideanVectorError("Index " + std::to_string(i) +
+                               " is not valid for this EuclideanVectorView object");
+  }
+  return (*this)[i];
+}
+
+EuclideanVectorView EuclideanVectorView::Slice(int begin, int end) const {
+  if (begin < 0 || end > num_dimensions_ || begin > end) {
+    throw EuclideanVectorError("Cannot slice dimensions [" + std::to_string(begin) + ", " +
+                               std::to_string(end) + ") of a view with " +
+                               std::to_string(num_dimensions_) + " dimensions");
+  }
+  EuclideanVectorView result;
+  auto offset = 0;
+  for (const auto& segment : segments_) {
+    const auto lo = std::max(begin - offset, 0);
+    const auto hi = std::min(end - offset, segment.size);
+    if (lo < hi) {
+      result.Append({segment.data + static_cast<long>(lo) * segment.stride, hi - lo,
+                     segment.stride});
+    }
+    offset += segment.size;
+  }
+  return result;
+}
+
+EuclideanVectorView EuclideanVectorView::Stride(int step) const {
+  if (step <= 0) {
+    throw EuclideanVectorError("Cannot stride a view by " + std::to_string(step));
+  }
+  EuclideanVectorView result;
+  auto offset = 0;
+  for (const auto& segment : segments_) {
+    // The first dimension of the segment whose overall index is a multiple of step.
+    const auto first = (step - offset % step) % step;
+    if (first < segment.size) {
+      result.Append({segment.data + static_cast<long>(first) * segment.stride,
+                     (segment.size - first + step - 1) / step, segment.stride * step});
+    }
+    offset += segment.size;
+  }
+  return result;
+}
+
+EuclideanVectorView Concat(const EuclideanVectorView& lhs, const EuclideanVectorView& rhs) {
+  EuclideanVectorView result(lhs);
+  for (const auto& segment : rhs.segments_) {
+    result.Append(segment);
+  }
+  return result;
+}
+
+EuclideanVector EuclideanVectorView::ToVector() const {
+  EuclideanVector result(num_dimensions_);
+  auto* out = result.data();
+  for (const auto& segment : segments_) {
+    if (segment.stride == 1) {
+      std::copy(segment.data, segment.data + segment.size, out);
+    } else {
+      for (auto i = 0; i < segment.size; ++i) {
+        out[i] = segment.data[static_cast<long>(i) * segment.stride];
+      }
+    }
+    out += segment.size;
+  }
+  return result;
+}
+
+double EuclideanVectorView::GetEuclideanNorm() const {
+  if (num_dimensions_ == 0) {
+    EuclideanVectorStatus(EuclideanVectorErrc::kNoDimensionsNorm).ThrowIfError();
+  }
+  return std::sqrt(*this * *this);
+}
+
+template <typename Fn>
+void EuclideanVectorView::ForEachPiece(const EuclideanVectorView& lhs,
+                                       const EuclideanVectorView& rhs,
+                                       Fn fn) {
+  auto i = std::size_t{0};
+  auto j = std::size_t{0};
+  auto lhs_offset = 0;
+  auto rhs_offset = 0;
+  while (i < lhs.segments_.size() && j < rhs.segments_.size()) {
+    const auto& a = lhs.segments_[i];
+    const auto& b = rhs.segments_[j];
+    const auto size = std::min(a.size - lhs_offset, b.size - rhs_offset);
+    fn(Segment{a.data + static_cast<long>(lhs_offset) * a.stride, size, a.stride},
+       Segment{b.data + static_cast<long>(rhs_offset) * b.stride, size, b.stride});
+    lhs_offset += size;
+    rhs_offset += size;
+    if (lhs_offset == a.size) {
+      ++i;
+      lhs_offset = 0;
+    }
+    if (rhs_offset == b.size) {
+      ++j;
+      rhs_offset = 0;
+    }
+  }
+}
+
+double operator*(const EuclideanVectorView& lhs, const EuclideanVectorView& rhs) {
+  CheckSameDimensions(lhs.num_dimensions_, rhs.num_dimensions_);
+  auto sum = 0.0;
+  EuclideanVectorView::ForEachPiece(lhs, rhs, [&sum](const auto& a, const auto& b) {
+    if (a.stride == 1 && b.stride == 1) {
+      sum += ev::kernels::Dot(a.data, b.data, a.size);
+      return;
+    }
+    for (auto i = 0; i < a.size; ++i) {
+      sum += a.data[static_cast<long>(i) * a.stride] * b.data[static_cast<long>(i) * b.stride];
+    }
+  });
+  return sum;
+}
+
+EuclideanVector operator+(const EuclideanVectorView& lhs, const EuclideanVectorView& rhs) {
+  CheckSameDimensions(lhs.num_dimensions_, rhs.num_dimensions_);
+  auto result = lhs.ToVector();
+  auto* out = result.data();
+  for (const auto& segment : rhs.segments_) {
+    if (segment.stride == 1) {
+      ev::kernels::Add(out, segment.data, segment.size);
+    } else {
+      for (auto i = 0; i < segment.size; ++i) {
+        out[i] += segment.data[static_cast<long>(i) * segment.stride];
+      }
+    }
+    out += segment.size;
+  }
+  return result;
+}
+
+EuclideanVector operator-(const EuclideanVectorView& lhs, const EuclideanVectorView& rhs) {
+  CheckSameDimensions(lhs.num_dimensions_, rhs.num_dimensions_);
+  auto result = lhs.ToVector();
+  auto* out = result.data();
+  for (const auto& segment : rhs.segments_) {
+    if (segment.stride == 1) {
+      ev::kernels::Sub(out, segment.data, segment.size);
+    } else {
+      for (auto i = 0; i < segment.size; ++i) {
+        out[i] -= segment.data[static_cast<long>(i) * segment.stride];
+      }
+    }
+    out += segment.size;
+  }
+  return result;
+}
+
+EuclideanVector operator*(const EuclideanVectorView& lhs, double scalar) {
+  auto result = lhs.ToVector();
+  result *= scalar;
+  return result;
+}
+
+EuclideanVector operator*(double scalar, const EuclideanVectorView& rhs) {
+  return rhs * scalar;
+}
+
+EuclideanVector operator/(const EuclideanVectorView& lhs, double scalar) {
+  if (scalar == 0) {
+    EuclideanVectorStatus(EuclideanVectorErrc::kDivisionByZero).ThrowIfError();
+  }
+  auto result = lhs.ToVector();
+  result /= scalar;
+  return result;
+}
+
+void EuclideanVectorView::Append(const Segment& segment) {
+  if (segment.size > 0) {
+    segments_.push_back(segment);
+    num_dimensions_ += segment.size;
+  }
+}
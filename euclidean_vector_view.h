@@ -0,0 +1,125 @@
+#ifndef ASSIGNMENTS_EV_EUCLIDEAN_VECTOR_VIEW_H_
+#define ASSIGNMENTS_EV_EUCLIDEAN_VECTOR_VIEW_H_
+
+#include <vector>
+
+#include "assignments/ev/euclidean_vector.h"
+
+/*
+ * A read-only view of magnitudes owned by something else, such as an EuclideanVector or a row or
+ * column of an EuclideanVectorBatch. A view is a list of strided segments, so slicing, striding
+ * and concatenating views only rearranges segments and never copies magnitudes. Dot products,
+ * norms and arithmetic read straight through the segments; ToVector() copies the magnitudes out
+ * when an EuclideanVector is really needed.
+ *
+ * A view does not own its magnitudes: it must not outlive them, and it sees any later changes to
+ * them.
+ */
+class EuclideanVectorView {
+ public:
+  /*
+   * A view of the whole vector. Implicit, so an EuclideanVector can be passed wherever a view is
+   * expected.
+   */
+  EuclideanVectorView(const EuclideanVector& vector);
+
+  /*
+   * A view of size magnitudes starting at data, stride doubles apart. E.g. column j of a batch is
+   * EuclideanVectorView(batch.Row(0) + j, batch.GetNumVectors(), batch.GetStride()).
+   */
+  EuclideanVectorView(const double* data, int size, int stride = 1);
+
+  int GetNumDimensions() const noexcept { return num_dimensions_; }
+
+  /*
+   * Returns the magnitude in dimension i. No bounds checking.
+   */
+  double operator[](int i) const noexcept;
+
+  /*
+   * Returns the magnitude in dimension i.
+   * When: For Input X: when X is < 0 or X is >= number of dimensions
+   * Throw: "Index X is not valid for this EuclideanVectorView object"
+   */
+  double at(int i) const;
+
+  /*
+   * A view of dimensions [begin, end) of this view.
+   * When: begin < 0, end > GetNumDimensions() or begin > end
+   * Throw: "Cannot slice dimensions [B, E) of a view with N dimensions"
+   */
+  EuclideanVectorView Slice(int begin, int end) const;
+
+  /*
+   * A view of every step-th dimension of this view, starting with the first.
+   * When: step <= 0
+   * Throw: "Cannot stride a view by S"
+   */
+  EuclideanVectorView Stride(int step) const;
+
+  /*
+   * The view laid out after the other: lhs's dimensions followed by rhs's.
+   */
+  friend EuclideanVectorView Concat(const EuclideanVectorView& lhs,
+                                    const EuclideanVectorView& rhs);
+
+  /*
+   * Copies the viewed magnitudes into a new EuclideanVector.
+   */
+  EuclideanVector ToVector() const;
+
+  /*
+   * Euclidean norm of the viewed magnitudes.
+   * When: this->GetNumDimensions() == 0
+   * Throw: "EuclideanVector with no dimensions does not have a norm"
+   */
+  double GetEuclideanNorm() const;
+
+  /*
+   * Dot product of two views. Runs of dimensions that are contiguous in both go through
+   * ev::kernels::Dot.
+   * When: the views have a different number of dimensions
+   * Throw: "Dimensions of LHS(X) and RHS(Y) do not match"
+   */
+  friend double operator*(const EuclideanVectorView& lhs, const EuclideanVectorView& rhs);
+
+  /*
+   * Element-wise sum and difference, returned as a new EuclideanVector.
+   * When: the views have a different number of dimensions
+   * Throw: "Dimensions of LHS(X) and RHS(Y) do not match"
+   */
+  friend EuclideanVector operator+(const EuclideanVectorView& lhs, const EuclideanVectorView& rhs);
+  friend EuclideanVector operator-(const EuclideanVectorView& lhs, const EuclideanVectorView& rhs);
+
+  /*
+   * Scalar multiplication and division, returned as a new EuclideanVector.
+   * When: scalar == 0 (division only)
+   * Throw: "Invalid vector division by 0"
+   */
+  friend EuclideanVector operator*(const EuclideanVectorView& lhs, double scalar);
+  friend EuclideanVector operator*(double scalar, const EuclideanVectorView& rhs);
+  friend EuclideanVector operator/(const EuclideanVectorView& lhs, double scalar);
+
+ private:
+  // size magnitudes starting at data, stride doubles apart. Views never hold empty segments.
+  struct Segment {
+    const double* data;
+    int size;
+    int stride;
+  };
+
+  EuclideanVectorView() noexcept = default;
+  void Append(const Segment& segment);
+
+  // Calls fn(a, b) on matching pieces of lhs and rhs, in order; a and b have the same size.
+  template <typename Fn>
+  static void ForEachPiece(const EuclideanVectorView& lhs, const EuclideanVectorView& rhs, Fn fn);
+
+  std::vector<Segment> segments_;
+  int num_dimensions_ = 0;
+};
+
+// Declared again outside the class so Concat(a, b) is found for two EuclideanVectors too.
+EuclideanVectorView Concat(const EuclideanVectorView& lhs, const EuclideanVectorView& rhs);
+
+#endif  // ASSIGNMENTS_EV_EUCLIDEAN_VECTOR_VIEW_H_
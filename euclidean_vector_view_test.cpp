@@ -0,0 +1,165 @@
+/*
+
+  == Explanation and rational of testing ==
+
+  Every view is checked against the same magnitudes copied out by hand into an EuclideanVector,
+  so each view operation is compared with the EuclideanVector operation it stands in for. Views
+  are built up from slices, strides and concatenations in several orders, with segment
+  boundaries that fall inside slices and strides. A view of one contiguous run goes through the
+  same kernel as an EuclideanVector and must match it exactly; other views are summed in pieces
+  and match up to rounding. Views of batch columns, and seeing later writes to the viewed
+  magnitudes, are tested next. The error cases are tested last.
+
+*/
+
+#include "assignments/ev/euclidean_vector_view.h"
+
+#include <vector>
+
+#include "assignments/ev/euclidean_vector.h"
+#include "assignments/ev/euclidean_vector_batch.h"
+#include "catch.h"
+
+namespace {
+
+// [start, start + 1, ..., start + n - 1] scaled down so dot products stay small.
+EuclideanVector MakeVector(int n, double start) {
+  EuclideanVector v(n);
+  for (auto i = 0; i < n; ++i) {
+    v[i] = (start + i) / 8;
+  }
+  return v;
+}
+
+// The magnitudes of v at the given indices, copied into a new EuclideanVector.
+EuclideanVector Pick(const EuclideanVector& v, const std::vector<int>& indices) {
+  std::vector<double> picked;
+  for (auto i : indices) {
+    picked.push_back(v[i]);
+  }
+  return EuclideanVector(picked.begin(), picked.end());
+}
+
+void RequireViewOf(const EuclideanVectorView& view, const EuclideanVector& expected) {
+  REQUIRE(view.GetNumDimensions() == expected.GetNumDimensions());
+  REQUIRE(view.ToVector() == expected);
+  for (auto i = 0; i < expected.GetNumDimensions(); ++i) {
+    REQUIRE(view[i] == expected[i]);
+    REQUIRE(view.at(i) == expected[i]);
+  }
+}
+
+}  // namespace
+
+TEST_CASE("Building views") {
+  const auto a = MakeVector(10, 0);
+  const auto b = MakeVector(7, 100);
+
+  SECTION("TEST CASE 1 - Slices and strides of one vector") {
+    const EuclideanVectorView view(a);
+    RequireViewOf(view, a);
+    RequireViewOf(view.Slice(2, 7), Pick(a, {2, 3, 4, 5, 6}));
+    RequireViewOf(view.Slice(4, 4), EuclideanVector(0));
+    RequireViewOf(view.Stride(3), Pick(a, {0, 3, 6, 9}));
+    RequireViewOf(view.Stride(20), Pick(a, {0}));
+    RequireViewOf(view.Slice(1, 9).Stride(2), Pick(a, {1, 3, 5, 7}));
+    RequireViewOf(view.Stride(2).Slice(1, 4), Pick(a, {2, 4, 6}));
+    RequireViewOf(view.Stride(2).Stride(2), Pick(a, {0, 4, 8}));
+  }
+
+  SECTION("TEST CASE 2 - Concatenations, and slices and strides across their joins") {
+    const auto ab = Concat(a, b);
+    auto joined = static_cast<std::vector<double>>(a);
+    const auto tail = static_cast<std::vector<double>>(b);
+    joined.insert(joined.end(), tail.begin(), tail.end());
+    const EuclideanVector expected(joined.begin(), joined.end());
+    RequireViewOf(ab, expected);
+    RequireViewOf(ab.Slice(8, 12), Pick(expected, {8, 9, 10, 11}));
+    RequireViewOf(ab.Stride(3), Pick(expected, {0, 3, 6, 9, 12, 15}));
+    RequireViewOf(ab.Stride(4).Slice(2, 4), Pick(expected, {8, 12}));
+    RequireViewOf(Concat(ab.Slice(12, 17), ab.Slice(0, 2)), Pick(expected, {12, 13, 14, 15, 16,
+                                                                            0, 1}));
+    RequireViewOf(Concat(EuclideanVector(0), b), b);
+  }
+
+  SECTION("TEST CASE 3 - Columns of a batch") {
+    EuclideanVectorBatch batch(5, 3);
+    for (auto i = 0; i < 5; ++i) {
+      batch.SetVector(i, MakeVector(3, 10 * i));
+    }
+    const EuclideanVectorView column(batch.Row(0) + 1, 5, batch.GetStride());
+    const std::vector<double> expected{1.0 / 8, 11.0 / 8, 21.0 / 8, 31.0 / 8, 41.0 / 8};
+    RequireViewOf(column, EuclideanVector(expected.begin(), expected.end()));
+  }
+}
+
+TEST_CASE("Arithmetic on views") {
+  const auto a = MakeVector(40, -13);
+  const auto b = MakeVector(60, 5);
+  const EuclideanVectorView va(a);
+  const EuclideanVectorView vb(b);
+
+  SECTION("TEST CASE 4 - One contiguous run matches EuclideanVector exactly") {
+    const auto x = vb.Slice(10, 50);
+    const auto copy = x.ToVector();
+    REQUIRE(va * x == a * copy);
+    REQUIRE(x.GetEuclideanNorm() == copy.GetEuclideanNorm());
+    REQUIRE(a + x == a + copy);
+    REQUIRE(x - a == copy - a);
+    REQUIRE(x * 2.5 == copy * 2.5);
+    REQUIRE(2.5 * x == 2.5 * copy);
+    REQUIRE(x / 4 == copy / 4);
+  }
+
+  SECTION("TEST CASE 5 - Strided and concatenated views match up to rounding") {
+    const auto x = Concat(vb.Stride(3), va.Slice(0, 20));
+    const auto y = Concat(va.Slice(5, 25).Stride(2), vb.Slice(0, 30));
+    REQUIRE(x.GetNumDimensions() == 40);
+    REQUIRE(y.GetNumDimensions() == 40);
+    const auto x_copy = x.ToVector();
+    const auto y_copy = y.ToVector();
+    REQUIRE(x * y == Approx(x_copy * y_copy));
+    REQUIRE(x * a == Approx(x_copy * a));
+    REQUIRE(x.GetEuclideanNorm() == Approx(x_copy.GetEuclideanNorm()));
+    REQUIRE(x + y == x_copy + y_copy);
+    REQUIRE(y - x == y_copy - x_copy);
+    REQUIRE(x * -1.0 == x_copy * -1.0);
+    REQUIRE(y / 3 == y_copy / 3);
+  }
+
+  SECTION("TEST CASE 6 - Views see later writes and mixing views with vectors") {
+    auto c = MakeVector(6, 0);
+    const auto head = EuclideanVectorView(c).Slice(0, 3);
+    c[1] = 42;
+    REQUIRE(head[1] == 42);
+    // EuclideanVector's own operators are still the ones picked for two vectors.
+    REQUIRE(c + c == c * 2.0);
+    REQUIRE(Concat(c, c).GetNumDimensions() == 12);
+  }
+}
+
+TEST_CASE("View errors") {
+  SECTION("TEST CASE 7 - Bad ranges, strides, indices and dimensions") {
+    const auto a = MakeVector(5, 1);
+    const EuclideanVectorView view(a);
+    REQUIRE_THROWS_WITH(view.Slice(3, 6),
+                        Catch::Contains("Cannot slice dimensions [3, 6) of a view with 5 "
+                                        "dimensions"));
+    REQUIRE_THROWS_WITH(view.Slice(-1, 2),
+                        Catch::Contains("Cannot slice dimensions [-1, 2) of a view with 5 "
+                                        "dimensions"));
+    REQUIRE_THROWS_WITH(view.Slice(3, 2),
+                        Catch::Contains("Cannot slice dimensions [3, 2) of a view with 5 "
+                                        "dimensions"));
+    REQUIRE_THROWS_WITH(view.Stride(0), Catch::Contains("Cannot stride a view by 0"));
+    REQUIRE_THROWS_WITH(
+        view.at(5), Catch::Contains("Index 5 is not valid for this EuclideanVectorView object"));
+    REQUIRE_THROWS_WITH(view.Slice(0, 4) * a,
+                        Catch::Contains("Dimensions of LHS(4) and RHS(5) do not match"));
+    REQUIRE_THROWS_WITH(a + view.Stride(2),
+                        Catch::Contains("Dimensions of LHS(5) and RHS(3) do not match"));
+    REQUIRE_THROWS_WITH(view / 0, Catch::Contains("Invalid vector division by 0"));
+    REQUIRE_THROWS_WITH(view.Slice(2, 2).GetEuclideanNorm(),
+                        Catch::Contains("EuclideanVector with no dimensions does not have a norm"));
+  }
+}
@@ -0,0 +1,69 @@
+#ifndef ASSIGNMENTS_EV_KERNEL_TABLE_H_
+#define ASSIGNMENTS_EV_KERNEL_TABLE_H_
+
+// The ISA-specific kernel builds only exist on x86; elsewhere only the scalar table is linked.
+#if defined(__x86_64__) || defined(__i386__)
+#define EV_KERNELS_X86 1
+#endif
+
+#include <cstdint>
+
+namespace ev::kernels::detail {
+
+/*
+ * One complete set of kernels compiled for a single instruction set level. See kernels.h for what
+ * each entry computes.
+ */
+struct KernelTable {
+  const char* name;
+  void (*add)(double*, const double*, int) noexcept;
+  void (*sub)(double*, const double*, int) noexcept;
+  void (*scale)(double*, double, int) noexcept;
+  void (*divide)(double*, double, int) noexcept;
+  void (*axpy)(double*, double, const double*, int) noexcept;
+  void (*min)(double*, const double*, int) noexcept;
+  void (*max)(double*, const double*, int) noexcept;
+  double (*dot)(const double*, const double*, int) noexcept;
+  double (*squared_l2)(const double*, const double*, int) noexcept;
+  double (*squared_l2_bounded)(const double*, const double*, int, double) noexcept;
+  void (*dot4)(const double*, const double* const*, int, double*) noexcept;
+  void (*axpy4)(double* const*, const double*, const double*, int) noexcept;
+  void (*dot_rows)(const double*, const double* const*, int, int, double*, int, bool) noexcept;
+  void (*squared_l2_rows)(const double*, const double* const*, int, int, double*, int,
+                          bool) noexcept;
+  int (*hamming)(const std::uint64_t*, const std::uint64_t*, int) noexcept;
+  void (*hamming_rows)(const std::uint64_t*, const std::uint64_t*, int, int, int*) noexcept;
+  std::int64_t (*dot_u8)(const std::uint8_t*, const std::uint8_t*, int) noexcept;
+  std::int64_t (*dot_i8)(const std::int8_t*, const std::int8_t*, int) noexcept;
+  double (*dot_f64_u8)(const double*, const std::uint8_t*, int) noexcept;
+  double (*dot_f64_i8)(const double*, const std::int8_t*, int) noexcept;
+  double (*sum)(const double*, int) noexcept;
+  double (*abs_sum)(const double*, int) noexcept;
+  double (*max_abs)(const double*, int) noexcept;
+  int (*arg_min)(const double*, int) noexcept;
+  int (*arg_max)(const double*, int) noexcept;
+  void (*multiply)(double*, const double*, int) noexcept;
+  void (*divide_elements)(double*, const double*, int) noexcept;
+  void (*abs)(double*, int) noexcept;
+  void (*clamp)(double*, double, double, int) noexcept;
+  void (*axpby)(double*, double, const double*, double, int) noexcept;
+  void (*lerp)(double*, const double*, double, int) noexcept;
+  void (*momentum_step)(double*, double*, const double*, double, double, int) noexcept;
+  void (*adam_step)(double*, double*, double*, const double*, double, double, double, double,
+                    int) noexcept;
+  bool (*equal)(const double*, const double*, int) noexcept;
+  bool (*approx_equal)(const double*, const double*, int, double, double) noexcept;
+  std::uint64_t (*hash)(const double*, int) noexcept;
+  void (*welford_step)(double*, double*, double*, const double*, double, int) noexcept;
+};
+
+const KernelTable& ScalarKernels() noexcept;
+#ifdef EV_KERNELS_X86
+const KernelTable& Sse42Kernels() noexcept;
+const KernelTable& Avx2Kernels() noexcept;
+const KernelTable& Avx512Kernels() noexcept;
+#endif
+
+}  // namespace ev::kernels::detail
+
+#endif  // ASSIGNMENTS_EV_KERNEL_TABLE_H_
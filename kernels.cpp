@@ -0,0 +1,277 @@
+#include "assignments/ev/kernels.h"
+
+#include <atomic>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+
+#include "assignments/ev/kernel_table.h"
+
+namespace ev::kernels {
+
+namespace {
+
+using detail::KernelTable;
+
+bool Supported(const KernelTable& table) noexcept {
+#ifdef EV_KERNELS_X86
+  if (&table == &detail::Sse42Kernels()) {
+    return __builtin_cpu_supports("sse4.2") && __builtin_cpu_supports("popcnt");
+  }
+  if (&table == &detail::Avx2Kernels()) {
+    return __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma") &&
+           __builtin_cpu_supports("popcnt");
+  }
+  if (&table == &detail::Avx512Kernels()) {
+    return __builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512dq") &&
+           __builtin_cpu_supports("avx512bw") && __builtin_cpu_supports("avx512vl") &&
+           __builtin_cpu_supports("popcnt");
+  }
+#endif
+  return true;
+}
+
+// Every table this build contains, from the most to the least capable.
+const KernelTable* const* Candidates() noexcept {
+#ifdef EV_KERNELS_X86
+  static const KernelTable* const candidates[] = {&detail::Avx512Kernels(),
+                                                  &detail::Avx2Kernels(),
+                                                  &detail::Sse42Kernels(),
+                                                  &detail::ScalarKernels(), nullptr};
+#else
+  static const KernelTable* const candidates[] = {&detail::ScalarKernels(), nullptr};
+#endif
+  return candidates;
+}
+
+// The best supported table, capped at EV_KERNEL_ISA when that names a known level.
+const KernelTable* Select() noexcept {
+  const auto* cap = std::getenv("EV_KERNEL_ISA");
+  auto capped = false;
+  for (auto* const* t = Candidates(); *t != nullptr; ++t) {
+    if (cap != nullptr && std::strcmp(cap, (*t)->name) == 0) {
+      capped = true;
+    }
+    if (capped && Supported(**t)) {
+      return *t;
+    }
+  }
+  for (auto* const* t = Candidates(); *t != nullptr; ++t) {
+    if (Supported(**t)) {
+      return *t;
+    }
+  }
+  return &detail::ScalarKernels();
+}
+
+std::atomic<const KernelTable*> active{nullptr};
+
+const KernelTable& Active() noexcept {
+  const auto* table = active.load(std::memory_order_acquire);
+  if (table == nullptr) {
+    // Racing first calls all select the same table, so whichever store lands is fine.
+    table = Select();
+    active.store(table, std::memory_order_release);
+  }
+  return *table;
+}
+
+}  // namespace
+
+void Add(double* dst, const double* src, int n) noexcept {
+  Active().add(dst, src, n);
+}
+
+void Sub(double* dst, const double* src, int n) noexcept {
+  Active().sub(dst, src, n);
+}
+
+void Scale(double* dst, double alpha, int n) noexcept {
+  Active().scale(dst, alpha, n);
+}
+
+void Divide(double* dst, double divisor, int n) noexcept {
+  Active().divide(dst, divisor, n);
+}
+
+void Axpy(double* dst, double alpha, const double* src, int n) noexcept {
+  Active().axpy(dst, alpha, src, n);
+}
+
+void Min(double* dst, const double* src, int n) noexcept {
+  Active().min(dst, src, n);
+}
+
+void Max(double* dst, const double* src, int n) noexcept {
+  Active().max(dst, src, n);
+}
+
+double Dot(const double* a, const double* b, int n) noexcept {
+  return Active().dot(a, b, n);
+}
+
+double SquaredL2(const double* a, const double* b, int n) noexcept {
+  return Active().squared_l2(a, b, n);
+}
+
+double SquaredL2Bounded(const double* a, const double* b, int n, double bound) noexcept {
+  return Active().squared_l2_bounded(a, b, n, bound);
+}
+
+void Dot4(const double* x, const double* const* y, int n, double* out) noexcept {
+  Active().dot4(x, y, n, out);
+}
+
+void Axpy4(double* const* c, const double* alpha, const double* b, int n) noexcept {
+  Active().axpy4(c, alpha, b, n);
+}
+
+void DotRows(const double* x,
+             const double* const* rows,
+             int n,
+             int count,
+             double* out,
+             int prefetch_distance,
+             bool stream) noexcept {
+  Active().dot_rows(x, rows, n, count, out, prefetch_distance, stream);
+}
+
+void SquaredL2Rows(const double* x,
+                   const double* const* rows,
+                   int n,
+                   int count,
+                   double* out,
+                   int prefetch_distance,
+                   bool stream) noexcept {
+  Active().squared_l2_rows(x, rows, n, count, out, prefetch_distance, stream);
+}
+
+int Hamming(const std::uint64_t* a, const std::uint64_t* b, int words) noexcept {
+  return Active().hamming(a, b, words);
+}
+
+void HammingRows(const std::uint64_t* query,
+                 const std::uint64_t* rows,
+                 int words,
+                 int count,
+                 int* out) noexcept {
+  Active().hamming_rows(query, rows, words, count, out);
+}
+
+std::int64_t DotU8(const std::uint8_t* a, const std::uint8_t* b, int n) noexcept {
+  return Active().dot_u8(a, b, n);
+}
+
+std::int64_t DotI8(const std::int8_t* a, const std::int8_t* b, int n) noexcept {
+  return Active().dot_i8(a, b, n);
+}
+
+double DotF64U8(const double* w, const std::uint8_t* codes, int n) noexcept {
+  return Active().dot_f64_u8(w, codes, n);
+}
+
+double DotF64I8(const double* w, const std::int8_t* codes, int n) noexcept {
+  return Active().dot_f64_i8(w, codes, n);
+}
+
+double Sum(const double* a, int n) noexcept {
+  return Active().sum(a, n);
+}
+
+double AbsSum(const double* a, int n) noexcept {
+  return Active().abs_sum(a, n);
+}
+
+double MaxAbs(const double* a, int n) noexcept {
+  return Active().max_abs(a, n);
+}
+
+int ArgMin(const double* a, int n) noexcept {
+  return Active().arg_min(a, n);
+}
+
+int ArgMax(const double* a, int n) noexcept {
+  return Active().arg_max(a, n);
+}
+
+void Multiply(double* dst, const double* src, int n) noexcept {
+  Active().multiply(dst, src, n);
+}
+
+void DivideElements(double* dst, const double* src, int n) noexcept {
+  Active().divide_elements(dst, src, n);
+}
+
+void Abs(double* dst, int n) noexcept {
+  Active().abs(dst, n);
+}
+
+void Clamp(double* dst, double lo, double hi, int n) noexcept {
+  Active().clamp(dst, lo, hi, n);
+}
+
+void Axpby(double* dst, double alpha, const double* src, double beta, int n) noexcept {
+  Active().axpby(dst, alpha, src, beta, n);
+}
+
+void Lerp(double* dst, const double* src, double t, int n) noexcept {
+  Active().lerp(dst, src, t, n);
+}
+
+void MomentumStep(double* w,
+                  double* velocity,
+                  const double* g,
+                  double learning_rate,
+                  double momentum,
+                  int n) noexcept {
+  Active().momentum_step(w, velocity, g, learning_rate, momentum, n);
+}
+
+void AdamStep(double* w,
+              double* m,
+              double* v,
+              const double* g,
+              double step_size,
+              double beta1,
+              double beta2,
+              double epsilon,
+              int n) noexcept {
+  Active().adam_step(w, m, v, g, step_size, beta1, beta2, epsilon, n);
+}
+
+bool Equal(const double* a, const double* b, int n) noexcept {
+  return Active().equal(a, b, n);
+}
+
+bool ApproxEqual(const double* a, const double* b, int n, double abs_tol, double rel_tol) noexcept {
+  return Active().approx_equal(a, b, n, abs_tol, rel_tol);
+}
+
+std::uint64_t Hash(const double* a, int n) noexcept {
+  return Active().hash(a, n);
+}
+
+void WelfordStep(double* mean,
+                 double* m2,
+                 double* delta,
+                 const double* x,
+                 double inv_count,
+                 int n) noexcept {
+  Active().welford_step(mean, m2, delta, x, inv_count, n);
+}
+
+const char* ActiveKernelIsa() noexcept {
+  return Active().name;
+}
+
+bool ForceKernelIsa(const char* name) noexcept {
+  for (auto* const* t = Candidates(); *t != nullptr; ++t) {
+    if (std::strcmp(name, (*t)->name) == 0 && Supported(**t)) {
+      active.store(*t, std::memory_order_release);
+      return true;
+    }
+  }
+  return false;
+}
+
+}  // namespace ev::kernels
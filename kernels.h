@@ -0,0 +1,248 @@
+#ifndef ASSIGNMENTS_EV_KERNELS_H_
+#define ASSIGNMENTS_EV_KERNELS_H_
+
+#include <cstdint>
+
+/*
+ * Raw-pointer numeric kernels shared by EuclideanVector and the batch algorithms built on top of
+ * it. They perform no dimension checks; callers validate their inputs first.
+ *
+ * Every kernel is compiled once per instruction set level ("scalar", "sse4.2", "avx2" with FMA,
+ * "avx512") and the best level the host supports is picked on first use. Setting the environment
+ * variable EV_KERNEL_ISA to one of those names before the first call caps the level, which is
+ * useful for testing the fallbacks. Reductions (Dot, SquaredL2, ...) sum in a different order at
+ * each level, so their results may differ in the last bits between hosts.
+ *
+ * The dst and src of an element-wise kernel may be the same array, e.g. Add(x, x, n) doubles x,
+ * but must not otherwise overlap.
+ */
+namespace ev::kernels {
+
+/*
+ * dst[i] += src[i] for i in [0, n).
+ */
+void Add(double* dst, const double* src, int n) noexcept;
+
+/*
+ * dst[i] -= src[i] for i in [0, n).
+ */
+void Sub(double* dst, const double* src, int n) noexcept;
+
+/*
+ * dst[i] *= alpha for i in [0, n).
+ */
+void Scale(double* dst, double alpha, int n) noexcept;
+
+/*
+ * dst[i] /= divisor for i in [0, n). Divides rather than multiplying by the reciprocal, so the
+ * result matches operator/ element by element.
+ */
+void Divide(double* dst, double divisor, int n) noexcept;
+
+/*
+ * dst[i] += alpha * src[i] for i in [0, n).
+ */
+void Axpy(double* dst, double alpha, const double* src, int n) noexcept;
+
+/*
+ * dst[i] = min(dst[i], src[i]) for i in [0, n).
+ */
+void Min(double* dst, const double* src, int n) noexcept;
+
+/*
+ * dst[i] = max(dst[i], src[i]) for i in [0, n).
+ */
+void Max(double* dst, const double* src, int n) noexcept;
+
+/*
+ * Returns sum of a[i] * b[i] for i in [0, n).
+ */
+double Dot(const double* a, const double* b, int n) noexcept;
+
+/*
+ * Returns sum of (a[i] - b[i])^2 for i in [0, n).
+ */
+double SquaredL2(const double* a, const double* b, int n) noexcept;
+
+/*
+ * SquaredL2, but gives up as soon as the running sum exceeds bound: compares once every 32
+ * elements and returns the partial sum, which is then > bound. Results <= bound are the full sum.
+ */
+double SquaredL2Bounded(const double* a, const double* b, int n, double bound) noexcept;
+
+/*
+ * out[r] = Dot(x, y[r], n) for r in [0, 4), loading x once for all four. Each output is summed in
+ * the same order whatever the other three pointers are, so Dot4 with y[r] == z always gives the
+ * same value for the pair (x, z).
+ */
+void Dot4(const double* x, const double* const* y, int n, double* out) noexcept;
+
+/*
+ * c[r][j] += alpha[r] * b[j] for r in [0, 4) and j in [0, n): the inner loop of a matrix product.
+ */
+void Axpy4(double* const* c, const double* alpha, const double* b, int n) noexcept;
+
+/*
+ * out[r] = Dot(x, rows[r], n) (resp. SquaredL2) for r in [0, count), where the rows may live
+ * anywhere in memory, e.g. the separately allocated vectors of a candidate list. The hardware
+ * prefetcher cannot follow such pointers, so while row r is computed the start of row
+ * r + prefetch_distance is requested with software prefetches; 0 turns that off. When stream is
+ * true, out is written with non-temporal stores that bypass the cache (on the SIMD levels; the
+ * scalar level always stores normally), which keeps a large result array from evicting the rows.
+ */
+void DotRows(const double* x,
+             const double* const* rows,
+             int n,
+             int count,
+             double* out,
+             int prefetch_distance,
+             bool stream) noexcept;
+void SquaredL2Rows(const double* x,
+                   const double* const* rows,
+                   int n,
+                   int count,
+                   double* out,
+                   int prefetch_distance,
+                   bool stream) noexcept;
+
+/*
+ * Returns the number of differing bits between the bit strings a and b of words 64-bit words.
+ */
+int Hamming(const std::uint64_t* a, const std::uint64_t* b, int words) noexcept;
+
+/*
+ * out[r] = Hamming(query, rows + r * words, words) for r in [0, count): one query against count
+ * bit strings packed back to back.
+ */
+void HammingRows(const std::uint64_t* query,
+                 const std::uint64_t* rows,
+                 int words,
+                 int count,
+                 int* out) noexcept;
+
+/*
+ * Returns sum of a[i] * b[i] for i in [0, n), computed exactly in integer arithmetic. The loops
+ * are written so the vectoriser widens to 16-bit products and 32-bit pairwise sums (pmaddwd and
+ * its AVX2/AVX-512 forms).
+ */
+std::int64_t DotU8(const std::uint8_t* a, const std::uint8_t* b, int n) noexcept;
+std::int64_t DotI8(const std::int8_t* a, const std::int8_t* b, int n) noexcept;
+
+/*
+ * Returns sum of w[i] * codes[i] for i in [0, n): a full-precision query against 8-bit codes.
+ */
+double DotF64U8(const double* w, const std::uint8_t* codes, int n) noexcept;
+double DotF64I8(const double* w, const std::int8_t* codes, int n) noexcept;
+
+/*
+ * Returns sum of a[i], sum of |a[i]| (the L1 norm) and max of |a[i]| (the L-infinity norm, 0 for
+ * n == 0) for i in [0, n). MaxAbs ignores NaNs.
+ */
+double Sum(const double* a, int n) noexcept;
+double AbsSum(const double* a, int n) noexcept;
+double MaxAbs(const double* a, int n) noexcept;
+
+/*
+ * Returns the lowest index of the smallest (resp. largest) a[i] for i in [0, n). NaNs are
+ * ignored; 0 is returned when n == 0 or every a[i] is NaN. The extreme value is found with
+ * vector compares first, then located by a scan that stops at its first occurrence.
+ */
+int ArgMin(const double* a, int n) noexcept;
+int ArgMax(const double* a, int n) noexcept;
+
+/*
+ * dst[i] *= src[i] (the Hadamard product) and dst[i] /= src[i] for i in [0, n).
+ */
+void Multiply(double* dst, const double* src, int n) noexcept;
+void DivideElements(double* dst, const double* src, int n) noexcept;
+
+/*
+ * dst[i] = |dst[i]| for i in [0, n).
+ */
+void Abs(double* dst, int n) noexcept;
+
+/*
+ * dst[i] = min(max(dst[i], lo), hi) for i in [0, n). NaNs are left as they are.
+ */
+void Clamp(double* dst, double lo, double hi, int n) noexcept;
+
+/*
+ * In-place update kernels that read and write each element once. At the "avx2" and "avx512"
+ * levels the multiply-adds are compiled to FMA instructions.
+ *
+ * Axpby:         dst[i] = alpha * src[i] + beta * dst[i]
+ * Lerp:          dst[i] += t * (src[i] - dst[i]), so t = 0 keeps dst and t = 1 gives src
+ * MomentumStep:  velocity[i] = momentum * velocity[i] + g[i]
+ *                w[i] -= learning_rate * velocity[i]
+ * AdamStep:      m[i] = beta1 * m[i] + (1 - beta1) * g[i]
+ *                v[i] = beta2 * v[i] + (1 - beta2) * g[i]^2
+ *                w[i] -= step_size * m[i] / (sqrt(v[i]) + epsilon)
+ * for i in [0, n). AdamStep takes the bias-corrected step size, see AdamOptimizer.
+ */
+void Axpby(double* dst, double alpha, const double* src, double beta, int n) noexcept;
+void Lerp(double* dst, const double* src, double t, int n) noexcept;
+void MomentumStep(double* w,
+                  double* velocity,
+                  const double* g,
+                  double learning_rate,
+                  double momentum,
+                  int n) noexcept;
+void AdamStep(double* w,
+              double* m,
+              double* v,
+              const double* g,
+              double step_size,
+              double beta1,
+              double beta2,
+              double epsilon,
+              int n) noexcept;
+
+/*
+ * Adds the sample x to running per-dimension statistics (Welford's method). inv_count is 1 over
+ * the number of samples including x. For i in [0, n):
+ *   delta[i] = x[i] - mean[i]
+ *   mean[i] += delta[i] * inv_count
+ *   m2[i] += delta[i] * (x[i] - mean[i])
+ * m2 is the sum of squared differences from the mean; delta is kept for covariance updates.
+ */
+void WelfordStep(double* mean,
+                 double* m2,
+                 double* delta,
+                 const double* x,
+                 double inv_count,
+                 int n) noexcept;
+
+/*
+ * Whether a[i] == b[i] for every i in [0, n), with the IEEE comparison: 0 equals -0, and NaN
+ * equals nothing, itself included. The bytes are not compared (as memcmp would) because that
+ * gets both cases wrong; the vector compares are as fast and stop at the first block that
+ * differs.
+ */
+bool Equal(const double* a, const double* b, int n) noexcept;
+
+/*
+ * Whether a[i] == b[i] or |a[i] - b[i]| <= max(abs_tol, rel_tol * max(|a[i]|, |b[i]|)) for every
+ * i in [0, n), as Python's math.isclose. NaN is close to nothing, and an infinity only to itself.
+ */
+bool ApproxEqual(const double* a, const double* b, int n, double abs_tol, double rel_tol) noexcept;
+
+/*
+ * XXH64 (seed 0) of the bytes of a[0, n), with every -0 hashed as 0 so that Equal arrays hash
+ * alike. The value is the same at every level and on every run.
+ */
+std::uint64_t Hash(const double* a, int n) noexcept;
+
+/*
+ * Name of the instruction set level in use: "scalar", "sse4.2", "avx2" or "avx512".
+ */
+const char* ActiveKernelIsa() noexcept;
+
+/*
+ * Switches to the named level if this host supports it, returning whether it did. Intended for
+ * tests and benchmarks; kernels already running on other threads finish on the old level.
+ */
+bool ForceKernelIsa(const char* name) noexcept;
+
+}  // namespace ev::kernels
+
+#endif  // ASSIGNMENTS_EV_KERNELS_H_
@@ -0,0 +1,9 @@
+// Compiled with the AVX2 and FMA flags from BUILD; only selected when CPUID reports both.
+#include "assignments/ev/kernel_table.h"
+
+#ifdef EV_KERNELS_X86
+#define EV_KERNEL_LANES 4
+#define EV_KERNEL_ISA_NAME "avx2"
+#define EV_KERNEL_TABLE Avx2Kernels
+#include "assignments/ev/kernels_impl.h"
+#endif
@@ -0,0 +1,9 @@
+// Compiled with the AVX-512 F/DQ/BW/VL flags from BUILD; only selected when CPUID reports all.
+#include "assignments/ev/kernel_table.h"
+
+#ifdef EV_KERNELS_X86
+#define EV_KERNEL_LANES 8
+#define EV_KERNEL_ISA_NAME "avx512"
+#define EV_KERNEL_TABLE Avx512Kernels
+#include "assignments/ev/kernels_impl.h"
+#endif
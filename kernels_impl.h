@@ -0,0 +1,785 @@
+/*
+ * Body of one kernel table. Not a normal header: each kernels_<isa>.cpp defines
+ *   EV_KERNEL_LANES       doubles per SIMD register at that level (1 for scalar),
+ *   EV_KERNEL_ISA_NAME    the name reported by ActiveKernelIsa(),
+ *   EV_KERNEL_TABLE       the name of the function returning the table,
+ * and then includes this file once. The same source is compiled with different -m flags per
+ * translation unit (see BUILD). Element-wise loops are left to the auto-vectoriser; reductions
+ * use GCC/Clang vector extensions so they vectorise without -ffast-math, and so do the update
+ * kernels (Axpby and below), so they are vectorised even where the compiler's cost model would
+ * not vectorise a loop of unknown length.
+ */
+
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+
+#include "assignments/ev/kernel_table.h"
+
+#if EV_KERNEL_LANES > 1
+#include <immintrin.h>
+#endif
+
+#if !defined(EV_KERNEL_LANES) || !defined(EV_KERNEL_ISA_NAME) || !defined(EV_KERNEL_TABLE)
+#error "kernels_impl.h needs EV_KERNEL_LANES, EV_KERNEL_ISA_NAME and EV_KERNEL_TABLE"
+#endif
+
+namespace {
+
+constexpr int kLanes = EV_KERNEL_LANES;
+#if EV_KERNEL_LANES == 1
+// A one-lane vector type is not kept in registers as well as a plain double.
+typedef double Vec;
+
+inline double HorizontalSum(Vec v) noexcept {
+  return v;
+}
+
+inline double Lane(Vec v, int) noexcept {
+  return v;
+}
+#else
+typedef double Vec __attribute__((vector_size(EV_KERNEL_LANES * sizeof(double))));
+
+inline double HorizontalSum(Vec v) noexcept {
+  double sum = 0;
+  for (auto i = 0; i < kLanes; ++i) {
+    sum += v[i];
+  }
+  return sum;
+}
+
+inline double Lane(Vec v, int i) noexcept {
+  return v[i];
+}
+#endif
+
+inline Vec Load(const double* p) noexcept {
+  Vec v;
+  std::memcpy(&v, p, sizeof(v));
+  return v;
+}
+
+inline void Store(double* p, Vec v) noexcept {
+  std::memcpy(p, &v, sizeof(v));
+}
+
+// Vector extensions have no square root, and a plain std::sqrt loop only vectorises without
+// errno, so the square root of a whole vector is taken with the intrinsic of the level.
+inline Vec SqrtLanes(Vec v) noexcept {
+#if EV_KERNEL_LANES == 8
+  // The maskz form, as _mm512_sqrt_pd trips a false -Wmaybe-uninitialized in some GCC versions.
+  return _mm512_maskz_sqrt_pd(0xff, v);
+#elif EV_KERNEL_LANES == 4
+  return _mm256_sqrt_pd(v);
+#elif EV_KERNEL_LANES == 2
+  return _mm_sqrt_pd(v);
+#else
+  return std::sqrt(v);
+#endif
+}
+
+// The element-wise kernels take no __restrict: dst and src may be the same array, as in v += v.
+// Each element of src is read before that element of dst is written.
+void Add(double* dst, const double* src, int n) noexcept {
+  for (auto i = 0; i < n; ++i) {
+    dst[i] += src[i];
+  }
+}
+
+void Sub(double* dst, const double* src, int n) noexcept {
+  for (auto i = 0; i < n; ++i) {
+    dst[i] -= src[i];
+  }
+}
+
+void Scale(double* dst, double alpha, int n) noexcept {
+  for (auto i = 0; i < n; ++i) {
+    dst[i] *= alpha;
+  }
+}
+
+void Divide(double* dst, double divisor, int n) noexcept {
+  for (auto i = 0; i < n; ++i) {
+    dst[i] /= divisor;
+  }
+}
+
+void Axpy(double* dst, double alpha, const double* src, int n) noexcept {
+  for (auto i = 0; i < n; ++i) {
+    dst[i] += alpha * src[i];
+  }
+}
+
+void Min(double* dst, const double* src, int n) noexcept {
+  for (auto i = 0; i < n; ++i) {
+    dst[i] = src[i] < dst[i] ? src[i] : dst[i];
+  }
+}
+
+void Max(double* dst, const double* src, int n) noexcept {
+  for (auto i = 0; i < n; ++i) {
+    dst[i] = src[i] > dst[i] ? src[i] : dst[i];
+  }
+}
+
+void Multiply(double* dst, const double* src, int n) noexcept {
+  for (auto i = 0; i < n; ++i) {
+    dst[i] *= src[i];
+  }
+}
+
+void DivideElements(double* dst, const double* src, int n) noexcept {
+  for (auto i = 0; i < n; ++i) {
+    dst[i] /= src[i];
+  }
+}
+
+void Abs(double* dst, int n) noexcept {
+  for (auto i = 0; i < n; ++i) {
+    dst[i] = std::fabs(dst[i]);
+  }
+}
+
+void Clamp(double* dst, double lo, double hi, int n) noexcept {
+  for (auto i = 0; i < n; ++i) {
+    const auto x = dst[i] < lo ? lo : dst[i];
+    dst[i] = x > hi ? hi : x;
+  }
+}
+
+void Axpby(double* dst, double alpha, const double* src, double beta, int n) noexcept {
+  auto i = 0;
+  for (; i + kLanes <= n; i += kLanes) {
+    Store(dst + i, alpha * Load(src + i) + beta * Load(dst + i));
+  }
+  for (; i < n; ++i) {
+    dst[i] = alpha * src[i] + beta * dst[i];
+  }
+}
+
+void Lerp(double* dst, const double* src, double t, int n) noexcept {
+  auto i = 0;
+  for (; i + kLanes <= n; i += kLanes) {
+    const auto d = Load(dst + i);
+    Store(dst + i, d + t * (Load(src + i) - d));
+  }
+  for (; i < n; ++i) {
+    dst[i] += t * (src[i] - dst[i]);
+  }
+}
+
+void MomentumStep(double* w,
+                  double* velocity,
+                  const double* g,
+                  double learning_rate,
+                  double momentum,
+                  int n) noexcept {
+  auto i = 0;
+  for (; i + kLanes <= n; i += kLanes) {
+    const auto step = momentum * Load(velocity + i) + Load(g + i);
+    Store(velocity + i, step);
+    Store(w + i, Load(w + i) - learning_rate * step);
+  }
+  for (; i < n; ++i) {
+    const auto step = momentum * velocity[i] + g[i];
+    velocity[i] = step;
+    w[i] -= learning_rate * step;
+  }
+}
+
+void AdamStep(double* w,
+              double* m,
+              double* v,
+              const double* g,
+              double step_size,
+              double beta1,
+              double beta2,
+              double epsilon,
+              int n) noexcept {
+  const auto keep1 = 1 - beta1;
+  const auto keep2 = 1 - beta2;
+  auto i = 0;
+  for (; i + kLanes <= n; i += kLanes) {
+    const auto gi = Load(g + i);
+    const auto mi = beta1 * Load(m + i) + keep1 * gi;
+    const auto vi = beta2 * Load(v + i) + keep2 * (gi * gi);
+    Store(m + i, mi);
+    Store(v + i, vi);
+    Store(w + i, Load(w + i) - step_size * mi / (SqrtLanes(vi) + epsilon));
+  }
+  for (; i < n; ++i) {
+    m[i] = beta1 * m[i] + keep1 * g[i];
+    v[i] = beta2 * v[i] + keep2 * (g[i] * g[i]);
+    w[i] -= step_size * m[i] / (std::sqrt(v[i]) + epsilon);
+  }
+}
+
+void WelfordStep(double* mean,
+                 double* m2,
+                 double* delta,
+                 const double* x,
+                 double inv_count,
+                 int n) noexcept {
+  auto i = 0;
+  for (; i + kLanes <= n; i += kLanes) {
+    const auto xi = Load(x + i);
+    const auto di = xi - Load(mean + i);
+    const auto mi = Load(mean + i) + di * inv_count;
+    Store(delta + i, di);
+    Store(mean + i, mi);
+    Store(m2 + i, Load(m2 + i) + di * (xi - mi));
+  }
+  for (; i < n; ++i) {
+    const auto di = x[i] - mean[i];
+    delta[i] = di;
+    mean[i] += di * inv_count;
+    m2[i] += di * (x[i] - mean[i]);
+  }
+}
+
+// Four independent vector accumulators hide the latency of the multiply-add chain.
+double Dot(const double* a, const double* b, int n) noexcept {
+  Vec s0 = {}, s1 = {}, s2 = {}, s3 = {};
+  auto i = 0;
+  for (; i + 4 * kLanes <= n; i += 4 * kLanes) {
+    s0 += Load(a + i) * Load(b + i);
+    s1 += Load(a + i + kLanes) * Load(b + i + kLanes);
+    s2 += Load(a + i + 2 * kLanes) * Load(b + i + 2 * kLanes);
+    s3 += Load(a + i + 3 * kLanes) * Load(b + i + 3 * kLanes);
+  }
+  for (; i + kLanes <= n; i += kLanes) {
+    s0 += Load(a + i) * Load(b + i);
+  }
+  auto sum = HorizontalSum((s0 + s1) + (s2 + s3));
+  for (; i < n; ++i) {
+    sum += a[i] * b[i];
+  }
+  return sum;
+}
+
+double SquaredL2(const double* a, const double* b, int n) noexcept {
+  Vec s0 = {}, s1 = {}, s2 = {}, s3 = {};
+  auto i = 0;
+  for (; i + 4 * kLanes <= n; i += 4 * kLanes) {
+    const auto d0 = Load(a + i) - Load(b + i);
+    const auto d1 = Load(a + i + kLanes) - Load(b + i + kLanes);
+    const auto d2 = Load(a + i + 2 * kLanes) - Load(b + i + 2 * kLanes);
+    const auto d3 = Load(a + i + 3 * kLanes) - Load(b + i + 3 * kLanes);
+    s0 += d0 * d0;
+    s1 += d1 * d1;
+    s2 += d2 * d2;
+    s3 += d3 * d3;
+  }
+  for (; i + kLanes <= n; i += kLanes) {
+    const auto d = Load(a + i) - Load(b + i);
+    s0 += d * d;
+  }
+  auto sum = HorizontalSum((s0 + s1) + (s2 + s3));
+  for (; i < n; ++i) {
+    const auto d = a[i] - b[i];
+    sum += d * d;
+  }
+  return sum;
+}
+
+double Sum(const double* a, int n) noexcept {
+  Vec s0 = {}, s1 = {}, s2 = {}, s3 = {};
+  auto i = 0;
+  for (; i + 4 * kLanes <= n; i += 4 * kLanes) {
+    s0 += Load(a + i);
+    s1 += Load(a + i + kLanes);
+    s2 += Load(a + i + 2 * kLanes);
+    s3 += Load(a + i + 3 * kLanes);
+  }
+  for (; i + kLanes <= n; i += kLanes) {
+    s0 += Load(a + i);
+  }
+  auto sum = HorizontalSum((s0 + s1) + (s2 + s3));
+  for (; i < n; ++i) {
+    sum += a[i];
+  }
+  return sum;
+}
+
+inline Vec AbsLanes(Vec v) noexcept {
+  return v < 0 ? -v : v;
+}
+
+double AbsSum(const double* a, int n) noexcept {
+  Vec s0 = {}, s1 = {}, s2 = {}, s3 = {};
+  auto i = 0;
+  for (; i + 4 * kLanes <= n; i += 4 * kLanes) {
+    s0 += AbsLanes(Load(a + i));
+    s1 += AbsLanes(Load(a + i + kLanes));
+    s2 += AbsLanes(Load(a + i + 2 * kLanes));
+    s3 += AbsLanes(Load(a + i + 3 * kLanes));
+  }
+  for (; i + kLanes <= n; i += kLanes) {
+    s0 += AbsLanes(Load(a + i));
+  }
+  auto sum = HorizontalSum((s0 + s1) + (s2 + s3));
+  for (; i < n; ++i) {
+    sum += std::fabs(a[i]);
+  }
+  return sum;
+}
+
+// Keeps the larger (kMax) or smaller value per lane. A NaN in v never wins the comparison, so
+// NaNs are skipped.
+template <bool kMax>
+inline double Extreme(double v, double best) noexcept {
+  if (kMax) {
+    return v > best ? v : best;
+  }
+  return v < best ? v : best;
+}
+
+#if EV_KERNEL_LANES > 1
+template <bool kMax>
+inline Vec Extreme(Vec v, Vec best) noexcept {
+  if (kMax) {
+    return v > best ? v : best;
+  }
+  return v < best ? v : best;
+}
+#endif
+
+// The largest (kMax) or smallest value of a[0, n), starting from start. Two accumulators, as the
+// compare-and-select chain has a latency of several cycles.
+template <bool kMax>
+double ExtremeValue(const double* a, int n, double start) noexcept {
+  const Vec initial = Vec{} + start;
+  auto e0 = initial;
+  auto e1 = initial;
+  auto i = 0;
+  for (; i + 2 * kLanes <= n; i += 2 * kLanes) {
+    e0 = Extreme<kMax>(Load(a + i), e0);
+    e1 = Extreme<kMax>(Load(a + i + kLanes), e1);
+  }
+  e0 = Extreme<kMax>(e1, e0);
+  auto best = start;
+  for (auto lane = 0; lane < kLanes; ++lane) {
+    best = Extreme<kMax>(Lane(e0, lane), best);
+  }
+  for (; i < n; ++i) {
+    best = Extreme<kMax>(a[i], best);
+  }
+  return best;
+}
+
+double MaxAbs(const double* a, int n) noexcept {
+  Vec m0 = {}, m1 = {};
+  auto i = 0;
+  for (; i + 2 * kLanes <= n; i += 2 * kLanes) {
+    m0 = Extreme<true>(AbsLanes(Load(a + i)), m0);
+    m1 = Extreme<true>(AbsLanes(Load(a + i + kLanes)), m1);
+  }
+  m0 = Extreme<true>(m1, m0);
+  auto best = 0.0;
+  for (auto lane = 0; lane < kLanes; ++lane) {
+    best = Extreme<true>(Lane(m0, lane), best);
+  }
+  for (; i < n; ++i) {
+    best = Extreme<true>(std::fabs(a[i]), best);
+  }
+  return best;
+}
+
+template <bool kMax>
+int ArgExtreme(const double* a, int n) noexcept {
+  const auto best = ExtremeValue<kMax>(a, n, kMax ? -__builtin_inf() : __builtin_inf());
+  for (auto i = 0; i < n; ++i) {
+    if (a[i] == best) {
+      return i;
+    }
+  }
+  return 0;
+}
+
+int ArgMin(const double* a, int n) noexcept {
+  return ArgExtreme<false>(a, n);
+}
+
+int ArgMax(const double* a, int n) noexcept {
+  return ArgExtreme<true>(a, n);
+}
+
+#if EV_KERNEL_LANES == 1
+inline bool AnyLane(bool m) noexcept {
+  return m;
+}
+#else
+typedef decltype(Vec{} < Vec{}) Mask;
+
+// Whether any lane of a comparison result is set.
+inline bool AnyLane(Mask m) noexcept {
+  auto any = m[0];
+  for (auto i = 1; i < kLanes; ++i) {
+    any |= m[i];
+  }
+  return any != 0;
+}
+#endif
+
+bool Equal(const double* a, const double* b, int n) noexcept {
+  auto i = 0;
+  // Lanes are compared a block of four vectors at a time, and only the block's combined result
+  // is branched on.
+  for (; i + 4 * kLanes <= n; i += 4 * kLanes) {
+    const auto differ = (Load(a + i) != Load(b + i)) |
+                        (Load(a + i + kLanes) != Load(b + i + kLanes)) |
+                        (Load(a + i + 2 * kLanes) != Load(b + i + 2 * kLanes)) |
+                        (Load(a + i + 3 * kLanes) != Load(b + i + 3 * kLanes));
+    if (AnyLane(differ)) {
+      return false;
+    }
+  }
+  for (; i < n; ++i) {
+    if (a[i] != b[i]) {
+      return false;
+    }
+  }
+  return true;
+}
+
+// Lanes (of a Vec, or a single double) where x and y are not within the tolerance of ApproxEqual.
+// Infinities are only close to themselves, as in Python's math.isclose.
+template <typename T>
+inline auto NotClose(T x, T y, T abs_tol, double rel_tol) noexcept {
+  const T abs_x = x < 0 ? -x : x;
+  const T abs_y = y < 0 ? -y : y;
+  const T diff = x < y ? y - x : x - y;
+  const auto tol = Extreme<true>(rel_tol * Extreme<true>(abs_x, abs_y), abs_tol);
+  return ((x == y) | ((diff <= tol) & (diff < __builtin_inf()))) == 0;
+}
+
+bool ApproxEqual(const double* a, const double* b, int n, double abs_tol, double rel_tol) noexcept {
+  const Vec abs_tol_lanes = Vec{} + abs_tol;
+  auto i = 0;
+  for (; i + 2 * kLanes <= n; i += 2 * kLanes) {
+    const auto far = NotClose(Load(a + i), Load(b + i), abs_tol_lanes, rel_tol) |
+                     NotClose(Load(a + i + kLanes), Load(b + i + kLanes), abs_tol_lanes, rel_tol);
+    if (AnyLane(far)) {
+      return false;
+    }
+  }
+  for (; i < n; ++i) {
+    if (NotClose(a[i], b[i], abs_tol, rel_tol)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+// Hash is XXH64 with seed 0 over the bytes of the magnitudes. Its four accumulators are kept in a
+// fixed four-lane vector rather than Vec, so every level computes the same value.
+typedef std::uint64_t HashLanes __attribute__((vector_size(4 * sizeof(std::uint64_t))));
+typedef double HashInput __attribute__((vector_size(4 * sizeof(double))));
+
+constexpr std::uint64_t kPrime1 = 0x9E3779B185EBCA87ULL;
+constexpr std::uint64_t kPrime2 = 0xC2B2AE3D27D4EB4FULL;
+constexpr std::uint64_t kPrime3 = 0x165667B19E3779F9ULL;
+constexpr std::uint64_t kPrime4 = 0x85EBCA77C2B2AE63ULL;
+constexpr std::uint64_t kPrime5 = 0x27D4EB2F165667C5ULL;
+
+inline std::uint64_t RotateLeft(std::uint64_t x, int r) noexcept {
+  return (x << r) | (x >> (64 - r));
+}
+
+inline std::uint64_t HashRound(std::uint64_t acc, std::uint64_t input) noexcept {
+  return RotateLeft(acc + input * kPrime2, 31) * kPrime1;
+}
+
+std::uint64_t Hash(const double* a, int n) noexcept {
+  auto i = 0;
+  std::uint64_t h = kPrime5;
+  if (n >= 4) {
+    HashLanes acc = {kPrime1 + kPrime2, kPrime2, 0, 0 - kPrime1};
+    for (; i + 4 <= n; i += 4) {
+      HashInput x;
+      std::memcpy(&x, a + i, sizeof(x));
+      // -0 + 0 is +0, so the two zeros, which compare equal, hash alike.
+      x += 0.0;
+      HashLanes bits;
+      std::memcpy(&bits, &x, sizeof(bits));
+      // HashRound on all four lanes. Written out, as the scalar and sse4.2 levels cannot pass
+      // a 32-byte vector to a function in registers.
+      const HashLanes sum = acc + bits * kPrime2;
+      acc = ((sum << 31) | (sum >> 33)) * kPrime1;
+    }
+    h = RotateLeft(acc[0], 1) + RotateLeft(acc[1], 7) + RotateLeft(acc[2], 12) +
+        RotateLeft(acc[3], 18);
+    for (auto lane = 0; lane < 4; ++lane) {
+      h = (h ^ HashRound(0, acc[lane])) * kPrime1 + kPrime4;
+    }
+  }
+  h += static_cast<std::uint64_t>(n) * sizeof(double);
+  for (; i < n; ++i) {
+    const auto x = a[i] + 0.0;
+    std::uint64_t bits;
+    std::memcpy(&bits, &x, sizeof(bits));
+    h = RotateLeft(h ^ HashRound(0, bits), 27) * kPrime1 + kPrime4;
+  }
+  h ^= h >> 33;
+  h *= kPrime2;
+  h ^= h >> 29;
+  h *= kPrime3;
+  return h ^ (h >> 32);
+}
+
+double SquaredL2Bounded(const double* a, const double* b, int n, double bound) noexcept {
+  // 32 doubles is one pass of the 4-way unrolled loop at the widest level.
+  constexpr auto kBlock = 32;
+  auto sum = 0.0;
+  auto i = 0;
+  for (; i + kBlock <= n; i += kBlock) {
+    sum += SquaredL2(a + i, b + i, kBlock);
+    if (sum > bound) {
+      return sum;
+    }
+  }
+  return sum + SquaredL2(a + i, b + i, n - i);
+}
+
+// Cache lines requested per prefetched row. Past the first few lines of a row the hardware
+// prefetcher has seen the sequential pattern and takes over.
+constexpr int kPrefetchLines = 8;
+
+inline void PrefetchRow(const double* row, int n) noexcept {
+  const auto end = n < kPrefetchLines * 8 ? n : kPrefetchLines * 8;
+  for (auto i = 0; i < end; i += 8) {
+    __builtin_prefetch(row + i, 0, 3);
+  }
+}
+
+// Writes count doubles of src to dst, with non-temporal stores when stream is set and the level
+// has them. Only whole vectors aligned to their own size are streamed.
+inline void StoreResults(double* dst, const double* src, int count, bool stream) noexcept {
+#if EV_KERNEL_LANES > 1
+  if (stream) {
+    auto i = 0;
+    for (; i < count && reinterpret_cast<std::uintptr_t>(dst + i) % sizeof(Vec) != 0; ++i) {
+      dst[i] = src[i];
+    }
+    for (; i + kLanes <= count; i += kLanes) {
+#if EV_KERNEL_LANES == 8
+      _mm512_stream_pd(dst + i, Load(src + i));
+#elif EV_KERNEL_LANES == 4
+      _mm256_stream_pd(dst + i, Load(src + i));
+#else
+      _mm_stream_pd(dst + i, Load(src + i));
+#endif
+    }
+    for (; i < count; ++i) {
+      dst[i] = src[i];
+    }
+    return;
+  }
+#else
+  static_cast<void>(stream);
+#endif
+  std::memcpy(dst, src, count * sizeof(double));
+}
+
+template <bool kSquaredL2>
+void ScanRows(const double* x,
+              const double* const* rows,
+              int n,
+              int count,
+              double* out,
+              int prefetch_distance,
+              bool stream) noexcept {
+  // Results are gathered a block at a time so they can be written out as whole vectors.
+  constexpr auto kBlock = 16;
+  double block[kBlock];
+  for (auto r0 = 0; r0 < count; r0 += kBlock) {
+    const auto r1 = count - r0 < kBlock ? count : r0 + kBlock;
+    for (auto r = r0; r < r1; ++r) {
+      if (prefetch_distance > 0 && r + prefetch_distance < count) {
+        PrefetchRow(rows[r + prefetch_distance], n);
+      }
+      block[r - r0] = kSquaredL2 ? SquaredL2(x, rows[r], n) : Dot(x, rows[r], n);
+    }
+    StoreResults(out + r0, block, r1 - r0, stream);
+  }
+#if EV_KERNEL_LANES > 1
+  if (stream) {
+    // Non-temporal stores are not ordered with later ones; make them visible before returning.
+    _mm_sfence();
+  }
+#endif
+}
+
+void DotRows(const double* x,
+             const double* const* rows,
+             int n,
+             int count,
+             double* out,
+             int prefetch_distance,
+             bool stream) noexcept {
+  ScanRows<false>(x, rows, n, count, out, prefetch_distance, stream);
+}
+
+void SquaredL2Rows(const double* x,
+                   const double* const* rows,
+                   int n,
+                   int count,
+                   double* out,
+                   int prefetch_distance,
+                   bool stream) noexcept {
+  ScanRows<true>(x, rows, n, count, out, prefetch_distance, stream);
+}
+
+void Dot4(const double* x, const double* const* y, int n, double* out) noexcept {
+  const auto* y0 = y[0];
+  const auto* y1 = y[1];
+  const auto* y2 = y[2];
+  const auto* y3 = y[3];
+  Vec s0 = {}, s1 = {}, s2 = {}, s3 = {};
+  auto i = 0;
+  for (; i + kLanes <= n; i += kLanes) {
+    const auto xv = Load(x + i);
+    s0 += xv * Load(y0 + i);
+    s1 += xv * Load(y1 + i);
+    s2 += xv * Load(y2 + i);
+    s3 += xv * Load(y3 + i);
+  }
+  auto r0 = HorizontalSum(s0);
+  auto r1 = HorizontalSum(s1);
+  auto r2 = HorizontalSum(s2);
+  auto r3 = HorizontalSum(s3);
+  for (; i < n; ++i) {
+    r0 += x[i] * y0[i];
+    r1 += x[i] * y1[i];
+    r2 += x[i] * y2[i];
+    r3 += x[i] * y3[i];
+  }
+  out[0] = r0;
+  out[1] = r1;
+  out[2] = r2;
+  out[3] = r3;
+}
+
+void Axpy4(double* const* c, const double* alpha, const double* __restrict b, int n) noexcept {
+  auto* __restrict c0 = c[0];
+  auto* __restrict c1 = c[1];
+  auto* __restrict c2 = c[2];
+  auto* __restrict c3 = c[3];
+  const auto a0 = alpha[0];
+  const auto a1 = alpha[1];
+  const auto a2 = alpha[2];
+  const auto a3 = alpha[3];
+  for (auto j = 0; j < n; ++j) {
+    c0[j] += a0 * b[j];
+    c1[j] += a1 * b[j];
+    c2[j] += a2 * b[j];
+    c3[j] += a3 * b[j];
+  }
+}
+
+// Compiles to the popcnt instruction in every table but the scalar one (see BUILD). Four counters
+// keep four popcnts in flight.
+int Hamming(const std::uint64_t* a, const std::uint64_t* b, int words) noexcept {
+  int c0 = 0, c1 = 0, c2 = 0, c3 = 0;
+  auto i = 0;
+  for (; i + 4 <= words; i += 4) {
+    c0 += __builtin_popcountll(a[i] ^ b[i]);
+    c1 += __builtin_popcountll(a[i + 1] ^ b[i + 1]);
+    c2 += __builtin_popcountll(a[i + 2] ^ b[i + 2]);
+    c3 += __builtin_popcountll(a[i + 3] ^ b[i + 3]);
+  }
+  for (; i < words; ++i) {
+    c0 += __builtin_popcountll(a[i] ^ b[i]);
+  }
+  return (c0 + c1) + (c2 + c3);
+}
+
+void HammingRows(const std::uint64_t* query,
+                 const std::uint64_t* rows,
+                 int words,
+                 int count,
+                 int* out) noexcept {
+  for (auto r = 0; r < count; ++r) {
+    out[r] = Hamming(query, rows + static_cast<std::int64_t>(r) * words, words);
+  }
+}
+
+// Products of two 8-bit values fit in 16 bits and 2^15 of them still fit in an int32, so blocks of
+// that size are summed in 32 bits, which the vectoriser handles far better than 64.
+template <typename Code>
+std::int64_t DotCodes(const Code* a, const Code* b, int n) noexcept {
+  constexpr auto kBlock = 1 << 15;
+  std::int64_t sum = 0;
+  for (auto i0 = 0; i0 < n; i0 += kBlock) {
+    const auto i1 = n - i0 < kBlock ? n : i0 + kBlock;
+    std::int32_t block = 0;
+    for (auto i = i0; i < i1; ++i) {
+      block += static_cast<std::int16_t>(a[i]) * static_cast<std::int16_t>(b[i]);
+    }
+    sum += block;
+  }
+  return sum;
+}
+
+std::int64_t DotU8(const std::uint8_t* a, const std::uint8_t* b, int n) noexcept {
+  return DotCodes(a, b, n);
+}
+
+std::int64_t DotI8(const std::int8_t* a, const std::int8_t* b, int n) noexcept {
+  return DotCodes(a, b, n);
+}
+
+// Widens kLanes 8-bit codes to doubles.
+template <typename Code>
+inline Vec LoadCodes(const Code* p) noexcept {
+#if EV_KERNEL_LANES == 1
+  return *p;
+#else
+  Vec v;
+  for (auto l = 0; l < kLanes; ++l) {
+    v[l] = p[l];
+  }
+  return v;
+#endif
+}
+
+template <typename Code>
+double DotWeights(const double* w, const Code* codes, int n) noexcept {
+  Vec s0 = {}, s1 = {};
+  auto i = 0;
+  for (; i + 2 * kLanes <= n; i += 2 * kLanes) {
+    s0 += Load(w + i) * LoadCodes(codes + i);
+    s1 += Load(w + i + kLanes) * LoadCodes(codes + i + kLanes);
+  }
+  auto sum = HorizontalSum(s0 + s1);
+  for (; i < n; ++i) {
+    sum += w[i] * codes[i];
+  }
+  return sum;
+}
+
+double DotF64U8(const double* w, const std::uint8_t* codes, int n) noexcept {
+  return DotWeights(w, codes, n);
+}
+
+double DotF64I8(const double* w, const std::int8_t* codes, int n) noexcept {
+  return DotWeights(w, codes, n);
+}
+
+}  // namespace
+
+namespace ev::kernels::detail {
+
+const KernelTable& EV_KERNEL_TABLE() noexcept {
+  static constexpr KernelTable table{EV_KERNEL_ISA_NAME, Add, Sub, Scale, Divide, Axpy, Min,
+                                     Max, Dot, SquaredL2, SquaredL2Bounded, Dot4, Axpy4,
+                                     DotRows, SquaredL2Rows, Hamming, HammingRows, DotU8,
+                                     DotI8, DotF64U8, DotF64I8, Sum, AbsSum, MaxAbs,
+                                     ArgMin, ArgMax, Multiply, DivideElements, Abs, Clamp,
+                                     Axpby, Lerp, MomentumStep, AdamStep, Equal,
+                                     ApproxEqual, Hash, WelfordStep};
+  return table;
+}
+
+}  // namespace ev::kernels::detail
@@ -0,0 +1,5 @@
+// Portable build, compiled with the toolchain's default flags. Always available.
+#define EV_KERNEL_LANES 1
+#define EV_KERNEL_ISA_NAME "scalar"
+#define EV_KERNEL_TABLE ScalarKernels
+#include "assignments/ev/kernels_impl.h"
@@ -0,0 +1,9 @@
+// Compiled with the SSE4.2 flags from BUILD; only selected when CPUID reports SSE4.2.
+#include "assignments/ev/kernel_table.h"
+
+#ifdef EV_KERNELS_X86
+#define EV_KERNEL_LANES 2
+#define EV_KERNEL_ISA_NAME "sse4.2"
+#define EV_KERNEL_TABLE Sse42Kernels
+#include "assignments/ev/kernels_impl.h"
+#endif
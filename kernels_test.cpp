@@ -0,0 +1,404 @@
+/*
+
+  == Explanation and rational of testing ==
+
+  Every kernel is run at every instruction set level this host supports and compared with a plain
+  loop. Lengths are chosen around the vector widths (0, 1, 3, 7, 8, 9, 33, 100) so the main loop,
+  the single-vector loop and the scalar tail are all exercised. The Hamming kernels are checked
+  against counting bits one at a time. The 8-bit kernels use the extreme code values, so any lane
+  that overflows or sign-extends wrongly shows up. The row-list kernels must give exactly the
+  single-row results whatever the prefetch distance, and with streaming stores into both aligned
+  and misaligned output. The arg-min and arg-max kernels are given repeated extremes and NaNs, so
+  the first occurrence must win and NaNs must be skipped. The update kernels may use FMA, so they
+  are compared with a tolerance. The comparison kernels are given one differing element at each
+  position in turn, so every lane of every block is checked, along with 0 against -0 and NaNs.
+  The hash must match reference XXH64 values at every level. We also test the level reporting and
+  forcing.
+
+*/
+
+#include "assignments/ev/kernels.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "catch.h"
+
+namespace {
+
+std::vector<double> MakeValues(int n, double phase) {
+  std::vector<double> values(n);
+  for (auto i = 0; i < n; ++i) {
+    values[i] = std::sin(phase + i * 0.7) * 10;
+  }
+  return values;
+}
+
+// Restores the automatically selected level when a test is done forcing levels.
+struct RestoreIsa {
+  std::string isa = ev::kernels::ActiveKernelIsa();
+  ~RestoreIsa() { ev::kernels::ForceKernelIsa(isa.c_str()); }
+};
+
+}  // namespace
+
+TEST_CASE("Kernel level reporting and forcing") {
+  RestoreIsa restore;
+  const std::string active = ev::kernels::ActiveKernelIsa();
+  REQUIRE((active == "scalar" || active == "sse4.2" || active == "avx2" || active == "avx512"));
+
+  SECTION("TEST CASE 1 The scalar level is always available") {
+    REQUIRE(ev::kernels::ForceKernelIsa("scalar"));
+    REQUIRE(std::strcmp(ev::kernels::ActiveKernelIsa(), "scalar") == 0);
+  }
+
+  SECTION("TEST CASE 2 Unknown levels are rejected") {
+    REQUIRE_FALSE(ev::kernels::ForceKernelIsa("mmx"));
+    REQUIRE(ev::kernels::ActiveKernelIsa() == active);
+  }
+}
+
+TEST_CASE("Kernels agree with plain loops at every supported level") {
+  RestoreIsa restore;
+  for (auto isa : {"scalar", "sse4.2", "avx2", "avx512"}) {
+    if (!ev::kernels::ForceKernelIsa(isa)) {
+      continue;
+    }
+    for (auto n : {0, 1, 3, 7, 8, 9, 33, 100, 130}) {
+      const auto a = MakeValues(n, 0.0);
+      const auto b = MakeValues(n, 1.0);
+
+      double dot = 0;
+      double l2 = 0;
+      for (auto i = 0; i < n; ++i) {
+        dot += a[i] * b[i];
+        l2 += (a[i] - b[i]) * (a[i] - b[i]);
+      }
+      REQUIRE(ev::kernels::Dot(a.data(), b.data(), n) == Approx(dot).margin(1e-9));
+      REQUIRE(ev::kernels::SquaredL2(a.data(), b.data(), n) == Approx(l2).margin(1e-9));
+      const auto huge = l2 + 1;
+      REQUIRE(ev::kernels::SquaredL2Bounded(a.data(), b.data(), n, huge) ==
+              Approx(l2).margin(1e-9));
+      if (n > 0) {
+        // Stops early, at a partial sum above the bound but no larger than the full sum.
+        const auto bounded = ev::kernels::SquaredL2Bounded(a.data(), b.data(), n, l2 / 8);
+        REQUIRE(bounded > l2 / 8);
+        REQUIRE(bounded <= l2 + 1e-9);
+      }
+
+      auto add = a;
+      ev::kernels::Add(add.data(), b.data(), n);
+      auto sub = a;
+      ev::kernels::Sub(sub.data(), b.data(), n);
+      auto scale = a;
+      ev::kernels::Scale(scale.data(), 3.0, n);
+      auto divide = a;
+      ev::kernels::Divide(divide.data(), 3.0, n);
+      auto axpy = a;
+      ev::kernels::Axpy(axpy.data(), -2.0, b.data(), n);
+      auto min = a;
+      ev::kernels::Min(min.data(), b.data(), n);
+      auto max = a;
+      ev::kernels::Max(max.data(), b.data(), n);
+      for (auto i = 0; i < n; ++i) {
+        REQUIRE(add[i] == a[i] + b[i]);
+        REQUIRE(sub[i] == a[i] - b[i]);
+        REQUIRE(scale[i] == a[i] * 3.0);
+        REQUIRE(divide[i] == a[i] / 3.0);
+        REQUIRE(axpy[i] == Approx(a[i] - 2.0 * b[i]).margin(1e-12));
+        REQUIRE(min[i] == std::min(a[i], b[i]));
+        REQUIRE(max[i] == std::max(a[i], b[i]));
+      }
+
+      const auto c = MakeValues(n, 2.0);
+      const auto d = MakeValues(n, 3.0);
+      const double* y[4] = {a.data(), b.data(), c.data(), d.data()};
+      double sums[4];
+      ev::kernels::Dot4(a.data(), y, n, sums);
+      for (auto r = 0; r < 4; ++r) {
+        REQUIRE(sums[r] == Approx(ev::kernels::Dot(a.data(), y[r], n)).margin(1e-9));
+      }
+
+      std::vector<std::vector<double>> rows{a, b, c, d};
+      double* out[4] = {rows[0].data(), rows[1].data(), rows[2].data(), rows[3].data()};
+      const double alpha[4] = {1.0, -1.0, 0.5, 2.0};
+      ev::kernels::Axpy4(out, alpha, b.data(), n);
+      for (auto i = 0; i < n; ++i) {
+        REQUIRE(rows[0][i] == Approx(a[i] + b[i]).margin(1e-12));
+        REQUIRE(rows[3][i] == Approx(d[i] + 2.0 * b[i]).margin(1e-12));
+      }
+    }
+  }
+}
+
+TEST_CASE("Reduction and element-wise kernels agree with plain loops at every supported level") {
+  RestoreIsa restore;
+  for (auto isa : {"scalar", "sse4.2", "avx2", "avx512"}) {
+    if (!ev::kernels::ForceKernelIsa(isa)) {
+      continue;
+    }
+    for (auto n : {0, 1, 3, 7, 8, 9, 33, 100, 130}) {
+      const auto a = MakeValues(n, 0.0);
+      const auto b = MakeValues(n, 1.0);
+
+      double sum = 0;
+      double abs_sum = 0;
+      double max_abs = 0;
+      auto arg_min = 0;
+      auto arg_max = 0;
+      for (auto i = 0; i < n; ++i) {
+        sum += a[i];
+        abs_sum += std::fabs(a[i]);
+        max_abs = std::max(max_abs, std::fabs(a[i]));
+        arg_min = a[i] < a[arg_min] ? i : arg_min;
+        arg_max = a[i] > a[arg_max] ? i : arg_max;
+      }
+      REQUIRE(ev::kernels::Sum(a.data(), n) == Approx(sum).margin(1e-9));
+      REQUIRE(ev::kernels::AbsSum(a.data(), n) == Approx(abs_sum).margin(1e-9));
+      REQUIRE(ev::kernels::MaxAbs(a.data(), n) == max_abs);
+      REQUIRE(ev::kernels::ArgMin(a.data(), n) == arg_min);
+      REQUIRE(ev::kernels::ArgMax(a.data(), n) == arg_max);
+
+      auto multiply = a;
+      ev::kernels::Multiply(multiply.data(), b.data(), n);
+      auto divide = a;
+      ev::kernels::DivideElements(divide.data(), b.data(), n);
+      auto abs = a;
+      ev::kernels::Abs(abs.data(), n);
+      auto clamp = a;
+      ev::kernels::Clamp(clamp.data(), -2.5, 4.0, n);
+      for (auto i = 0; i < n; ++i) {
+        REQUIRE(multiply[i] == a[i] * b[i]);
+        REQUIRE(divide[i] == a[i] / b[i]);
+        REQUIRE(abs[i] == std::fabs(a[i]));
+        REQUIRE(clamp[i] == std::min(std::max(a[i], -2.5), 4.0));
+      }
+    }
+
+    // Repeated extremes in different lanes, with NaNs in front of them.
+    std::vector<double> c(70, 1.0);
+    c[0] = std::nan("");
+    c[9] = std::nan("");
+    c[21] = -3.0;
+    c[46] = -3.0;
+    c[33] = 5.0;
+    c[66] = 5.0;
+    REQUIRE(ev::kernels::ArgMin(c.data(), 70) == 21);
+    REQUIRE(ev::kernels::ArgMax(c.data(), 70) == 33);
+    REQUIRE(ev::kernels::MaxAbs(c.data(), 70) == 5.0);
+    const std::vector<double> nans(20, std::nan(""));
+    REQUIRE(ev::kernels::ArgMin(nans.data(), 20) == 0);
+    REQUIRE(ev::kernels::ArgMax(nans.data(), 0) == 0);
+    REQUIRE(ev::kernels::MaxAbs(nans.data(), 0) == 0.0);
+  }
+}
+
+TEST_CASE("Update kernels agree with plain loops at every supported level") {
+  RestoreIsa restore;
+  for (auto isa : {"scalar", "sse4.2", "avx2", "avx512"}) {
+    if (!ev::kernels::ForceKernelIsa(isa)) {
+      continue;
+    }
+    for (auto n : {0, 1, 3, 7, 8, 9, 33, 100, 130}) {
+      const auto a = MakeValues(n, 0.0);
+      const auto b = MakeValues(n, 1.0);
+      const auto g = MakeValues(n, 2.0);
+
+      auto axpby = a;
+      ev::kernels::Axpby(axpby.data(), 0.5, b.data(), -1.5, n);
+      auto lerp = a;
+      ev::kernels::Lerp(lerp.data(), b.data(), 0.25, n);
+      auto w = a;
+      auto velocity = b;
+      ev::kernels::MomentumStep(w.data(), velocity.data(), g.data(), 0.1, 0.9, n);
+      for (auto i = 0; i < n; ++i) {
+        REQUIRE(axpby[i] == Approx(0.5 * b[i] - 1.5 * a[i]).margin(1e-12));
+        REQUIRE(lerp[i] == Approx(a[i] + 0.25 * (b[i] - a[i])).margin(1e-12));
+        REQUIRE(velocity[i] == Approx(0.9 * b[i] + g[i]).margin(1e-12));
+        REQUIRE(w[i] == Approx(a[i] - 0.1 * velocity[i]).margin(1e-12));
+      }
+
+      auto adam_w = a;
+      auto m = b;
+      std::vector<double> v(n);
+      for (auto i = 0; i < n; ++i) {
+        v[i] = std::fabs(b[i]);
+      }
+      const auto v_before = v;
+      ev::kernels::AdamStep(adam_w.data(), m.data(), v.data(), g.data(), 0.01, 0.9, 0.99, 1e-8,
+                            n);
+      for (auto i = 0; i < n; ++i) {
+        REQUIRE(m[i] == Approx(0.9 * b[i] + 0.1 * g[i]).margin(1e-12));
+        REQUIRE(v[i] == Approx(0.99 * v_before[i] + 0.01 * g[i] * g[i]).margin(1e-12));
+        REQUIRE(adam_w[i] ==
+                Approx(a[i] - 0.01 * m[i] / (std::sqrt(v[i]) + 1e-8)).margin(1e-12));
+      }
+
+      auto mean = a;
+      auto m2 = v_before;
+      std::vector<double> delta(n);
+      ev::kernels::WelfordStep(mean.data(), m2.data(), delta.data(), g.data(), 0.25, n);
+      for (auto i = 0; i < n; ++i) {
+        REQUIRE(delta[i] == Approx(g[i] - a[i]).margin(1e-12));
+        REQUIRE(mean[i] == Approx(a[i] + 0.25 * (g[i] - a[i])).margin(1e-12));
+        REQUIRE(m2[i] == Approx(v_before[i] + (g[i] - a[i]) * (g[i] - mean[i])).margin(1e-12));
+      }
+    }
+  }
+}
+
+TEST_CASE("Comparison and hash kernels agree with plain loops at every supported level") {
+  RestoreIsa restore;
+  // XXH64 (seed 0) of the doubles i * 1.5 - 3 for i in [0, n), computed with the reference
+  // implementation.
+  const std::vector<std::pair<int, std::uint64_t>> reference{{0, 0xEF46DB3751D8E999ULL},
+                                                             {1, 0xBBDE15FD6352AF20ULL},
+                                                             {5, 0x017EBDF06CF5587EULL},
+                                                             {11, 0x413CEA8AC79A93F1ULL}};
+  for (auto isa : {"scalar", "sse4.2", "avx2", "avx512"}) {
+    if (!ev::kernels::ForceKernelIsa(isa)) {
+      continue;
+    }
+    for (auto n : {0, 1, 3, 7, 8, 9, 33, 100}) {
+      const auto a = MakeValues(n, 0.5);
+      auto b = a;
+      REQUIRE(ev::kernels::Equal(a.data(), b.data(), n));
+      REQUIRE(ev::kernels::ApproxEqual(a.data(), b.data(), n, 0, 0));
+      const auto hash = ev::kernels::Hash(a.data(), n);
+      for (auto i = 0; i < n; ++i) {
+        b[i] = a[i] * (1 + 1e-12);
+        REQUIRE_FALSE(ev::kernels::Equal(a.data(), b.data(), n));
+        REQUIRE(ev::kernels::ApproxEqual(a.data(), b.data(), n, 0, 1e-9));
+        REQUIRE_FALSE(ev::kernels::ApproxEqual(a.data(), b.data(), n, 0, 1e-13));
+        REQUIRE(ev::kernels::ApproxEqual(a.data(), b.data(), n, 1e-9, 0));
+        REQUIRE(ev::kernels::Hash(b.data(), n) != hash);
+        b[i] = std::nan("");
+        REQUIRE_FALSE(ev::kernels::Equal(b.data(), b.data(), n));
+        REQUIRE_FALSE(ev::kernels::ApproxEqual(b.data(), b.data(), n, 1, 1));
+        b[i] = a[i];
+      }
+      if (n > 0) {
+        auto zeros = std::vector<double>(n, 0.0);
+        auto negative_zeros = std::vector<double>(n, -0.0);
+        REQUIRE(ev::kernels::Equal(zeros.data(), negative_zeros.data(), n));
+        REQUIRE(ev::kernels::Hash(zeros.data(), n) == ev::kernels::Hash(negative_zeros.data(), n));
+        const auto inf = std::numeric_limits<double>::infinity();
+        zeros.back() = inf;
+        negative_zeros.back() = inf;
+        REQUIRE(ev::kernels::ApproxEqual(zeros.data(), negative_zeros.data(), n, 0, 0));
+        negative_zeros.back() = 1e300;
+        REQUIRE_FALSE(ev::kernels::ApproxEqual(zeros.data(), negative_zeros.data(), n, 1, 1));
+      }
+    }
+    for (const auto& [n, expected] : reference) {
+      std::vector<double> values(n);
+      for (auto i = 0; i < n; ++i) {
+        values[i] = i * 1.5 - 3;
+      }
+      REQUIRE(ev::kernels::Hash(values.data(), n) == expected);
+    }
+  }
+}
+
+TEST_CASE("Hamming kernels agree with a bit-by-bit count at every supported level") {
+  RestoreIsa restore;
+  for (auto isa : {"scalar", "sse4.2", "avx2", "avx512"}) {
+    if (!ev::kernels::ForceKernelIsa(isa)) {
+      continue;
+    }
+    for (auto words : {0, 1, 3, 4, 5, 9}) {
+      std::vector<std::uint64_t> rows(3 * words);
+      for (auto i = 0; i < 3 * words; ++i) {
+        rows[i] = 0x9e3779b97f4a7c15ULL * (i + 1) ^ (0xffULL << (i % 57));
+      }
+      int expected[3] = {0, 0, 0};
+      for (auto r = 0; r < 3; ++r) {
+        for (auto w = 0; w < words; ++w) {
+          for (auto bit = 0; bit < 64; ++bit) {
+            expected[r] += ((rows[w] ^ rows[r * words + w]) >> bit) & 1;
+          }
+        }
+      }
+      int out[3];
+      ev::kernels::HammingRows(rows.data(), rows.data(), words, 3, out);
+      for (auto r = 0; r < 3; ++r) {
+        REQUIRE(ev::kernels::Hamming(rows.data(), rows.data() + r * words, words) == expected[r]);
+        REQUIRE(out[r] == expected[r]);
+      }
+      REQUIRE(expected[0] == 0);
+    }
+  }
+}
+
+TEST_CASE("8-bit code kernels agree with plain loops at every supported level") {
+  RestoreIsa restore;
+  for (auto isa : {"scalar", "sse4.2", "avx2", "avx512"}) {
+    if (!ev::kernels::ForceKernelIsa(isa)) {
+      continue;
+    }
+    for (auto n : {0, 1, 3, 7, 8, 9, 33, 100, 70000}) {
+      std::vector<std::uint8_t> ua(n), ub(n);
+      std::vector<std::int8_t> sa(n), sb(n);
+      std::vector<double> w(n);
+      std::int64_t expected_u = 0, expected_s = 0;
+      double expected_wu = 0, expected_ws = 0;
+      for (auto i = 0; i < n; ++i) {
+        ua[i] = i % 5 == 0 ? 255 : static_cast<std::uint8_t>(i * 37);
+        ub[i] = i % 3 == 0 ? 255 : static_cast<std::uint8_t>(i * 11);
+        sa[i] = i % 5 == 0 ? -128 : static_cast<std::int8_t>(i * 37);
+        sb[i] = i % 3 == 0 ? -128 : static_cast<std::int8_t>(i * 11);
+        w[i] = (i % 7) * 0.5 - 1.0;
+        expected_u += ua[i] * ub[i];
+        expected_s += sa[i] * sb[i];
+        expected_wu += w[i] * ua[i];
+        expected_ws += w[i] * sa[i];
+      }
+      REQUIRE(ev::kernels::DotU8(ua.data(), ub.data(), n) == expected_u);
+      REQUIRE(ev::kernels::DotI8(sa.data(), sb.data(), n) == expected_s);
+      REQUIRE(ev::kernels::DotF64U8(w.data(), ua.data(), n) == Approx(expected_wu));
+      REQUIRE(ev::kernels::DotF64I8(w.data(), sa.data(), n) == Approx(expected_ws));
+    }
+  }
+}
+
+TEST_CASE("Row-list kernels match the single-row kernels at every supported level") {
+  RestoreIsa restore;
+  for (auto isa : {"scalar", "sse4.2", "avx2", "avx512"}) {
+    if (!ev::kernels::ForceKernelIsa(isa)) {
+      continue;
+    }
+    for (auto n : {1, 9, 100}) {
+      const auto x = MakeValues(n, 0.5);
+      std::vector<std::vector<double>> storage;
+      for (auto r = 0; r < 53; ++r) {
+        storage.push_back(MakeValues(n, r + 1.0));
+      }
+      // Rows visited out of order, some more than once, as in a candidate list.
+      std::vector<const double*> rows;
+      for (auto r = 0; r < 53; ++r) {
+        rows.push_back(storage[(r * 17) % 53].data());
+      }
+      for (auto count : {0, 1, 16, 53}) {
+        for (auto distance : {0, 3}) {
+          for (auto stream : {false, true}) {
+            // One spare element so the output can start misaligned too.
+            std::vector<double> dots(count + 1), distances(count + 1);
+            ev::kernels::DotRows(x.data(), rows.data(), n, count, dots.data(), distance, stream);
+            ev::kernels::SquaredL2Rows(x.data(), rows.data(), n, count, distances.data() + 1,
+                                       distance, stream);
+            for (auto r = 0; r < count; ++r) {
+              REQUIRE(dots[r] == ev::kernels::Dot(x.data(), rows[r], n));
+              REQUIRE(distances[r + 1] == ev::kernels::SquaredL2(x.data(), rows[r], n));
+            }
+          }
+        }
+      }
+    }
+  }
+}
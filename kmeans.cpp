@@ -0,0 +1,290 @@
+#include "assignments/ev/kmeans.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "assignments/ev/euclidean_vector.h"
+#include "assignments/ev/euclidean_vector_batch.h"
+#include "assignments/ev/kernels.h"
+#include "assignments/ev/parallel.h"
+
+namespace {
+
+// Number of points handed to a thread at a time in the assignment step.
+constexpr int kAssignGrain = 256;
+
+std::vector<double> SquaredNorms(const EuclideanVectorBatch& batch) {
+  std::vector<double> norms(batch.GetNumVectors());
+  for (auto i = 0; i < batch.GetNumVectors(); ++i) {
+    norms[i] = ev::kernels::Dot(batch.Row(i), batch.Row(i), batch.GetNumDimensions());
+  }
+  return norms;
+}
+
+// Returns the index of the centroid nearest to x and stores the squared distance in distance.
+// Centroids are ranked by |c|^2 - 2 x.c, the squared distance less the constant |x|^2, scoring
+// four centroids per Dot4 call so x is loaded once for all four; leftover centroids go through
+// Dot4 with the row repeated. The distance to the winner is then computed exactly.
+int NearestCentroid(const double* x,
+                    const EuclideanVectorBatch& centroids,
+                    const std::vector<double>& centroid_norms,
+                    double& distance) {
+  const auto d = centroids.GetNumDimensions();
+  const auto k = centroids.GetNumVectors();
+  auto best = 0;
+  auto best_score = std::numeric_limits<double>::infinity();
+  double dots[4];
+  auto c = 0;
+  for (; c + 4 <= k; c += 4) {
+    const double* y[4] = {centroids.Row(c), centroids.Row(c + 1), centroids.Row(c + 2),
+                          centroids.Row(c + 3)};
+    ev::kernels::Dot4(x, y, d, dots);
+    for (auto r = 0; r < 4; ++r) {
+      const auto score = centroid_norms[c + r] - 2 * dots[r];
+      if (score < best_score) {
+        best_score = score;
+        best = c + r;
+      }
+    }
+  }
+  for (; c < k; ++c) {
+    const auto* yc = centroids.Row(c);
+    const double* y[4] = {yc, yc, yc, yc};
+    ev::kernels::Dot4(x, y, d, dots);
+    const auto score = centroid_norms[c] - 2 * dots[0];
+    if (score < best_score) {
+      best_score = score;
+      best = c;
+    }
+  }
+  distance = ev::kernels::SquaredL2(x, centroids.Row(best), d);
+  return best;
+}
+
+// Assigns every row of data to its nearest centroid. Returns how many assignments changed.
+int AssignAll(const EuclideanVectorBatch& data,
+              const EuclideanVectorBatch& centroids,
+              std::vector<int>& assignments,
+              std::vector<double>& distances,
+              int num_threads) {
+  std::atomic<int> changed{0};
+  const auto centroid_norms = SquaredNorms(centroids);
+  ev::detail::ParallelFor(
+      0, data.GetNumVectors(), kAssignGrain, num_threads, [&](std::int64_t lo, std::int64_t hi) {
+        auto local_changed = 0;
+        for (auto i = lo; i < hi; ++i) {
+          const auto c = NearestCentroid(data.Row(static_cast<int>(i)), centroids, centroid_norms,
+                                         distances[i]);
+          if (c != assignments[i]) {
+            assignments[i] = c;
+            ++local_changed;
+          }
+        }
+        changed += local_changed;
+      });
+  return changed;
+}
+
+// k-means++: the first centroid is picked uniformly, every further one with probability
+// proportional to its squared distance from the nearest centroid chosen so far.
+EuclideanVectorBatch InitialiseCentroids(const EuclideanVectorBatch& data,
+                                         int k,
+                                         std::mt19937_64& rng,
+                                         int num_threads) {
+  const auto n = data.GetNumVectors();
+  const auto d = data.GetNumDimensions();
+  EuclideanVectorBatch centroids(k, d);
+
+  auto pick = std::uniform_int_distribution<int>(0, n - 1)(rng);
+  std::copy(data.Row(pick), data.Row(pick) + d, centroids.Row(0));
+
+  std::vector<double> min_distance(n, std::numeric_limits<double>::infinity());
+  for (auto c = 0; c < k; ++c) {
+    if (c > 0) {
+      double total = 0;
+      for (auto dist : min_distance) {
+        total += dist;
+      }
+      if (total > 0) {
+        auto target = std::uniform_real_distribution<double>(0, total)(rng);
+        pick = n - 1;
+        for (auto i = 0; i < n; ++i) {
+          target -= min_distance[i];
+          if (target < 0) {
+            pick = i;
+            break;
+          }
+        }
+      } else {
+        // Fewer distinct points than clusters: any point will do.
+        pick = std::uniform_int_distribution<int>(0, n - 1)(rng);
+      }
+      std::copy(data.Row(pick), data.Row(pick) + d, centroids.Row(c));
+    }
+    if (c == k - 1) {
+      break;
+    }
+
+    ev::detail::ParallelFor(
+        0, n, kAssignGrain, num_threads, [&](std::int64_t lo, std::int64_t hi) {
+          for (auto i = lo; i < hi; ++i) {
+            const auto dist =
+                ev::kernels::SquaredL2(data.Row(static_cast<int>(i)), centroids.Row(c), d);
+            min_distance[i] = std::min(min_distance[i], dist);
+          }
+        });
+  }
+  return centroids;
+}
+
+// Recomputes every centroid as the mean of its members. Points are first grouped by cluster so
+// each centroid can be summed by one thread, which keeps the result independent of the thread
+// count without per-thread partial sums. Clusters left empty are re-seeded with the point that is
+// furthest from its centroid.
+void UpdateCentroids(const EuclideanVectorBatch& data,
+                     const std::vector<int>& assignments,
+                     std::vector<double>& distances,
+                     EuclideanVectorBatch& centroids,
+                     int num_threads) {
+  const auto n = data.GetNumVectors();
+  const auto k = centroids.GetNumVectors();
+  const auto d = data.GetNumDimensions();
+
+  std::vector<int> offsets(k + 1, 0);
+  for (auto c : assignments) {
+    ++offsets[c + 1];
+  }
+  for (auto c = 0; c < k; ++c) {
+    offsets[c + 1] += offsets[c];
+  }
+  std::vector<int> members(n);
+  auto cursor = offsets;
+  for (auto i = 0; i < n; ++i) {
+    members[cursor[assignments[i]]++] = i;
+  }
+
+  ev::detail::ParallelFor(0, k, 1, num_threads, [&](std::int64_t lo, std::int64_t hi) {
+    for (auto c = static_cast<int>(lo); c < hi; ++c) {
+      const auto count = offsets[c + 1] - offsets[c];
+      if (count == 0) {
+        continue;
+      }
+      auto* centroid = centroids.Row(c);
+      std::fill(centroid, centroid + d, 0.0);
+      for (auto m = offsets[c]; m < offsets[c + 1]; ++m) {
+        ev::kernels::Add(centroid, data.Row(members[m]), d);
+      }
+      for (auto j = 0; j < d; ++j) {
+        centroid[j] /= count;
+      }
+    }
+  });
+
+  for (auto c = 0; c < k; ++c) {
+    if (offsets[c + 1] == offsets[c]) {
+      const auto far = static_cast<int>(
+          std::max_element(distances.begin(), distances.end()) - distances.begin());
+      std::copy(data.Row(far), data.Row(far) + d, centroids.Row(c));
+      distances[far] = 0;
+    }
+  }
+}
+
+// Largest distance any centroid moved between before and after.
+double MaxShift(const EuclideanVectorBatch& before, const EuclideanVectorBatch& after) {
+  double shift = 0;
+  for (auto c = 0; c < before.GetNumVectors(); ++c) {
+    shift = std::max(shift, ev::kernels::SquaredL2(before.Row(c), after.Row(c),
+                                                   before.GetNumDimensions()));
+  }
+  return std::sqrt(shift);
+}
+
+}  // namespace
+
+KMeansResult KMeans(const EuclideanVectorBatch& data, int k, const KMeansOptions& options) {
+  const auto n = data.GetNumVectors();
+  if (k < 1 || k > n) {
+    throw EuclideanVectorError("Cannot form " + std::to_string(k) + " clusters from " +
+                               std::to_string(n) + " vectors");
+  }
+  const auto d = data.GetNumDimensions();
+  const auto threads = options.num_threads;
+
+  std::mt19937_64 rng(options.seed);
+  auto centroids = InitialiseCentroids(data, k, rng, threads);
+  std::vector<int> assignments(n, -1);
+  std::vector<double> distances(n, 0.0);
+
+  auto iterations = 0;
+  if (options.mini_batch_size > 0) {
+    const auto batch_size = options.mini_batch_size;
+    std::uniform_int_distribution<int> pick(0, n - 1);
+    std::vector<int> sample(batch_size);
+    std::vector<int> sample_assignments(batch_size);
+    std::vector<std::int64_t> counts(k, 0);
+    while (iterations < options.max_iterations) {
+      ++iterations;
+      for (auto& s : sample) {
+        s = pick(rng);
+      }
+      const auto centroid_norms = SquaredNorms(centroids);
+      ev::detail::ParallelFor(
+          0, batch_size, kAssignGrain, threads, [&](std::int64_t lo, std::int64_t hi) {
+            for (auto j = lo; j < hi; ++j) {
+              double unused;
+              sample_assignments[j] =
+                  NearestCentroid(data.Row(sample[j]), centroids, centroid_norms, unused);
+            }
+          });
+
+      // Per-centre learning rate 1 / (points seen so far), applied in sample order.
+      const auto before = centroids;
+      for (auto j = 0; j < batch_size; ++j) {
+        const auto c = sample_assignments[j];
+        const auto eta = 1.0 / static_cast<double>(++counts[c]);
+        auto* centroid = centroids.Row(c);
+        const auto* x = data.Row(sample[j]);
+        for (auto t = 0; t < d; ++t) {
+          centroid[t] += eta * (x[t] - centroid[t]);
+        }
+      }
+      if (MaxShift(before, centroids) <= options.tolerance) {
+        break;
+      }
+    }
+  } else {
+    while (iterations < options.max_iterations) {
+      ++iterations;
+      const auto changed = AssignAll(data, centroids, assignments, distances, threads);
+      if (changed == 0) {
+        break;
+      }
+      const auto before = centroids;
+      UpdateCentroids(data, assignments, distances, centroids, threads);
+      if (MaxShift(before, centroids) <= options.tolerance) {
+        break;
+      }
+    }
+  }
+
+  AssignAll(data, centroids, assignments, distances, threads);
+  double inertia = 0;
+  for (auto dist : distances) {
+    inertia += dist;
+  }
+  return KMeansResult{centroids.ToVectors(), std::move(assignments), inertia, iterations};
+}
+
+KMeansResult KMeans(const std::vector<EuclideanVector>& data,
+                    int k,
+                    const KMeansOptions& options) {
+  return KMeans(EuclideanVectorBatch(data), k, options);
+}
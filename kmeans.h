@@ -0,0 +1,83 @@
+#ifndef ASSIGNMENTS_EV_KMEANS_H_
+#define ASSIGNMENTS_EV_KMEANS_H_
+
+#include <cstdint>
+#include <vector>
+
+#include "assignments/ev/euclidean_vector.h"
+#include "assignments/ev/euclidean_vector_batch.h"
+
+/*
+ * Tuning knobs for KMeans. The defaults run full-batch Lloyd iterations.
+ */
+struct KMeansOptions {
+  /*
+   * Upper bound on the number of Lloyd (or mini-batch) iterations.
+   */
+  int max_iterations = 100;
+
+  /*
+   * Iteration stops early once no centroid moves further than this (Euclidean distance) in one
+   * iteration, or once no point changes cluster.
+   */
+  double tolerance = 1e-6;
+
+  /*
+   * When > 0, each iteration updates the centroids from this many randomly sampled points
+   * (Sculley's mini-batch k-means) instead of from the whole dataset.
+   */
+  int mini_batch_size = 0;
+
+  /*
+   * Seed for k-means++ initialisation and mini-batch sampling. The same seed, data and options
+   * always give the same clustering.
+   */
+  std::uint64_t seed = 0;
+
+  /*
+   * Maximum number of threads to use. 0 means one per hardware thread.
+   */
+  int num_threads = 0;
+};
+
+struct KMeansResult {
+  /*
+   * The k cluster centres.
+   */
+  std::vector<EuclideanVector> centroids;
+
+  /*
+   * For every input vector, the index of its nearest centroid.
+   */
+  std::vector<int> assignments;
+
+  /*
+   * Sum of squared distances from every input vector to its nearest centroid.
+   */
+  double inertia;
+
+  /*
+   * Number of iterations actually run.
+   */
+  int iterations;
+};
+
+/*
+ * Clusters the vectors into k groups. Centroids are seeded with k-means++ and then refined with
+ * Lloyd iterations (or mini-batch updates, see KMeansOptions). Assigning points to centroids and
+ * recomputing the centroids both run in parallel.
+ * When: k < 1 or k > number of vectors
+ * Throw: "Cannot form K clusters from N vectors"
+ */
+KMeansResult KMeans(const EuclideanVectorBatch& data, int k, const KMeansOptions& options = {});
+
+/*
+ * As above, after copying the vectors into an EuclideanVectorBatch.
+ * When: the vectors do not all have the same number of dimensions
+ * Throw: "Dimensions of LHS(X) and RHS(Y) do not match"
+ */
+KMeansResult KMeans(const std::vector<EuclideanVector>& data,
+                    int k,
+                    const KMeansOptions& options = {});
+
+#endif  // ASSIGNMENTS_EV_KMEANS_H_
@@ -0,0 +1,101 @@
+/*
+
+  == Explanation and rational of testing ==
+
+  We cluster three well separated blobs, where the right answer is known: every blob must end up
+  in its own cluster and each centroid must land near the blob's centre. Both the full Lloyd path
+  and the mini-batch path are checked this way. We also check that the result does not depend on
+  the number of threads, and the exception thrown on a bad number of clusters.
+
+*/
+
+#include "assignments/ev/kmeans.h"
+
+#include <cmath>
+#include <vector>
+
+#include "catch.h"
+
+namespace {
+
+// 3 blobs of 200 points around (0, 0), (10, 10) and (-10, 10); point i belongs to blob i % 3.
+std::vector<EuclideanVector> MakeBlobs() {
+  const double centres[3][2] = {{0, 0}, {10, 10}, {-10, 10}};
+  std::vector<EuclideanVector> points;
+  for (auto i = 0; i < 600; ++i) {
+    const auto& centre = centres[i % 3];
+    std::vector<double> l{centre[0] + std::sin(i * 0.7), centre[1] + std::cos(i * 1.3)};
+    points.emplace_back(l.begin(), l.end());
+  }
+  return points;
+}
+
+void RequireBlobsRecovered(const KMeansResult& result) {
+  REQUIRE(result.centroids.size() == 3);
+  REQUIRE(result.assignments.size() == 600);
+  for (auto i = 3; i < 600; ++i) {
+    REQUIRE(result.assignments[i] == result.assignments[i % 3]);
+  }
+  REQUIRE(result.assignments[0] != result.assignments[1]);
+  REQUIRE(result.assignments[1] != result.assignments[2]);
+  REQUIRE(result.assignments[0] != result.assignments[2]);
+
+  std::vector<double> l{10, 10};
+  const EuclideanVector centre{l.begin(), l.end()};
+  const auto& centroid = result.centroids[result.assignments[1]];
+  REQUIRE((centroid - centre).GetEuclideanNorm() < 0.5);
+}
+
+}  // namespace
+
+TEST_CASE("KMeans with Lloyd iterations") {
+  const auto points = MakeBlobs();
+
+  SECTION("TEST CASE 1 Every blob is its own cluster") {
+    const auto result = KMeans(points, 3, {100, 1e-9, 0, 42, 2});
+    RequireBlobsRecovered(result);
+    REQUIRE(result.iterations < 100);
+    REQUIRE(result.inertia > 0);
+  }
+
+  SECTION("TEST CASE 2 The result does not depend on the number of threads") {
+    const auto one = KMeans(points, 3, {100, 1e-9, 0, 7, 1});
+    const auto many = KMeans(points, 3, {100, 1e-9, 0, 7, 4});
+    REQUIRE(one.assignments == many.assignments);
+    REQUIRE(one.centroids == many.centroids);
+    REQUIRE(one.inertia == many.inertia);
+  }
+
+  SECTION("TEST CASE 3 One cluster per point gives zero inertia") {
+    std::vector<EuclideanVector> few(points.begin(), points.begin() + 5);
+    REQUIRE(KMeans(few, 5).inertia == 0.0);
+  }
+
+  SECTION("TEST CASE 4 Every point is assigned its nearest centroid") {
+    // 7 clusters: one block of four centroids and three left over.
+    const auto result = KMeans(points, 7, {100, 1e-9, 0, 3, 2});
+    double inertia = 0;
+    for (auto i = 0; i < 600; ++i) {
+      const auto& assigned = result.centroids[result.assignments[i]];
+      const auto distance = std::pow((points[i] - assigned).GetEuclideanNorm(), 2);
+      for (const auto& centroid : result.centroids) {
+        REQUIRE(distance <= std::pow((points[i] - centroid).GetEuclideanNorm(), 2) + 1e-9);
+      }
+      inertia += distance;
+    }
+    REQUIRE(result.inertia == Approx(inertia));
+  }
+}
+
+TEST_CASE("KMeans with mini-batch updates") {
+  const auto points = MakeBlobs();
+  const auto result = KMeans(points, 3, {200, 0, 64, 42, 2});
+  RequireBlobsRecovered(result);
+  REQUIRE(result.iterations == 200);
+}
+
+TEST_CASE("KMeans rejects a bad number of clusters") {
+  const auto points = MakeBlobs();
+  REQUIRE_THROWS_WITH(KMeans(points, 0), Catch::Contains("Cannot form 0 clusters from 600"));
+  REQUIRE_THROWS_WITH(KMeans(points, 601), Catch::Contains("Cannot form 601 clusters"));
+}
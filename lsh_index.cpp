@@ -0,0 +1,321 @@
+#include "assignments/ev/lsh_index.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <random>
+#include <string>
+#include <tuple>
+#include <vector>
+
+#include "assignments/ev/euclidean_matrix.h"
+#include "assignments/ev/euclidean_vector.h"
+#include "assignments/ev/euclidean_vector_batch.h"
+#include "assignments/ev/kernels.h"
+#include "assignments/ev/neighbor.h"
+#include "assignments/ev/parallel.h"
+
+namespace {
+
+constexpr char kZeroNormCosine[] =
+    "EuclideanVector with euclidean normal of 0 does not have a cosine similarity";
+constexpr char kNotFinite[] =
+    "EuclideanVector with a magnitude that is not finite cannot be hashed";
+
+// Bucket number of a p-stable hash function. Saturates rather than overflowing the cast when the
+// projection is huge compared with the width. Finite vectors can still project to NaN (inf - inf
+// when the magnitudes are near the limit of a double); those all share bucket 0.
+std::int64_t Quantise(double projection, double offset, double width) noexcept {
+  constexpr auto kLimit = 9.2e18;
+  const auto bucket = std::floor((projection + offset) / width);
+  if (std::isnan(bucket)) {
+    return 0;
+  }
+  return static_cast<std::int64_t>(std::clamp(bucket, -kLimit, kLimit));
+}
+
+bool AllFinite(const double* v, int n) noexcept {
+  return std::all_of(v, v + n, [](double x) { return std::isfinite(x); });
+}
+
+// Final avalanche of splitmix64, so that nearby bucket numbers land in unrelated hash slots.
+std::uint64_t Mix(std::uint64_t x) noexcept {
+  x ^= x >> 30;
+  x *= 0xbf58476d1ce4e5b9ULL;
+  x ^= x >> 27;
+  x *= 0x94d049bb133111ebULL;
+  return x ^ (x >> 31);
+}
+
+void CheckDimensions(int expected, int actual) {
+  if (expected != actual) {
+    throw EuclideanVectorError("Dimensions of LHS(" + std::to_string(expected) + ") and RHS(" +
+                               std::to_string(actual) + ") do not match");
+  }
+}
+
+}  // namespace
+
+LshIndex::LshIndex(int num_dimensions, const LshOptions& options)
+  : num_dimensions_{num_dimensions}, options_{options} {
+  if (num_dimensions < 1 || options.num_tables < 1 || options.num_bits < 1 ||
+      options.num_bits > 64) {
+    throw EuclideanVectorError("Cannot build an LSH index with " +
+                               std::to_string(options.num_tables) + " tables of " +
+                               std::to_string(options.num_bits) + " bits over " +
+                               std::to_string(num_dimensions) + " dimensions");
+  }
+  if (options.metric == PairwiseMetric::kDot) {
+    throw EuclideanVectorError("LSH index requires the kCosine or kSquaredL2 metric");
+  }
+  if (!std::isfinite(options.bucket_width) || options.bucket_width <= 0) {
+    throw EuclideanVectorError("LSH index requires a positive, finite bucket width");
+  }
+
+  const auto functions = options.num_tables * options.num_bits;
+  std::mt19937_64 rng(options.seed);
+  std::normal_distribution<double> normal(0.0, 1.0);
+  planes_ = EuclideanMatrix(functions, num_dimensions);
+  for (auto r = 0; r < functions; ++r) {
+    for (auto c = 0; c < num_dimensions; ++c) {
+      planes_.Row(r)[c] = normal(rng);
+    }
+  }
+  if (options.metric == PairwiseMetric::kSquaredL2) {
+    std::uniform_real_distribution<double> offset(0.0, options.bucket_width);
+    offsets_.resize(functions);
+    for (auto& o : offsets_) {
+      o = offset(rng);
+    }
+  }
+  tables_.resize(options.num_tables);
+}
+
+// All num_tables * num_bits projections of v, four hash functions per Dot4 call.
+void LshIndex::Project(const double* v, double* projections) const {
+  const auto functions = planes_.GetNumRows();
+  auto r = 0;
+  for (; r + 4 <= functions; r += 4) {
+    const double* rows[4] = {planes_.Row(r), planes_.Row(r + 1), planes_.Row(r + 2),
+                             planes_.Row(r + 3)};
+    ev::kernels::Dot4(v, rows, num_dimensions_, projections + r);
+  }
+  for (; r < functions; ++r) {
+    projections[r] = ev::kernels::Dot(v, planes_.Row(r), num_dimensions_);
+  }
+}
+
+// Key of the bucket of table for the given projections. When probe >= 0, hash function probe
+// is moved to the neighbouring bucket on the side given by delta (for kCosine, its bit is flipped).
+std::uint64_t LshIndex::TableKey(const double* projections, int table, int probe, int delta) const {
+  const auto bits = options_.num_bits;
+  const auto* p = projections + table * bits;
+  std::uint64_t key = 0;
+  if (options_.metric == PairwiseMetric::kCosine) {
+    for (auto b = 0; b < bits; ++b) {
+      const auto bit = (p[b] >= 0) != (b == probe);
+      key |= static_cast<std::uint64_t>(bit) << b;
+    }
+    return key;
+  }
+  const auto* offsets = offsets_.data() + table * bits;
+  for (auto b = 0; b < bits; ++b) {
+    auto bucket = Quantise(p[b], offsets[b], options_.bucket_width);
+    if (b == probe) {
+      bucket += delta;
+    }
+    key = Mix(key ^ static_cast<std::uint64_t>(bucket));
+  }
+  return key;
+}
+
+void LshIndex::AddToTables(int id, const double* projections) {
+  for (auto t = 0; t < options_.num_tables; ++t) {
+    const auto key = TableKey(projections, t, -1, 0);
+    keys_[static_cast<std::size_t>(id) * options_.num_tables + t] = key;
+    tables_[t][key].push_back(id);
+  }
+}
+
+// Copies v into a free slot (reusing the id of a removed vector if there is one).
+int LshIndex::StoreVector(const double* v, double norm) {
+  int id;
+  if (!free_ids_.empty()) {
+    id = free_ids_.back();
+    free_ids_.pop_back();
+  } else {
+    id = static_cast<int>(live_.size());
+    live_.push_back(0);
+    norms_.push_back(0);
+    keys_.resize(keys_.size() + options_.num_tables);
+    vectors_.resize(vectors_.size() + num_dimensions_);
+  }
+  std::copy(v, v + num_dimensions_,
+            vectors_.begin() + static_cast<std::ptrdiff_t>(id) * num_dimensions_);
+  norms_[id] = norm;
+  live_[id] = 1;
+  ++num_live_;
+  return id;
+}
+
+int LshIndex::Insert(const EuclideanVector& v) {
+  CheckDimensions(num_dimensions_, v.GetNumDimensions());
+  if (!AllFinite(v.data(), num_dimensions_)) {
+    throw EuclideanVectorError(kNotFinite);
+  }
+  const auto norm = std::sqrt(ev::kernels::Dot(v.data(), v.data(), num_dimensions_));
+  if (options_.metric == PairwiseMetric::kCosine && norm == 0) {
+    throw EuclideanVectorError(kZeroNormCosine);
+  }
+  std::vector<double> projections(planes_.GetNumRows());
+  Project(v.data(), projections.data());
+
+  const auto id = StoreVector(v.data(), norm);
+  AddToTables(id, projections.data());
+  return id;
+}
+
+std::vector<int> LshIndex::Insert(const EuclideanVectorBatch& batch, int num_threads) {
+  CheckDimensions(num_dimensions_, batch.GetNumDimensions());
+  const auto n = batch.GetNumVectors();
+  const auto functions = planes_.GetNumRows();
+  std::vector<double> norms(n);
+  std::vector<char> finite(n);
+  std::vector<double> projections(static_cast<std::size_t>(n) * functions);
+  ev::detail::ParallelFor(0, n, 64, num_threads, [&](std::int64_t lo, std::int64_t hi) {
+    for (auto i = lo; i < hi; ++i) {
+      const auto* row = batch.Row(static_cast<int>(i));
+      finite[i] = AllFinite(row, num_dimensions_);
+      norms[i] = std::sqrt(ev::kernels::Dot(row, row, num_dimensions_));
+      Project(row, projections.data() + i * functions);
+    }
+  });
+  if (std::find(finite.begin(), finite.end(), 0) != finite.end()) {
+    throw EuclideanVectorError(kNotFinite);
+  }
+  if (options_.metric == PairwiseMetric::kCosine &&
+      std::find(norms.begin(), norms.end(), 0.0) != norms.end()) {
+    throw EuclideanVectorError(kZeroNormCosine);
+  }
+
+  std::vector<int> ids(n);
+  for (auto i = 0; i < n; ++i) {
+    const auto id = StoreVector(batch.Row(i), norms[i]);
+    AddToTables(id, projections.data() + static_cast<std::size_t>(i) * functions);
+    ids[i] = id;
+  }
+  return ids;
+}
+
+bool LshIndex::Remove(int id) {
+  if (!Contains(id)) {
+    return false;
+  }
+  const auto* keys = keys_.data() + static_cast<std::size_t>(id) * options_.num_tables;
+  for (auto t = 0; t < options_.num_tables; ++t) {
+    const auto bucket = tables_[t].find(keys[t]);
+    auto& ids = bucket->second;
+    *std::find(ids.begin(), ids.end(), id) = ids.back();
+    ids.pop_back();
+    if (ids.empty()) {
+      tables_[t].erase(bucket);
+    }
+  }
+  live_[id] = 0;
+  free_ids_.push_back(id);
+  --num_live_;
+  return true;
+}
+
+bool LshIndex::Contains(int id) const noexcept {
+  return id >= 0 && id < static_cast<int>(live_.size()) && live_[id];
+}
+
+EuclideanVector LshIndex::GetVector(int id) const {
+  if (!Contains(id)) {
+    throw EuclideanVectorError("Index " + std::to_string(id) +
+                               " is not valid for this LshIndex object");
+  }
+  const auto begin = vectors_.begin() + static_cast<std::ptrdiff_t>(id) * num_dimensions_;
+  return EuclideanVector(begin, begin + num_dimensions_);
+}
+
+std::vector<int> LshIndex::Candidates(const EuclideanVector& query) const {
+  CheckDimensions(num_dimensions_, query.GetNumDimensions());
+  const auto bits = options_.num_bits;
+  std::vector<double> projections(planes_.GetNumRows());
+  Project(query.data(), projections.data());
+
+  // (distance to the bucket boundary, hash function, direction) of every possible single-step
+  // probe of one table, nearest boundary first.
+  std::vector<std::tuple<double, int, int>> probes;
+  std::vector<int> candidates;
+  for (auto t = 0; t < options_.num_tables; ++t) {
+    probes.clear();
+    if (options_.num_probes > 0) {
+      const auto* p = projections.data() + t * bits;
+      for (auto b = 0; b < bits; ++b) {
+        if (options_.metric == PairwiseMetric::kCosine) {
+          probes.emplace_back(std::abs(p[b]), b, 0);
+        } else {
+          const auto offset = offsets_[t * bits + b];
+          const auto position = (p[b] + offset) / options_.bucket_width;
+          const auto fraction = position - std::floor(position);
+          probes.emplace_back(fraction, b, -1);
+          probes.emplace_back(1 - fraction, b, 1);
+        }
+      }
+      const auto used = std::min<std::size_t>(probes.size(), options_.num_probes);
+      std::partial_sort(probes.begin(), probes.begin() + used, probes.end());
+      probes.resize(used);
+    }
+
+    auto visit = [&](std::uint64_t key) {
+      const auto bucket = tables_[t].find(key);
+      if (bucket != tables_[t].end()) {
+        candidates.insert(candidates.end(), bucket->second.begin(), bucket->second.end());
+      }
+    };
+    visit(TableKey(projections.data(), t, -1, 0));
+    for (const auto& [distance, function, delta] : probes) {
+      visit(TableKey(projections.data(), t, function, delta));
+    }
+  }
+  std::sort(candidates.begin(), candidates.end());
+  candidates.erase(std::unique(candidates.begin(), candidates.end()), candidates.end());
+  return candidates;
+}
+
+double LshIndex::Score(const double* query, double query_norm, int id) const {
+  const auto* v = vectors_.data() + static_cast<std::ptrdiff_t>(id) * num_dimensions_;
+  if (options_.metric == PairwiseMetric::kSquaredL2) {
+    return ev::kernels::SquaredL2(query, v, num_dimensions_);
+  }
+  return ev::kernels::Dot(query, v, num_dimensions_) / (query_norm * norms_[id]);
+}
+
+std::vector<Neighbor> LshIndex::Query(const EuclideanVector& query, int k) const {
+  CheckDimensions(num_dimensions_, query.GetNumDimensions());
+  if (!AllFinite(query.data(), num_dimensions_)) {
+    throw EuclideanVectorError(kNotFinite);
+  }
+  const auto query_norm = std::sqrt(ev::kernels::Dot(query.data(), query.data(), num_dimensions_));
+  if (options_.metric == PairwiseMetric::kCosine && query_norm == 0) {
+    throw EuclideanVectorError(kZeroNormCosine);
+  }
+  std::vector<Neighbor> result;
+  for (auto id : Candidates(query)) {
+    result.push_back({id, Score(query.data(), query_norm, id)});
+  }
+  const auto lower_is_better = options_.metric == PairwiseMetric::kSquaredL2;
+  const auto kept = std::clamp<std::size_t>(k < 0 ? 0 : k, 0, result.size());
+  std::partial_sort(result.begin(), result.begin() + kept, result.end(),
+                    [lower_is_better](const Neighbor& a, const Neighbor& b) {
+                      if (a.score != b.score) {
+                        return lower_is_better ? a.score < b.score : a.score > b.score;
+                      }
+                      return a.index < b.index;
+                    });
+  result.resize(kept);
+  return result;
+}
@@ -0,0 +1,160 @@
+#ifndef ASSIGNMENTS_EV_LSH_INDEX_H_
+#define ASSIGNMENTS_EV_LSH_INDEX_H_
+
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+#include "assignments/ev/euclidean_matrix.h"
+#include "assignments/ev/euclidean_vector.h"
+#include "assignments/ev/euclidean_vector_batch.h"
+#include "assignments/ev/neighbor.h"
+#include "assignments/ev/pairwise.h"
+
+struct LshOptions {
+  /*
+   * kCosine hashes with random hyperplanes (one sign bit per hyperplane); kSquaredL2 hashes with
+   * p-stable (Gaussian) projections quantised into buckets of width bucket_width. Query results
+   * are scored with the same metric. kDot is not supported.
+   */
+  PairwiseMetric metric = PairwiseMetric::kCosine;
+
+  /*
+   * Number of independent hash tables. More tables raise recall at the cost of memory and query
+   * time.
+   */
+  int num_tables = 8;
+
+  /*
+   * Hash functions concatenated into each table's key, between 1 and 64. More bits make buckets
+   * smaller and more selective.
+   */
+  int num_bits = 16;
+
+  /*
+   * Quantisation width of the kSquaredL2 hash functions, in the units of the data. Roughly the
+   * distance under which two vectors should usually collide.
+   */
+  double bucket_width = 4.0;
+
+  /*
+   * Extra buckets visited per table on a query (multi-probe LSH). Probes flip the hash functions
+   * whose value was least certain, i.e. closest to a bucket boundary, one at a time. Raises recall
+   * without adding tables.
+   */
+  int num_probes = 0;
+
+  /*
+   * Seed for the hash functions. The same seed always gives the same index.
+   */
+  std::uint64_t seed = 0;
+};
+
+/*
+ * Locality-sensitive hashing index supporting inserts and removals at any time. Each vector is
+ * hashed into one bucket per table; a query collects the vectors sharing a bucket with it in any
+ * table (plus any probed buckets) and re-ranks those candidates with exact distances.
+ *
+ * Vectors are identified by the id returned from Insert. Ids of removed vectors are reused by
+ * later inserts. Const member functions may run concurrently with each other but not with
+ * Insert or Remove.
+ */
+class LshIndex {
+ public:
+  /*
+   * When: num_dimensions < 1, options.num_tables < 1, or options.num_bits is not in [1, 64]
+   * Throw: "Cannot build an LSH index with T tables of B bits over D dimensions"
+   * When: options.metric is kDot
+   * Throw: "LSH index requires the kCosine or kSquaredL2 metric"
+   * When: options.bucket_width is not finite and greater than 0
+   * Throw: "LSH index requires a positive, finite bucket width"
+   */
+  explicit LshIndex(int num_dimensions, const LshOptions& options = {});
+
+  int GetNumDimensions() const noexcept { return num_dimensions_; }
+
+  /*
+   * Number of vectors currently in the index.
+   */
+  int GetNumVectors() const noexcept { return num_live_; }
+
+  /*
+   * Adds a copy of v to the index and returns its id.
+   * When: v.GetNumDimensions() != GetNumDimensions()
+   * Throw: "Dimensions of LHS(X) and RHS(Y) do not match"
+   * When: v has a magnitude that is NaN or infinite
+   * Throw: "EuclideanVector with a magnitude that is not finite cannot be hashed"
+   * When: the metric is kCosine and v has a norm of 0
+   * Throw: "EuclideanVector with euclidean normal of 0 does not have a cosine similarity"
+   */
+  int Insert(const EuclideanVector& v);
+
+  /*
+   * Adds every vector of the batch, hashing them in parallel, and returns their ids in order.
+   * Throws in the same cases as the single-vector Insert, before anything is added.
+   */
+  std::vector<int> Insert(const EuclideanVectorBatch& batch, int num_threads = 0);
+
+  /*
+   * Removes the vector with the given id. Returns false if there is no such vector.
+   */
+  bool Remove(int id);
+
+  /*
+   * Returns whether id refers to a vector currently in the index.
+   */
+  bool Contains(int id) const noexcept;
+
+  /*
+   * Returns a copy of the vector with the given id.
+   * When: Contains(id) is false
+   * Throw: "Index X is not valid for this LshIndex object"
+   */
+  EuclideanVector GetVector(int id) const;
+
+  /*
+   * Ids of every vector sharing a (probed) bucket with query in at least one table, in
+   * increasing order and without duplicates.
+   * When: query.GetNumDimensions() != GetNumDimensions()
+   * Throw: "Dimensions of LHS(X) and RHS(Y) do not match"
+   */
+  std::vector<int> Candidates(const EuclideanVector& query) const;
+
+  /*
+   * The (at most) k best candidates for query under the index's metric, best first: highest
+   * cosine similarity or lowest squared distance, ties broken by the lower id. Neighbor::index is
+   * the vector's id.
+   * When: query.GetNumDimensions() != GetNumDimensions()
+   * Throw: "Dimensions of LHS(X) and RHS(Y) do not match"
+   * When: query has a magnitude that is NaN or infinite
+   * Throw: "EuclideanVector with a magnitude that is not finite cannot be hashed"
+   * When: the metric is kCosine and query has a norm of 0
+   * Throw: "EuclideanVector with euclidean normal of 0 does not have a cosine similarity"
+   */
+  std::vector<Neighbor> Query(const EuclideanVector& query, int k) const;
+
+ private:
+  int StoreVector(const double* v, double norm);
+  void Project(const double* v, double* projections) const;
+  std::uint64_t TableKey(const double* projections, int table, int probe, int delta) const;
+  void AddToTables(int id, const double* projections);
+  double Score(const double* query, double query_norm, int id) const;
+
+  int num_dimensions_;
+  LshOptions options_;
+  // Row t * num_bits + b is hash function b of table t.
+  EuclideanMatrix planes_;
+  std::vector<double> offsets_;
+  std::vector<std::unordered_map<std::uint64_t, std::vector<int>>> tables_;
+
+  // Vector id i lives at vectors_[i * num_dimensions_].
+  std::vector<double> vectors_;
+  std::vector<double> norms_;
+  // The bucket of vector id in table t is keys_[id * num_tables + t].
+  std::vector<std::uint64_t> keys_;
+  std::vector<char> live_;
+  std::vector<int> free_ids_;
+  int num_live_ = 0;
+};
+
+#endif  // ASSIGNMENTS_EV_LSH_INDEX_H_
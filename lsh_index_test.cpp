@@ -0,0 +1,243 @@
+/*
+
+  == Explanation and rational of testing ==
+
+  LSH is approximate, so the tests check the guarantees it does give rather than exact recall:
+  a vector already in the index always collides with itself and comes back first with its exact
+  score, query results are the candidates ranked by exact distance, extra probes only ever add
+  candidates, and a clustered dataset is searched with high recall. Inserting one by one and as a
+  batch must build the same index. Removal is checked through queries, id reuse and GetVector.
+  Finally every error case is tested, along with vectors whose projections overflow.
+
+*/
+
+#include "assignments/ev/lsh_index.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <random>
+#include <vector>
+
+#include "assignments/ev/euclidean_vector.h"
+#include "assignments/ev/euclidean_vector_batch.h"
+#include "assignments/ev/neighbor.h"
+#include "assignments/ev/pairwise.h"
+#include "catch.h"
+
+namespace {
+
+// n points scattered closely around num_clusters random centres.
+std::vector<EuclideanVector> MakeClusters(int n, int num_clusters, int dimensions) {
+  std::mt19937_64 rng(42);
+  std::normal_distribution<double> normal(0.0, 1.0);
+  std::vector<EuclideanVector> centres;
+  for (auto c = 0; c < num_clusters; ++c) {
+    EuclideanVector centre(dimensions);
+    for (auto j = 0; j < dimensions; ++j) {
+      centre[j] = normal(rng) * 10;
+    }
+    centres.push_back(centre);
+  }
+  std::vector<EuclideanVector> points;
+  for (auto i = 0; i < n; ++i) {
+    auto p = centres[i % num_clusters];
+    for (auto j = 0; j < dimensions; ++j) {
+      p[j] += normal(rng) * 0.1;
+    }
+    points.push_back(p);
+  }
+  return points;
+}
+
+double ExactScore(PairwiseMetric metric, const EuclideanVector& a, const EuclideanVector& b) {
+  if (metric == PairwiseMetric::kSquaredL2) {
+    const auto norm = (a - b).GetEuclideanNorm();
+    return norm * norm;
+  }
+  return (a * b) / (a.GetEuclideanNorm() * b.GetEuclideanNorm());
+}
+
+LshOptions MakeOptions(PairwiseMetric metric, int num_probes = 0) {
+  LshOptions options;
+  options.metric = metric;
+  options.num_tables = 6;
+  options.num_bits = 10;
+  options.bucket_width = 8.0;
+  options.num_probes = num_probes;
+  options.seed = 7;
+  return options;
+}
+
+}  // namespace
+
+TEST_CASE("LSH queries") {
+  const auto points = MakeClusters(400, 20, 16);
+  const auto metrics = {PairwiseMetric::kCosine, PairwiseMetric::kSquaredL2};
+  auto make_index = [&points](PairwiseMetric metric, int num_probes) {
+    LshIndex index(16, MakeOptions(metric, num_probes));
+    for (const auto& p : points) {
+      index.Insert(p);
+    }
+    return index;
+  };
+
+  SECTION("TEST CASE 1 - An indexed vector finds itself first") {
+    for (auto metric : metrics) {
+      const auto index = make_index(metric, 0);
+      REQUIRE(index.GetNumVectors() == 400);
+      for (auto i = 0; i < 400; i += 37) {
+        const auto result = index.Query(points[i], 1);
+        REQUIRE(result.size() == 1);
+        // Ties with a lower-id duplicate are impossible for this random data.
+        REQUIRE(result[0].index == i);
+        REQUIRE(result[0].score == Approx(ExactScore(metric, points[i], points[i])));
+      }
+    }
+  }
+
+  SECTION("TEST CASE 2 - Results are the candidates ranked by exact score") {
+    for (auto metric : metrics) {
+      const auto index = make_index(metric, 0);
+      const auto query = points[5] * 1.01;
+      const auto candidates = index.Candidates(query);
+      REQUIRE(std::is_sorted(candidates.begin(), candidates.end()));
+      const auto result = index.Query(query, static_cast<int>(candidates.size()) + 10);
+      REQUIRE(result.size() == candidates.size());
+      for (auto i = std::size_t{0}; i < result.size(); ++i) {
+        REQUIRE(std::binary_search(candidates.begin(), candidates.end(), result[i].index));
+        REQUIRE(result[i].score == Approx(ExactScore(metric, query, points[result[i].index])));
+        if (i > 0 && metric == PairwiseMetric::kSquaredL2) {
+          REQUIRE(result[i - 1].score <= result[i].score);
+        } else if (i > 0) {
+          REQUIRE(result[i - 1].score >= result[i].score);
+        }
+      }
+    }
+  }
+
+  SECTION("TEST CASE 3 - Probing adds candidates and finds the cluster") {
+    for (auto metric : metrics) {
+      const auto index = make_index(metric, 0);
+      const auto probed = make_index(metric, 8);
+      auto found = 0;
+      for (auto i = 0; i < 20; ++i) {
+        auto query = points[i];
+        query[0] += 0.05;
+        const auto plain = index.Candidates(query);
+        const auto more = probed.Candidates(query);
+        REQUIRE(std::includes(more.begin(), more.end(), plain.begin(), plain.end()));
+        // Every point of a cluster has the same index modulo 20.
+        for (const auto& n : probed.Query(query, 5)) {
+          found += n.index % 20 == i ? 1 : 0;
+        }
+      }
+      REQUIRE(found >= 90);
+    }
+  }
+}
+
+TEST_CASE("LSH inserts and removals") {
+  const auto points = MakeClusters(50, 5, 8);
+  const auto options = MakeOptions(PairwiseMetric::kSquaredL2, 2);
+
+  SECTION("TEST CASE 4 - Batch and single inserts build the same index") {
+    LshIndex one_by_one(8, options);
+    for (const auto& p : points) {
+      one_by_one.Insert(p);
+    }
+    LshIndex batched(8, options);
+    const auto ids = batched.Insert(EuclideanVectorBatch(points), 3);
+    REQUIRE(ids.size() == points.size());
+    for (auto i = 0; i < 50; ++i) {
+      REQUIRE(ids[i] == i);
+      REQUIRE(batched.Candidates(points[i]) == one_by_one.Candidates(points[i]));
+    }
+  }
+
+  SECTION("TEST CASE 5 - Removed vectors are no longer returned and their ids are reused") {
+    LshIndex index(8, options);
+    for (const auto& p : points) {
+      index.Insert(p);
+    }
+    REQUIRE(index.Remove(3));
+    REQUIRE_FALSE(index.Remove(3));
+    REQUIRE_FALSE(index.Remove(-1));
+    REQUIRE_FALSE(index.Remove(50));
+    REQUIRE_FALSE(index.Contains(3));
+    REQUIRE(index.GetNumVectors() == 49);
+    const auto candidates = index.Candidates(points[3]);
+    REQUIRE(std::find(candidates.begin(), candidates.end(), 3) == candidates.end());
+    REQUIRE_THROWS_WITH(index.GetVector(3),
+                        Catch::Contains("Index 3 is not valid for this LshIndex object"));
+
+    EuclideanVector replacement(8);
+    replacement[0] = 1;
+    REQUIRE(index.Insert(replacement) == 3);
+    REQUIRE(index.GetVector(3) == replacement);
+    REQUIRE(index.Query(replacement, 1)[0].index == 3);
+    REQUIRE(index.GetNumVectors() == 50);
+  }
+}
+
+TEST_CASE("LSH errors") {
+  SECTION("TEST CASE 6 - Invalid options") {
+    LshOptions options;
+    options.num_bits = 65;
+    REQUIRE_THROWS_WITH(LshIndex(4, options),
+                        Catch::Contains("Cannot build an LSH index with 8 tables of 65 bits over 4 "
+                                        "dimensions"));
+    options.num_bits = 8;
+    options.num_tables = 0;
+    REQUIRE_THROWS_WITH(LshIndex(4, options), Catch::Contains("0 tables of 8 bits"));
+    options.num_tables = 2;
+    REQUIRE_THROWS_WITH(LshIndex(0, options), Catch::Contains("over 0 dimensions"));
+    for (auto width : {0.0, -1.0, std::nan(""), std::numeric_limits<double>::infinity()}) {
+      options.bucket_width = width;
+      REQUIRE_THROWS_WITH(LshIndex(4, options),
+                          Catch::Contains("LSH index requires a positive, finite bucket width"));
+    }
+    options.bucket_width = 4;
+    options.metric = PairwiseMetric::kDot;
+    REQUIRE_THROWS_WITH(LshIndex(4, options),
+                        Catch::Contains("LSH index requires the kCosine or kSquaredL2 metric"));
+  }
+
+  SECTION("TEST CASE 7 - Mismatched and zero vectors") {
+    LshIndex index(3);
+    REQUIRE_THROWS_WITH(index.Insert(EuclideanVector(4)),
+                        Catch::Contains("Dimensions of LHS(3) and RHS(4) do not match"));
+    REQUIRE_THROWS_WITH(index.Query(EuclideanVector(2, 1.0), 1),
+                        Catch::Contains("Dimensions of LHS(3) and RHS(2) do not match"));
+    REQUIRE_THROWS_WITH(index.Insert(EuclideanVector(3)),
+                        Catch::Contains("does not have a cosine similarity"));
+    REQUIRE_THROWS_WITH(index.Insert(EuclideanVectorBatch(2, 3)),
+                        Catch::Contains("does not have a cosine similarity"));
+    REQUIRE(index.GetNumVectors() == 0);
+    REQUIRE_THROWS_WITH(index.Query(EuclideanVector(3), 1),
+                        Catch::Contains("does not have a cosine similarity"));
+  }
+
+  SECTION("TEST CASE 8 - Vectors that are not finite, or nearly overflow") {
+    LshOptions options;
+    options.metric = PairwiseMetric::kSquaredL2;
+    LshIndex index(3, options);
+    EuclideanVector bad(3, 1.0);
+    bad[1] = std::numeric_limits<double>::infinity();
+    REQUIRE_THROWS_WITH(index.Insert(bad), Catch::Contains("magnitude that is not finite"));
+    REQUIRE_THROWS_WITH(index.Query(bad, 1), Catch::Contains("magnitude that is not finite"));
+    EuclideanVectorBatch batch(2, 3);
+    batch.Row(1)[2] = std::nan("");
+    REQUIRE_THROWS_WITH(index.Insert(batch), Catch::Contains("magnitude that is not finite"));
+    REQUIRE(index.GetNumVectors() == 0);
+
+    // The terms of these projections overflow to infinities of both signs, which sum to NaN.
+    const auto max = std::numeric_limits<double>::max();
+    EuclideanVector huge(3, max);
+    huge[1] = -max;
+    const auto id = index.Insert(huge);
+    const auto result = index.Query(huge, 1);
+    REQUIRE(result.size() == 1);
+    REQUIRE(result[0].index == id);
+  }
+}
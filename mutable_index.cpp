@@ -0,0 +1,262 @@
+#include "assignments/ev/mutable_index.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "assignments/ev/euclidean_vector.h"
+#include "assignments/ev/kernels.h"
+#include "assignments/ev/neighbor.h"
+#include "assignments/ev/pairwise.h"
+#include "assignments/ev/thread_pool.h"
+
+namespace {
+
+constexpr char kZeroNormCosine[] =
+    "EuclideanVector with euclidean normal of 0 does not have a cosine similarity";
+
+constexpr int kMinCapacity = 16;
+
+void CheckDimensions(int expected, int actual) {
+  if (expected != actual) {
+    throw EuclideanVectorError("Dimensions of LHS(" + std::to_string(expected) + ") and RHS(" +
+                               std::to_string(actual) + ") do not match");
+  }
+}
+
+}  // namespace
+
+struct MutableVectorIndex::Record {
+  int id;
+  EuclideanVector vector;
+  double norm;
+};
+
+// Fixed-capacity array of record pointers. Writers fill entries below capacity and then publish
+// them by raising size; a full table is replaced by a larger copy. Every access is sequentially
+// consistent, which EpochDomain relies on to order readers' loads against writers' retirements.
+struct MutableVectorIndex::Table {
+  explicit Table(int capacity)
+    : entries{std::make_unique<std::atomic<const Record*>[]>(capacity)}, capacity{capacity} {}
+
+  std::unique_ptr<std::atomic<const Record*>[]> entries;
+  int capacity;
+  std::atomic<int> size{0};
+};
+
+// Constructors
+MutableVectorIndex::MutableVectorIndex(int num_dimensions, const MutableIndexOptions& options)
+  : num_dimensions_{num_dimensions}, options_{options}, by_id_{new Table(kMinCapacity)},
+    slots_{new Table(kMinCapacity)} {}
+
+MutableVectorIndex::~MutableVectorIndex() {
+  {
+    std::unique_lock<std::mutex> lock(write_mutex_);
+    compaction_done_.wait(lock, [this] { return !compaction_scheduled_; });
+  }
+  // Records still stored are reachable from by_id_ only once; retired ones belong to epochs_.
+  const auto* by_id = by_id_.load();
+  for (auto id = 0; id < by_id->size.load(); ++id) {
+    delete by_id->entries[id].load();
+  }
+  delete by_id;
+  delete slots_.load();
+}
+
+int MutableVectorIndex::GetNumSlots() const noexcept {
+  const auto guard = epochs_.Enter();
+  return slots_.load()->size.load();
+}
+
+// Stores record in the next entry of table, growing it if full. Returns the entry's position.
+int MutableVectorIndex::Append(std::atomic<Table*>& table, const Record* record) {
+  auto* current = table.load();
+  const auto size = current->size.load();
+  if (size == current->capacity) {
+    auto* grown = new Table(current->capacity * 2);
+    for (auto i = 0; i < size; ++i) {
+      grown->entries[i].store(current->entries[i].load());
+    }
+    grown->size.store(size);
+    table.store(grown);
+    epochs_.Retire([current] { delete current; });
+    current = grown;
+  }
+  current->entries[size].store(record);
+  current->size.store(size + 1);
+  return size;
+}
+
+int MutableVectorIndex::Insert(const EuclideanVector& v) {
+  CheckDimensions(num_dimensions_, v.GetNumDimensions());
+  const auto norm = std::sqrt(ev::kernels::Dot(v.data(), v.data(), num_dimensions_));
+  std::lock_guard<std::mutex> lock(write_mutex_);
+  const auto id = static_cast<int>(slot_of_id_.size());
+  const auto* record = new Record{id, v, norm};
+  Append(by_id_, record);
+  slot_of_id_.push_back(Append(slots_, record));
+  ++num_live_;
+  return id;
+}
+
+bool MutableVectorIndex::Update(int id, const EuclideanVector& v) {
+  CheckDimensions(num_dimensions_, v.GetNumDimensions());
+  const auto norm = std::sqrt(ev::kernels::Dot(v.data(), v.data(), num_dimensions_));
+  std::lock_guard<std::mutex> lock(write_mutex_);
+  if (id < 0 || id >= static_cast<int>(slot_of_id_.size()) || slot_of_id_[id] < 0) {
+    return false;
+  }
+  const auto* record = new Record{id, v, norm};
+  const auto* old = by_id_.load()->entries[id].exchange(record);
+  slots_.load()->entries[slot_of_id_[id]].store(record);
+  epochs_.Retire([old] { delete old; });
+  return true;
+}
+
+bool MutableVectorIndex::Remove(int id) {
+  std::lock_guard<std::mutex> lock(write_mutex_);
+  if (id < 0 || id >= static_cast<int>(slot_of_id_.size()) || slot_of_id_[id] < 0) {
+    return false;
+  }
+  const auto* old = by_id_.load()->entries[id].exchange(nullptr);
+  slots_.load()->entries[slot_of_id_[id]].store(nullptr);
+  slot_of_id_[id] = -1;
+  epochs_.Retire([old] { delete old; });
+  --num_live_;
+  ++num_tombstones_;
+  MaybeScheduleCompaction();
+  return true;
+}
+
+// Called with write_mutex_ held.
+void MutableVectorIndex::MaybeScheduleCompaction() {
+  const auto slots = slots_.load()->size.load();
+  if (options_.compaction_threshold <= 0 || compaction_scheduled_ ||
+      num_tombstones_ <= options_.compaction_threshold * slots) {
+    return;
+  }
+  const auto executor = GetDefaultExecutor();
+  if (executor->GetConcurrency() == 0) {
+    return;
+  }
+  // Compaction is only an optimisation: if it cannot be scheduled or fails (e.g. the new table
+  // cannot be allocated), the index is left as it was and a later Remove tries again. The flag
+  // must be cleared either way, or the destructor would wait for it forever.
+  compaction_scheduled_ = true;
+  try {
+    executor->Submit([this] {
+      try {
+        Compact();
+      } catch (...) {
+      }
+      std::lock_guard<std::mutex> lock(write_mutex_);
+      compaction_scheduled_ = false;
+      compaction_done_.notify_all();
+    });
+  } catch (...) {
+    compaction_scheduled_ = false;
+  }
+}
+
+void MutableVectorIndex::Compact() {
+  std::lock_guard<std::mutex> lock(write_mutex_);
+  if (num_tombstones_ == 0) {
+    return;
+  }
+  auto* current = slots_.load();
+  auto capacity = kMinCapacity;
+  while (capacity < num_live_.load()) {
+    capacity *= 2;
+  }
+  // Records are shared with the old table, so only the table itself is retired.
+  auto* packed = new Table(capacity);
+  auto size = 0;
+  for (auto i = 0; i < current->size.load(); ++i) {
+    if (const auto* record = current->entries[i].load()) {
+      packed->entries[size].store(record);
+      slot_of_id_[record->id] = size++;
+    }
+  }
+  packed->size.store(size);
+  slots_.store(packed);
+  epochs_.Retire([current] { delete current; });
+  num_tombstones_ = 0;
+}
+
+bool MutableVectorIndex::Contains(int id) const noexcept {
+  const auto guard = epochs_.Enter();
+  const auto* by_id = by_id_.load();
+  return id >= 0 && id < by_id->size.load() && by_id->entries[id].load() != nullptr;
+}
+
+EuclideanVector MutableVectorIndex::GetVector(int id) const {
+  {
+    const auto guard = epochs_.Enter();
+    const auto* by_id = by_id_.load();
+    if (id >= 0 && id < by_id->size.load()) {
+      if (const auto* record = by_id->entries[id].load()) {
+        return record->vector;
+      }
+    }
+  }
+  throw EuclideanVectorError("Index " + std::to_string(id) +
+                             " is not valid for this MutableVectorIndex object");
+}
+
+std::vector<Neighbor> MutableVectorIndex::Query(const EuclideanVector& query,
+                                                int k,
+                                                PairwiseMetric metric) const {
+  CheckDimensions(num_dimensions_, query.GetNumDimensions());
+  const auto* q = query.data();
+  const auto query_norm = std::sqrt(ev::kernels::Dot(q, q, num_dimensions_));
+  if (metric == PairwiseMetric::kCosine && query_norm == 0) {
+    throw EuclideanVectorError(kZeroNormCosine);
+  }
+  if (k <= 0) {
+    return {};
+  }
+
+  const auto lower_is_better = metric == PairwiseMetric::kSquaredL2;
+  const auto better = [lower_is_better](const Neighbor& a, const Neighbor& b) {
+    if (a.score != b.score) {
+      return lower_is_better ? a.score < b.score : a.score > b.score;
+    }
+    return a.index < b.index;
+  };
+  // Max-heap on `better`, so the front is the worst of the k kept so far.
+  std::vector<Neighbor> best;
+  const auto guard = epochs_.Enter();
+  const auto* slots = slots_.load();
+  const auto size = slots->size.load();
+  for (auto i = 0; i < size; ++i) {
+    const auto* record = slots->entries[i].load();
+    if (record == nullptr) {
+      continue;
+    }
+    const auto* v = record->vector.data();
+    Neighbor candidate{record->id, 0.0};
+    if (metric == PairwiseMetric::kSquaredL2) {
+      candidate.score = ev::kernels::SquaredL2(q, v, num_dimensions_);
+    } else if (metric == PairwiseMetric::kDot) {
+      candidate.score = ev::kernels::Dot(q, v, num_dimensions_);
+    } else if (record->norm != 0) {
+      candidate.score = ev::kernels::Dot(q, v, num_dimensions_) / (query_norm * record->norm);
+    } else {
+      continue;
+    }
+    if (static_cast<int>(best.size()) < k) {
+      best.push_back(candidate);
+      std::push_heap(best.begin(), best.end(), better);
+    } else if (better(candidate, best.front())) {
+      std::pop_heap(best.begin(), best.end(), better);
+      best.back() = candidate;
+      std::push_heap(best.begin(), best.end(), better);
+    }
+  }
+  std::sort_heap(best.begin(), best.end(), better);
+  return best;
+}
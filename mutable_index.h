@@ -0,0 +1,128 @@
+#ifndef ASSIGNMENTS_EV_MUTABLE_INDEX_H_
+#define ASSIGNMENTS_EV_MUTABLE_INDEX_H_
+
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <vector>
+
+#include "assignments/ev/epoch.h"
+#include "assignments/ev/euclidean_vector.h"
+#include "assignments/ev/neighbor.h"
+#include "assignments/ev/pairwise.h"
+
+struct MutableIndexOptions {
+  /*
+   * Once more than this fraction of the scanned slots are tombstones, a Remove schedules Compact
+   * on the default executor. 0 or less turns background compaction off, as does a default
+   * executor with a concurrency of 0 (see thread_pool.h); call Compact directly in that case.
+   */
+  double compaction_threshold = 0.25;
+};
+
+/*
+ * Brute-force vector store that keeps serving queries while it is modified. Ids are handed out in
+ * insertion order and never reused, so an id keeps naming the same vector until it is removed.
+ *
+ * Readers (Query, Contains, GetVector, ...) never take a lock and are never blocked by writers:
+ * each stored vector is an immutable record reached through atomic pointers, an update publishes
+ * a new record, and replaced or removed records are freed through an ev::detail::EpochDomain once
+ * no reader can still see them. Writers (Insert, Update, Remove, Compact) are serialised among
+ * themselves.
+ *
+ * Remove leaves a tombstone in the scanned slot table; Compact rebuilds that table without them,
+ * so queries stop paying for removed vectors.
+ */
+class MutableVectorIndex {
+ public:
+  explicit MutableVectorIndex(int num_dimensions, const MutableIndexOptions& options = {});
+  MutableVectorIndex(const MutableVectorIndex&) = delete;
+  MutableVectorIndex& operator=(const MutableVectorIndex&) = delete;
+
+  /*
+   * Waits for a background compaction still running.
+   */
+  ~MutableVectorIndex();
+
+  int GetNumDimensions() const noexcept { return num_dimensions_; }
+
+  /*
+   * Number of vectors currently stored.
+   */
+  int GetNumVectors() const noexcept { return num_live_.load(); }
+
+  /*
+   * Number of slots a query scans: stored vectors plus tombstones not yet compacted away.
+   */
+  int GetNumSlots() const noexcept;
+
+  /*
+   * Stores a copy of v and returns its id.
+   * When: v.GetNumDimensions() != GetNumDimensions()
+   * Throw: "Dimensions of LHS(X) and RHS(Y) do not match"
+   */
+  int Insert(const EuclideanVector& v);
+
+  /*
+   * Replaces the vector stored under id, returning false (and changing nothing) if there is none.
+   * Queries running concurrently see either the old or the new vector.
+   * When: v.GetNumDimensions() != GetNumDimensions()
+   * Throw: "Dimensions of LHS(X) and RHS(Y) do not match"
+   */
+  bool Update(int id, const EuclideanVector& v);
+
+  /*
+   * Removes the vector stored under id, returning false if there is none.
+   */
+  bool Remove(int id);
+
+  bool Contains(int id) const noexcept;
+
+  /*
+   * When: For Input X: when no vector is stored under X
+   * Throw: "Index X is not valid for this MutableVectorIndex object"
+   */
+  EuclideanVector GetVector(int id) const;
+
+  /*
+   * The (at most) k stored vectors best matching query under metric, best first (smallest for
+   * kSquaredL2, largest otherwise), ties broken by the lower id. Neighbor::index is the id. Under
+   * kCosine, stored vectors with a norm of 0 are skipped.
+   * When: query.GetNumDimensions() != GetNumDimensions()
+   * Throw: "Dimensions of LHS(X) and RHS(Y) do not match"
+   * When: metric is kCosine and query has a norm of 0
+   * Throw: "EuclideanVector with euclidean normal of 0 does not have a cosine similarity"
+   */
+  std::vector<Neighbor> Query(const EuclideanVector& query,
+                              int k,
+                              PairwiseMetric metric = PairwiseMetric::kSquaredL2) const;
+
+  /*
+   * Rebuilds the slot table without tombstones. Blocks writers, not readers.
+   */
+  void Compact();
+
+ private:
+  struct Record;
+  struct Table;
+
+  int Append(std::atomic<Table*>& table, const Record* record);
+  void MaybeScheduleCompaction();
+
+  int num_dimensions_;
+  MutableIndexOptions options_;
+  mutable ev::detail::EpochDomain epochs_;
+  // Every record by id, and the table queries scan. Both hold nullptr for removed vectors.
+  std::atomic<Table*> by_id_;
+  std::atomic<Table*> slots_;
+  std::atomic<int> num_live_{0};
+
+  // Writer state, guarded by write_mutex_.
+  std::mutex write_mutex_;
+  std::vector<int> slot_of_id_;
+  int num_tombstones_ = 0;
+  bool compaction_scheduled_ = false;
+  std::condition_variable compaction_done_;
+};
+
+#endif  // ASSIGNMENTS_EV_MUTABLE_INDEX_H_
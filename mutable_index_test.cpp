@@ -0,0 +1,282 @@
+/*
+
+  == Explanation and rational of testing ==
+
+  Single-threaded behaviour comes first: queries are compared with a brute-force ranking under
+  every metric, and then the effects of updates, removals and compaction on queries, ids and slot
+  counts are checked. Background compaction is checked by waiting for the slot count to drop,
+  and with an executor that refuses every task, which must not leave the destructor waiting.
+
+  The concurrent test runs writers that insert, update and remove while readers query and look
+  vectors up. Every stored vector is constant and its coordinates are +-id, so a reader can check
+  that what it sees belongs to the id it was returned under. Torn updates or records freed too
+  early would show up as mismatches (or crashes under a sanitizer).
+
+*/
+
+#include "assignments/ev/mutable_index.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <functional>
+#include <memory>
+#include <new>
+#include <thread>
+#include <vector>
+
+#include "assignments/ev/euclidean_vector.h"
+#include "assignments/ev/neighbor.h"
+#include "assignments/ev/pairwise.h"
+#include "assignments/ev/thread_pool.h"
+#include "catch.h"
+
+namespace {
+
+EuclideanVector MakeVector(int dimensions, int seed) {
+  EuclideanVector v(dimensions);
+  for (auto j = 0; j < dimensions; ++j) {
+    v[j] = std::sin(seed * 7.0 + j) + (j == seed % dimensions ? 1.0 : 0.0);
+  }
+  return v;
+}
+
+std::vector<Neighbor> BruteForce(const std::vector<EuclideanVector>& vectors,
+                                 const std::vector<int>& ids,
+                                 const EuclideanVector& query,
+                                 int k,
+                                 PairwiseMetric metric) {
+  std::vector<Neighbor> all;
+  for (auto i = std::size_t{0}; i < ids.size(); ++i) {
+    const auto& v = vectors[i];
+    auto score = query * v;
+    if (metric == PairwiseMetric::kSquaredL2) {
+      const auto norm = (query - v).GetEuclideanNorm();
+      score = norm * norm;
+    } else if (metric == PairwiseMetric::kCosine) {
+      score /= query.GetEuclideanNorm() * v.GetEuclideanNorm();
+    }
+    all.push_back({ids[i], score});
+  }
+  std::sort(all.begin(), all.end(), [metric](const Neighbor& a, const Neighbor& b) {
+    if (a.score != b.score) {
+      return metric == PairwiseMetric::kSquaredL2 ? a.score < b.score : a.score > b.score;
+    }
+    return a.index < b.index;
+  });
+  all.resize(std::min<std::size_t>(k, all.size()));
+  return all;
+}
+
+void RequireSame(const std::vector<Neighbor>& actual, const std::vector<Neighbor>& expected) {
+  REQUIRE(actual.size() == expected.size());
+  for (auto i = std::size_t{0}; i < actual.size(); ++i) {
+    REQUIRE(actual[i].index == expected[i].index);
+    REQUIRE(actual[i].score == Approx(expected[i].score));
+  }
+}
+
+// An executor that cannot take any task, as if memory had run out.
+class FailingExecutor : public Executor {
+ public:
+  int GetConcurrency() const noexcept override { return 1; }
+  void Submit(std::function<void()>) override {
+    ++attempts;
+    throw std::bad_alloc();
+  }
+
+  int attempts = 0;
+};
+
+}  // namespace
+
+TEST_CASE("Mutable index without concurrency") {
+  MutableIndexOptions options;
+  options.compaction_threshold = 0;
+  MutableVectorIndex index(12, options);
+  std::vector<EuclideanVector> vectors;
+  std::vector<int> ids;
+  for (auto i = 0; i < 100; ++i) {
+    vectors.push_back(MakeVector(12, i));
+    ids.push_back(index.Insert(vectors.back()));
+  }
+  const auto query = MakeVector(12, 1000);
+  const auto metrics = {PairwiseMetric::kSquaredL2, PairwiseMetric::kDot, PairwiseMetric::kCosine};
+
+  SECTION("TEST CASE 1 - Queries match a brute-force ranking") {
+    REQUIRE(index.GetNumVectors() == 100);
+    REQUIRE(index.GetNumSlots() == 100);
+    for (auto i = 0; i < 100; ++i) {
+      REQUIRE(ids[i] == i);
+    }
+    for (auto metric : metrics) {
+      for (auto k : {0, 1, 10, 100, 200}) {
+        RequireSame(index.Query(query, k, metric), BruteForce(vectors, ids, query, k, metric));
+      }
+    }
+  }
+
+  SECTION("TEST CASE 2 - Updates and removals") {
+    REQUIRE(index.Update(5, query));
+    REQUIRE(index.GetVector(5) == query);
+    REQUIRE(index.Query(query, 1)[0] == Neighbor{5, 0.0});
+    REQUIRE(index.Remove(5));
+    REQUIRE_FALSE(index.Remove(5));
+    REQUIRE_FALSE(index.Update(5, query));
+    REQUIRE_FALSE(index.Contains(5));
+    REQUIRE_FALSE(index.Update(100, query));
+    REQUIRE_FALSE(index.Remove(-1));
+    REQUIRE(index.GetNumVectors() == 99);
+    REQUIRE_THROWS_WITH(index.GetVector(5),
+                        Catch::Contains("Index 5 is not valid for this MutableVectorIndex object"));
+    // Ids are never reused.
+    REQUIRE(index.Insert(query) == 100);
+    REQUIRE(index.Query(query, 1)[0] == Neighbor{100, 0.0});
+  }
+
+  SECTION("TEST CASE 3 - Compaction drops tombstones and keeps results") {
+    std::vector<EuclideanVector> kept_vectors;
+    std::vector<int> kept_ids;
+    for (auto i = 0; i < 100; ++i) {
+      if (i % 3 == 0) {
+        REQUIRE(index.Remove(i));
+      } else {
+        kept_vectors.push_back(vectors[i]);
+        kept_ids.push_back(i);
+      }
+    }
+    REQUIRE(index.GetNumSlots() == 100);
+    index.Compact();
+    REQUIRE(index.GetNumSlots() == 66);
+    REQUIRE(index.GetNumVectors() == 66);
+    for (auto metric : metrics) {
+      RequireSame(index.Query(query, 20, metric),
+                  BruteForce(kept_vectors, kept_ids, query, 20, metric));
+    }
+    // Slots moved by compaction are still updated and removed by id.
+    REQUIRE(index.Update(98, query));
+    REQUIRE(index.Query(query, 1)[0] == Neighbor{98, 0.0});
+    REQUIRE(index.Remove(98));
+    REQUIRE(index.Query(query, 1)[0].index != 98);
+  }
+}
+
+TEST_CASE("Mutable index background compaction") {
+  SECTION("TEST CASE 4 - Removing past the threshold compacts in the background") {
+    MutableVectorIndex index(4);
+    for (auto i = 0; i < 64; ++i) {
+      index.Insert(MakeVector(4, i));
+    }
+    for (auto i = 0; i < 20; ++i) {
+      index.Remove(i);
+    }
+    // The 17th removal passes the threshold. Compaction may run before the last few removals,
+    // whose tombstones then stay below the threshold, so anywhere from 44 to 47 slots remain.
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+    while (index.GetNumSlots() > 47 && std::chrono::steady_clock::now() < deadline) {
+      std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    REQUIRE(index.GetNumSlots() <= 47);
+    REQUIRE(index.GetNumSlots() >= 44);
+    REQUIRE(index.GetNumVectors() == 44);
+  }
+
+  SECTION("TEST CASE 5 - A compaction that cannot be scheduled is retried") {
+    auto executor = std::make_shared<FailingExecutor>();
+    SetDefaultExecutor(executor);
+    {
+      MutableVectorIndex index(4);
+      for (auto i = 0; i < 64; ++i) {
+        index.Insert(MakeVector(4, i));
+      }
+      for (auto i = 0; i < 20; ++i) {
+        REQUIRE(index.Remove(i));
+      }
+      // Every removal past the threshold tries again; the destructor must not wait for them.
+      REQUIRE(executor->attempts == 4);
+      REQUIRE(index.GetNumSlots() == 64);
+    }
+    SetDefaultExecutor(nullptr);
+  }
+}
+
+TEST_CASE("Mutable index under concurrent writes") {
+  SECTION("TEST CASE 6 - Readers only ever see whole, live records") {
+    constexpr auto kDimensions = 16;
+    MutableIndexOptions options;
+    options.compaction_threshold = 0.1;
+    MutableVectorIndex index(kDimensions, options);
+    std::atomic<bool> stop{false};
+    std::atomic<int> mismatches{0};
+    std::atomic<int> queries{0};
+
+    std::vector<std::thread> threads;
+    for (auto w = 0; w < 2; ++w) {
+      threads.emplace_back([&index, w] {
+        std::vector<int> mine;
+        for (auto step = 0; step < 4000; ++step) {
+          const auto id = index.Insert(EuclideanVector(kDimensions, 0.0));
+          index.Update(id, EuclideanVector(kDimensions, id));
+          mine.push_back(id);
+          if (step % 3 != w) {
+            const auto victim = mine[(step * 7) % mine.size()];
+            index.Update(victim, EuclideanVector(kDimensions, -victim));
+            index.Remove(victim);
+          }
+        }
+      });
+    }
+    for (auto r = 0; r < 3; ++r) {
+      threads.emplace_back([&] {
+        const EuclideanVector origin(kDimensions);
+        while (!stop.load()) {
+          for (const auto& n : index.Query(origin, 8)) {
+            // Any version of id has |coordinate| in {0, id}.
+            const auto id = static_cast<double>(n.index);
+            if (n.score != 0 && n.score != kDimensions * id * id) {
+              ++mismatches;
+            }
+            try {
+              const auto v = index.GetVector(n.index);
+              const auto value = std::abs(v[0]);
+              if ((value != 0 && value != id) || v[kDimensions - 1] != v[0]) {
+                ++mismatches;
+              }
+            } catch (const EuclideanVectorError&) {
+              // Removed since the query ran.
+            }
+          }
+          ++queries;
+        }
+      });
+    }
+    threads[0].join();
+    threads[1].join();
+    stop.store(true);
+    for (auto t = std::size_t{2}; t < threads.size(); ++t) {
+      threads[t].join();
+    }
+    REQUIRE(mismatches.load() == 0);
+    REQUIRE(queries.load() > 0);
+    REQUIRE(index.GetNumVectors() == static_cast<int>(index.Query(EuclideanVector(16), 1 << 20)
+                                                          .size()));
+  }
+}
+
+TEST_CASE("Mutable index errors") {
+  SECTION("TEST CASE 7 - Mismatched and zero vectors") {
+    MutableVectorIndex index(3);
+    REQUIRE_THROWS_WITH(index.Insert(EuclideanVector(4)),
+                        Catch::Contains("Dimensions of LHS(3) and RHS(4) do not match"));
+    index.Insert(EuclideanVector(3));
+    REQUIRE_THROWS_WITH(index.Update(0, EuclideanVector(2)),
+                        Catch::Contains("Dimensions of LHS(3) and RHS(2) do not match"));
+    REQUIRE_THROWS_WITH(index.Query(EuclideanVector(2), 1),
+                        Catch::Contains("Dimensions of LHS(3) and RHS(2) do not match"));
+    REQUIRE_THROWS_WITH(index.Query(EuclideanVector(3), 1, PairwiseMetric::kCosine),
+                        Catch::Contains("does not have a cosine similarity"));
+    // The stored zero vector has no cosine similarity either, so it is skipped.
+    REQUIRE(index.Query(EuclideanVector(3, 1.0), 1, PairwiseMetric::kCosine).empty());
+  }
+}
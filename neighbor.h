@@ -0,0 +1,20 @@
+#ifndef ASSIGNMENTS_EV_NEIGHBOR_H_
+#define ASSIGNMENTS_EV_NEIGHBOR_H_
+
+/*
+ * One result of a similarity search: the row of the searched collection that matched and its
+ * score under the metric of the search (a similarity or a distance, depending on the metric).
+ */
+struct Neighbor {
+  int index;
+  double score;
+
+  friend bool operator==(const Neighbor& lhs, const Neighbor& rhs) noexcept {
+    return lhs.index == rhs.index && lhs.score == rhs.score;
+  }
+  friend bool operator!=(const Neighbor& lhs, const Neighbor& rhs) noexcept {
+    return !(lhs == rhs);
+  }
+};
+
+#endif  // ASSIGNMENTS_EV_NEIGHBOR_H_
@@ -0,0 +1,152 @@
+#include "assignments/ev/normalized_dataset.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "assignments/ev/euclidean_vector.h"
+#include "assignments/ev/euclidean_vector_batch.h"
+#include "assignments/ev/kernels.h"
+#include "assignments/ev/neighbor.h"
+#include "assignments/ev/parallel.h"
+
+namespace {
+
+// Vectors per parallel chunk, and so per list of k best in Nearest.
+constexpr int kGrain = 1024;
+
+constexpr char kZeroNormCosine[] =
+    "EuclideanVector with euclidean normal of 0 does not have a cosine similarity";
+
+bool Better(const Neighbor& a, const Neighbor& b) noexcept {
+  if (a.score != b.score) {
+    return a.score > b.score;
+  }
+  return a.index < b.index;
+}
+
+}  // namespace
+
+std::vector<double> NormalizeRows(EuclideanVectorBatch& batch, int num_threads) {
+  const auto n = batch.GetNumVectors();
+  const auto dimensions = batch.GetNumDimensions();
+  if (n > 0 && dimensions == 0) {
+    throw EuclideanVectorError("EuclideanVector with no dimensions does not have a unit vector");
+  }
+
+  std::vector<double> norms(n);
+  ev::detail::ParallelFor(0, n, kGrain, num_threads, [&](std::int64_t lo, std::int64_t hi) {
+    for (auto i = static_cast<int>(lo); i < hi; ++i) {
+      norms[i] = std::sqrt(ev::kernels::Dot(batch.Row(i), batch.Row(i), dimensions));
+    }
+  });
+  if (std::find(norms.begin(), norms.end(), 0.0) != norms.end()) {
+    throw EuclideanVectorError(
+        "EuclideanVector with euclidean normal of 0 does not have a unit vector");
+  }
+  ev::detail::ParallelFor(0, n, kGrain, num_threads, [&](std::int64_t lo, std::int64_t hi) {
+    for (auto i = static_cast<int>(lo); i < hi; ++i) {
+      ev::kernels::Divide(batch.Row(i), norms[i], dimensions);
+    }
+  });
+  return norms;
+}
+
+// Constructors
+NormalizedDataset::NormalizedDataset(EuclideanVectorBatch batch, int num_threads)
+  : unit_vectors_{std::move(batch)} {
+  norms_ = NormalizeRows(unit_vectors_, num_threads);
+}
+
+NormalizedDataset::NormalizedDataset(const std::vector<EuclideanVector>& vectors, int num_threads)
+  : NormalizedDataset(EuclideanVectorBatch(vectors), num_threads) {}
+
+double NormalizedDataset::GetNorm(int i) const {
+  CheckIndex(i);
+  return norms_[i];
+}
+
+EuclideanVector NormalizedDataset::GetVector(int i) const {
+  CheckIndex(i);
+  return unit_vectors_.GetVector(i) * norms_[i];
+}
+
+std::vector<double> NormalizedDataset::CosineSimilarity(const EuclideanVector& query,
+                                                        int num_threads) const {
+  const auto q = UnitQuery(query);
+  const auto dimensions = GetNumDimensions();
+  std::vector<double> result(GetNumVectors());
+  ev::detail::ParallelFor(
+      0, GetNumVectors(), kGrain, num_threads, [&](std::int64_t lo, std::int64_t hi) {
+        for (auto i = static_cast<int>(lo); i < hi; ++i) {
+          result[i] = ev::kernels::Dot(q.data(), unit_vectors_.Row(i), dimensions);
+        }
+      });
+  return result;
+}
+
+std::vector<Neighbor>
+NormalizedDataset::Nearest(const EuclideanVector& query, int k, int num_threads) const {
+  const auto q = UnitQuery(query);
+  if (k <= 0) {
+    return {};
+  }
+
+  // Each chunk keeps a heap of its k best, with the worst of them at the front.
+  const auto dimensions = GetNumDimensions();
+  const auto num_chunks = (GetNumVectors() + kGrain - 1) / kGrain;
+  std::vector<std::vector<Neighbor>> best(num_chunks);
+  ev::detail::ParallelFor(0, num_chunks, 1, num_threads, [&](std::int64_t lo, std::int64_t hi) {
+    for (auto c = static_cast<int>(lo); c < hi; ++c) {
+      const auto begin = c * kGrain;
+      const auto end = std::min(GetNumVectors(), begin + kGrain);
+      auto& heap = best[c];
+      for (auto i = begin; i < end; ++i) {
+        const Neighbor candidate{i, ev::kernels::Dot(q.data(), unit_vectors_.Row(i), dimensions)};
+        if (static_cast<int>(heap.size()) < k) {
+          heap.push_back(candidate);
+          std::push_heap(heap.begin(), heap.end(), Better);
+        } else if (Better(candidate, heap.front())) {
+          std::pop_heap(heap.begin(), heap.end(), Better);
+          heap.back() = candidate;
+          std::push_heap(heap.begin(), heap.end(), Better);
+        }
+      }
+    }
+  });
+
+  std::vector<Neighbor> result;
+  for (const auto& chunk : best) {
+    result.insert(result.end(), chunk.begin(), chunk.end());
+  }
+  const auto count = std::min(static_cast<std::size_t>(k), result.size());
+  std::partial_sort(result.begin(), result.begin() + count, result.end(), Better);
+  result.resize(count);
+  return result;
+}
+
+void NormalizedDataset::CheckIndex(int i) const {
+  if (i < 0 || i >= GetNumVectors()) {
+    throw EuclideanVectorError("Index " + std::to_string(i) +
+                               " is not valid for this NormalizedDataset object");
+  }
+}
+
+// The query divided by its norm, the same way the stored vectors were.
+std::vector<double> NormalizedDataset::UnitQuery(const EuclideanVector& query) const {
+  const auto dimensions = query.GetNumDimensions();
+  if (dimensions != GetNumDimensions()) {
+    throw EuclideanVectorError("Dimensions of LHS(" + std::to_string(dimensions) + ") and RHS(" +
+                               std::to_string(GetNumDimensions()) + ") do not match");
+  }
+  const auto norm = std::sqrt(ev::kernels::Dot(query.data(), query.data(), dimensions));
+  if (norm == 0) {
+    throw EuclideanVectorError(kZeroNormCosine);
+  }
+  std::vector<double> q(query.data(), query.data() + dimensions);
+  ev::kernels::Divide(q.data(), norm, dimensions);
+  return q;
+}
@@ -0,0 +1,85 @@
+#ifndef ASSIGNMENTS_EV_NORMALIZED_DATASET_H_
+#define ASSIGNMENTS_EV_NORMALIZED_DATASET_H_
+
+#include <vector>
+
+#include "assignments/ev/euclidean_vector.h"
+#include "assignments/ev/euclidean_vector_batch.h"
+#include "assignments/ev/neighbor.h"
+
+/*
+ * Turns every row of batch into its unit vector in place, i.e. the bulk form of
+ * EuclideanVector::CreateUnitVector, and returns the norms the rows were divided by. Rows are
+ * divided element by element, so row i ends up equal to batch.GetVector(i).CreateUnitVector().
+ * All norms are checked before any row is changed, so batch is untouched if this throws.
+ * When: the batch has vectors but no dimensions
+ * Throw: "EuclideanVector with no dimensions does not have a unit vector"
+ * When: some row has a norm of 0
+ * Throw: "EuclideanVector with euclidean normal of 0 does not have a unit vector"
+ */
+std::vector<double> NormalizeRows(EuclideanVectorBatch& batch, int num_threads = 0);
+
+/*
+ * A collection of vectors stored as unit vectors alongside their original norms, for cosine
+ * similarity search. Since every stored vector already has a norm of 1 and the query is
+ * normalized once per search, the cosine similarity with each candidate is a single dot product
+ * instead of a dot product and two norms.
+ */
+class NormalizedDataset {
+ public:
+  NormalizedDataset() noexcept = default;
+
+  /*
+   * Normalizes the vectors with NormalizeRows, in parallel, and throws in the same cases.
+   */
+  explicit NormalizedDataset(EuclideanVectorBatch batch, int num_threads = 0);
+  explicit NormalizedDataset(const std::vector<EuclideanVector>& vectors, int num_threads = 0);
+
+  int GetNumVectors() const noexcept { return unit_vectors_.GetNumVectors(); }
+  int GetNumDimensions() const noexcept { return unit_vectors_.GetNumDimensions(); }
+
+  /*
+   * The stored unit vectors, one row per vector.
+   */
+  const EuclideanVectorBatch& GetUnitVectors() const noexcept { return unit_vectors_; }
+
+  /*
+   * Returns the norm the i-th vector had before it was normalized.
+   * When: For Input X: when X is < 0 or X is >= number of vectors
+   * Throw: "Index X is not valid for this NormalizedDataset object"
+   */
+  double GetNorm(int i) const;
+
+  /*
+   * Returns the i-th vector as it was given, i.e. its unit vector times its norm. Equal to the
+   * original up to rounding.
+   * When: For Input X: when X is < 0 or X is >= number of vectors
+   * Throw: "Index X is not valid for this NormalizedDataset object"
+   */
+  EuclideanVector GetVector(int i) const;
+
+  /*
+   * Returns the cosine similarity between query and every vector, in order.
+   * When: query.GetNumDimensions() != GetNumDimensions()
+   * Throw: "Dimensions of LHS(X) and RHS(Y) do not match"
+   * When: query has a norm of 0
+   * Throw: "EuclideanVector with euclidean normal of 0 does not have a cosine similarity"
+   */
+  std::vector<double> CosineSimilarity(const EuclideanVector& query, int num_threads = 0) const;
+
+  /*
+   * Returns the (at most) k vectors most similar to query, highest cosine similarity first, ties
+   * broken by the lower index. Each thread keeps its own k best and these are merged at the end.
+   * Throws in the same cases as CosineSimilarity.
+   */
+  std::vector<Neighbor> Nearest(const EuclideanVector& query, int k, int num_threads = 0) const;
+
+ private:
+  void CheckIndex(int i) const;
+  std::vector<double> UnitQuery(const EuclideanVector& query) const;
+
+  EuclideanVectorBatch unit_vectors_;
+  std::vector<double> norms_;
+};
+
+#endif  // ASSIGNMENTS_EV_NORMALIZED_DATASET_H_
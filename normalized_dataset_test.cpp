@@ -0,0 +1,119 @@
+/*
+
+  == Explanation and rational of testing ==
+
+  NormalizeRows must agree exactly with CreateUnitVector row by row, and leave the batch alone
+  when it throws. The dataset's cosine similarities are compared with PairwiseMatrix, which
+  computes them the long way, so they agree up to rounding. Nearest is compared with a full sort
+  of those similarities, over enough vectors for several parallel chunks, and with duplicated
+  vectors so ties by index are exercised. The error cases are tested last.
+
+*/
+
+#include "assignments/ev/normalized_dataset.h"
+
+#include <algorithm>
+#include <vector>
+
+#include "assignments/ev/euclidean_vector.h"
+#include "assignments/ev/euclidean_vector_batch.h"
+#include "assignments/ev/neighbor.h"
+#include "assignments/ev/pairwise.h"
+#include "assignments/ev/test_vectors.h"
+#include "catch.h"
+
+TEST_CASE("Normalizing rows") {
+  SECTION("TEST CASE 1 - NormalizeRows matches CreateUnitVector and returns the norms") {
+    const auto vectors = MakeGaussianVectors(3000, 13, 6);
+    EuclideanVectorBatch batch(vectors);
+    const auto norms = NormalizeRows(batch, 3);
+    REQUIRE(norms.size() == vectors.size());
+    for (auto i = 0; i < batch.GetNumVectors(); ++i) {
+      REQUIRE(batch.GetVector(i) == vectors[i].CreateUnitVector());
+      REQUIRE(norms[i] == vectors[i].GetEuclideanNorm());
+    }
+  }
+}
+
+TEST_CASE("Cosine search over a normalized dataset") {
+  auto vectors = MakeGaussianVectors(5000, 20, 6);
+  // Scaled copies have the same cosine similarity as the originals, so they tie with them.
+  for (auto i = 0; i < 50; ++i) {
+    vectors.push_back(vectors[i * 7] * 3.0);
+  }
+  const NormalizedDataset dataset(vectors);
+  const auto query = MakeGaussianVectors(1, 20, 6)[0] * 2.5;
+
+  SECTION("TEST CASE 2 - Stored norms and vectors") {
+    REQUIRE(dataset.GetNumVectors() == 5050);
+    REQUIRE(dataset.GetNumDimensions() == 20);
+    for (auto i : {0, 1234, 5049}) {
+      REQUIRE(dataset.GetNorm(i) == vectors[i].GetEuclideanNorm());
+      const auto restored = dataset.GetVector(i);
+      for (auto j = 0; j < 20; ++j) {
+        REQUIRE(restored[j] == Approx(vectors[i][j]));
+      }
+    }
+  }
+
+  SECTION("TEST CASE 3 - Similarities match PairwiseMatrix") {
+    const auto expected =
+        PairwiseMatrix(std::vector<EuclideanVector>{query}, vectors, PairwiseMetric::kCosine);
+    for (auto threads : {1, 4, 0}) {
+      const auto similarities = dataset.CosineSimilarity(query, threads);
+      REQUIRE(similarities.size() == vectors.size());
+      for (auto i = std::size_t{0}; i < vectors.size(); ++i) {
+        REQUIRE(similarities[i] == Approx(expected[i]).margin(1e-12));
+      }
+    }
+  }
+
+  SECTION("TEST CASE 4 - Nearest is a sort of the similarities") {
+    // Query with a stored vector so its scaled copy ties with it at the top.
+    const auto similarities = dataset.CosineSimilarity(vectors[14]);
+    std::vector<Neighbor> expected;
+    for (auto i = 0; i < static_cast<int>(similarities.size()); ++i) {
+      expected.push_back({i, similarities[i]});
+    }
+    std::stable_sort(expected.begin(), expected.end(),
+                     [](const Neighbor& a, const Neighbor& b) { return a.score > b.score; });
+    for (auto k : {1, 2, 25, 6000}) {
+      for (auto threads : {1, 3, 0}) {
+        const auto nearest = dataset.Nearest(vectors[14], k, threads);
+        REQUIRE(nearest.size() == std::min<std::size_t>(k, expected.size()));
+        for (auto i = std::size_t{0}; i < nearest.size(); ++i) {
+          REQUIRE(nearest[i] == expected[i]);
+        }
+      }
+    }
+    REQUIRE(dataset.Nearest(query, 0).empty());
+  }
+}
+
+TEST_CASE("Normalized dataset errors") {
+  SECTION("TEST CASE 5 - Zero norms, dimensions and indices") {
+    EuclideanVectorBatch batch(MakeGaussianVectors(4, 3, 6));
+    batch.SetVector(2, EuclideanVector(3));
+    const auto before = batch.ToVectors();
+    REQUIRE_THROWS_WITH(
+        NormalizeRows(batch),
+        Catch::Contains("EuclideanVector with euclidean normal of 0 does not have a unit vector"));
+    REQUIRE(batch.ToVectors() == before);
+    EuclideanVectorBatch empty_rows(2, 0);
+    REQUIRE_THROWS_WITH(
+        NormalizeRows(empty_rows),
+        Catch::Contains("EuclideanVector with no dimensions does not have a unit vector"));
+
+    const NormalizedDataset dataset(MakeGaussianVectors(4, 3, 6));
+    REQUIRE_THROWS_WITH(dataset.CosineSimilarity(EuclideanVector(3)),
+                        Catch::Contains("EuclideanVector with euclidean normal of 0 does not "
+                                        "have a cosine similarity"));
+    REQUIRE_THROWS_WITH(dataset.Nearest(EuclideanVector(2), 1),
+                        Catch::Contains("Dimensions of LHS(2) and RHS(3) do not match"));
+    REQUIRE_THROWS_WITH(dataset.GetNorm(4),
+                        Catch::Contains("Index 4 is not valid for this NormalizedDataset object"));
+    REQUIRE_THROWS_WITH(
+        dataset.GetVector(-1),
+        Catch::Contains("Index -1 is not valid for this NormalizedDataset object"));
+  }
+}
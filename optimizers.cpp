@@ -0,0 +1,60 @@
+#include "assignments/ev/optimizers.h"
+
+#include <cmath>
+
+#include "assignments/ev/euclidean_vector.h"
+#include "assignments/ev/euclidean_vector_status.h"
+#include "assignments/ev/kernels.h"
+
+namespace {
+
+void CheckDimensions(int expected, int actual) {
+  if (expected != actual) {
+    EuclideanVectorStatus(EuclideanVectorErrc::kDimensionMismatch, expected, actual).ThrowIfError();
+  }
+}
+
+bool IsDecayRate(double rate) noexcept {
+  return rate >= 0 && rate < 1;
+}
+
+}  // namespace
+
+// Constructors
+MomentumOptimizer::MomentumOptimizer(int num_dimensions, const MomentumOptions& options)
+  : options_{options}, velocity_(num_dimensions) {
+  if (!IsDecayRate(options.momentum)) {
+    throw EuclideanVectorError("Momentum must be in [0, 1)");
+  }
+}
+
+void MomentumOptimizer::Step(EuclideanVector& weights, const EuclideanVector& gradient) {
+  const auto n = velocity_.GetNumDimensions();
+  CheckDimensions(n, weights.GetNumDimensions());
+  CheckDimensions(n, gradient.GetNumDimensions());
+  ev::kernels::MomentumStep(weights.data(), velocity_.data(), gradient.data(),
+                            options_.learning_rate, options_.momentum, n);
+}
+
+// Constructors
+AdamOptimizer::AdamOptimizer(int num_dimensions, const AdamOptions& options)
+  : options_{options}, first_moment_(num_dimensions), second_moment_(num_dimensions) {
+  if (!IsDecayRate(options.beta1) || !IsDecayRate(options.beta2)) {
+    throw EuclideanVectorError("Adam decay rates must be in [0, 1)");
+  }
+}
+
+void AdamOptimizer::Step(EuclideanVector& weights, const EuclideanVector& gradient) {
+  const auto n = first_moment_.GetNumDimensions();
+  CheckDimensions(n, weights.GetNumDimensions());
+  CheckDimensions(n, gradient.GetNumDimensions());
+  ++num_steps_;
+  // m_hat = m / bias1 and v_hat = v / bias2, so
+  //   learning_rate * m_hat / (sqrt(v_hat) + epsilon)
+  //     = (learning_rate * sqrt(bias2) / bias1) * m / (sqrt(v) + epsilon * sqrt(bias2)).
+  const auto bias1 = 1 - std::pow(options_.beta1, num_steps_);
+  const auto root_bias2 = std::sqrt(1 - std::pow(options_.beta2, num_steps_));
+  ev::kernels::AdamStep(weights.data(), first_moment_.data(), second_moment_.data(),
+                        gradient.data(), options_.learning_rate * root_bias2 / bias1,
+                        options_.beta1, options_.beta2, options_.epsilon * root_bias2, n);
+}
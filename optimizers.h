@@ -0,0 +1,95 @@
+#ifndef ASSIGNMENTS_EV_OPTIMIZERS_H_
+#define ASSIGNMENTS_EV_OPTIMIZERS_H_
+
+#include "assignments/ev/euclidean_vector.h"
+
+struct MomentumOptions {
+  double learning_rate = 0.01;
+
+  /*
+   * Fraction of the previous velocity kept at each step, in [0, 1).
+   */
+  double momentum = 0.9;
+};
+
+/*
+ * Gradient descent with (heavy-ball) momentum. Each Step updates the velocity and the weights
+ * together in one pass over the magnitudes (ev::kernels::MomentumStep):
+ *   velocity = momentum * velocity + gradient
+ *   weights -= learning_rate * velocity
+ */
+class MomentumOptimizer {
+ public:
+  /*
+   * An optimizer for weights of num_dimensions dimensions, starting from a velocity of 0.
+   * When: options.momentum is not in [0, 1)
+   * Throw: "Momentum must be in [0, 1)"
+   */
+  explicit MomentumOptimizer(int num_dimensions, const MomentumOptions& options = {});
+
+  /*
+   * Applies one update to weights.
+   * When: weights or gradient do not have the optimizer's number of dimensions X
+   * Throw: "Dimensions of LHS(X) and RHS(Y) do not match"
+   */
+  void Step(EuclideanVector& weights, const EuclideanVector& gradient);
+
+  const EuclideanVector& GetVelocity() const noexcept { return velocity_; }
+
+ private:
+  MomentumOptions options_;
+  EuclideanVector velocity_;
+};
+
+struct AdamOptions {
+  double learning_rate = 0.001;
+
+  /*
+   * Decay rates of the first and second moment estimates, each in [0, 1).
+   */
+  double beta1 = 0.9;
+  double beta2 = 0.999;
+
+  double epsilon = 1e-8;
+};
+
+/*
+ * The Adam optimizer (Kingma and Ba). Each Step updates both moment estimates and the weights
+ * together in one pass over the magnitudes (ev::kernels::AdamStep). The bias corrections are
+ * folded into the step size and epsilon once per step, which gives the same update as the
+ * textbook form
+ *   weights -= learning_rate * m_hat / (sqrt(v_hat) + epsilon)
+ * without dividing every element twice.
+ */
+class AdamOptimizer {
+ public:
+  /*
+   * An optimizer for weights of num_dimensions dimensions, starting from moments of 0.
+   * When: options.beta1 or options.beta2 is not in [0, 1)
+   * Throw: "Adam decay rates must be in [0, 1)"
+   */
+  explicit AdamOptimizer(int num_dimensions, const AdamOptions& options = {});
+
+  /*
+   * Applies one update to weights.
+   * When: weights or gradient do not have the optimizer's number of dimensions X
+   * Throw: "Dimensions of LHS(X) and RHS(Y) do not match"
+   */
+  void Step(EuclideanVector& weights, const EuclideanVector& gradient);
+
+  /*
+   * Number of steps taken so far.
+   */
+  int GetNumSteps() const noexcept { return num_steps_; }
+
+  const EuclideanVector& GetFirstMoment() const noexcept { return first_moment_; }
+  const EuclideanVector& GetSecondMoment() const noexcept { return second_moment_; }
+
+ private:
+  AdamOptions options_;
+  EuclideanVector first_moment_;
+  EuclideanVector second_moment_;
+  int num_steps_ = 0;
+};
+
+#endif  // ASSIGNMENTS_EV_OPTIMIZERS_H_
@@ -0,0 +1,122 @@
+/*
+
+  == Explanation and rational of testing ==
+
+  Both optimizers are run for several steps next to a reference written with the unfused
+  EuclideanVector operators straight from the textbook update rules, including Adam's bias
+  correction, and must stay within rounding of it. The gradients change every step so the
+  moments do not settle. Minimising a simple quadratic checks the updates move the right way.
+  The error cases are tested last.
+
+*/
+
+#include "assignments/ev/optimizers.h"
+
+#include <cmath>
+
+#include "assignments/ev/euclidean_vector.h"
+#include "catch.h"
+
+namespace {
+
+EuclideanVector MakeGradient(int n, int step) {
+  EuclideanVector g(n);
+  for (auto i = 0; i < n; ++i) {
+    g[i] = std::sin(step * 1.3 + i * 0.7) * (i % 3 + 1);
+  }
+  return g;
+}
+
+void RequireNear(const EuclideanVector& actual, const EuclideanVector& expected) {
+  REQUIRE(actual.GetNumDimensions() == expected.GetNumDimensions());
+  for (auto i = 0; i < expected.GetNumDimensions(); ++i) {
+    REQUIRE(actual[i] == Approx(expected[i]).margin(1e-12));
+  }
+}
+
+}  // namespace
+
+TEST_CASE("Optimizer updates") {
+  constexpr auto kDimensions = 37;
+
+  SECTION("TEST CASE 1 Momentum matches the textbook rule") {
+    MomentumOptions options;
+    options.learning_rate = 0.05;
+    options.momentum = 0.8;
+    MomentumOptimizer optimizer(kDimensions, options);
+    EuclideanVector weights(kDimensions, 1.0);
+    auto expected_weights = weights;
+    EuclideanVector velocity(kDimensions);
+    for (auto step = 1; step <= 10; ++step) {
+      const auto g = MakeGradient(kDimensions, step);
+      optimizer.Step(weights, g);
+      velocity = velocity * options.momentum + g;
+      expected_weights -= velocity * options.learning_rate;
+      RequireNear(optimizer.GetVelocity(), velocity);
+      RequireNear(weights, expected_weights);
+    }
+  }
+
+  SECTION("TEST CASE 2 Adam matches the textbook rule with bias correction") {
+    AdamOptions options;
+    options.learning_rate = 0.01;
+    AdamOptimizer optimizer(kDimensions, options);
+    EuclideanVector weights(kDimensions, 1.0);
+    auto expected_weights = weights;
+    EuclideanVector m(kDimensions);
+    EuclideanVector v(kDimensions);
+    for (auto step = 1; step <= 10; ++step) {
+      const auto g = MakeGradient(kDimensions, step);
+      optimizer.Step(weights, g);
+      m = m * options.beta1 + g * (1 - options.beta1);
+      for (auto i = 0; i < kDimensions; ++i) {
+        v[i] = v[i] * options.beta2 + g[i] * g[i] * (1 - options.beta2);
+        const auto m_hat = m[i] / (1 - std::pow(options.beta1, step));
+        const auto v_hat = v[i] / (1 - std::pow(options.beta2, step));
+        expected_weights[i] -= options.learning_rate * m_hat / (std::sqrt(v_hat) + options.epsilon);
+      }
+      REQUIRE(optimizer.GetNumSteps() == step);
+      RequireNear(optimizer.GetFirstMoment(), m);
+      RequireNear(optimizer.GetSecondMoment(), v);
+      RequireNear(weights, expected_weights);
+    }
+  }
+
+  SECTION("TEST CASE 3 Both optimizers minimise a quadratic") {
+    // f(w) = |w - target|^2 / 2 has gradient w - target.
+    const auto target = MakeGradient(kDimensions, 0);
+    EuclideanVector momentum_weights(kDimensions);
+    EuclideanVector adam_weights(kDimensions);
+    MomentumOptimizer momentum(kDimensions);
+    AdamOptions options;
+    options.learning_rate = 0.05;
+    AdamOptimizer adam(kDimensions, options);
+    for (auto step = 0; step < 2000; ++step) {
+      momentum.Step(momentum_weights, momentum_weights - target);
+      adam.Step(adam_weights, adam_weights - target);
+    }
+    REQUIRE((momentum_weights - target).GetEuclideanNorm() < 1e-6);
+    REQUIRE((adam_weights - target).GetEuclideanNorm() < 1e-3);
+  }
+}
+
+TEST_CASE("Optimizer errors") {
+  SECTION("TEST CASE 4 Invalid decay rates and dimensions") {
+    MomentumOptions momentum;
+    momentum.momentum = 1.0;
+    REQUIRE_THROWS_WITH(MomentumOptimizer(3, momentum),
+                        Catch::Contains("Momentum must be in [0, 1)"));
+    AdamOptions adam;
+    adam.beta2 = -0.1;
+    REQUIRE_THROWS_WITH(AdamOptimizer(3, adam),
+                        Catch::Contains("Adam decay rates must be in [0, 1)"));
+
+    EuclideanVector weights(3);
+    MomentumOptimizer optimizer(3);
+    REQUIRE_THROWS_WITH(optimizer.Step(weights, EuclideanVector(4)),
+                        Catch::Contains("Dimensions of LHS(3) and RHS(4) do not match"));
+    EuclideanVector wrong(2);
+    REQUIRE_THROWS_WITH(AdamOptimizer(3).Step(wrong, EuclideanVector(3)),
+                        Catch::Contains("Dimensions of LHS(3) and RHS(2) do not match"));
+  }
+}
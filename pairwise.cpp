@@ -0,0 +1,170 @@
+#include "assignments/ev/pairwise.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "assignments/ev/euclidean_vector.h"
+#include "assignments/ev/euclidean_vector_batch.h"
+#include "assignments/ev/kernels.h"
+#include "assignments/ev/parallel.h"
+
+namespace {
+
+// A tile is kRowTile rows of a against kRowTile rows of b, kDepthTile dimensions at a time:
+// 2 * 64 rows * 256 doubles = 256KB of operands, which stays resident in L2 while the tile's
+// 4096 dot products are accumulated.
+constexpr int kRowTile = 64;
+constexpr int kDepthTile = 256;
+
+struct Tile {
+  int i0, i1, j0, j1;
+};
+
+// Accumulates the dot products of rows [i0, i1) of a with rows [j0, j1) of b over dimensions
+// [k0, k0 + kn) into out. Four rows of b are handled per Dot4 call so each element of a is loaded
+// once for four multiply-adds. Leftover rows go through Dot4 too, with the row repeated, so
+// (i, j) and (j, i) are summed in the same order and agree bit for bit.
+void AccumulateGramTile(const EuclideanVectorBatch& a,
+                        const EuclideanVectorBatch& b,
+                        const Tile& tile,
+                        int k0,
+                        int kn,
+                        bool upper_only,
+                        double* out,
+                        int ldc) {
+  double sums[4];
+  for (auto i = tile.i0; i < tile.i1; ++i) {
+    const auto* x = a.Row(i) + k0;
+    auto* row_out = out + static_cast<std::int64_t>(i) * ldc;
+    auto j = upper_only ? std::max(tile.j0, i) : tile.j0;
+    for (; j + 4 <= tile.j1; j += 4) {
+      const double* y[4] = {b.Row(j) + k0, b.Row(j + 1) + k0, b.Row(j + 2) + k0,
+                            b.Row(j + 3) + k0};
+      ev::kernels::Dot4(x, y, kn, sums);
+      for (auto r = 0; r < 4; ++r) {
+        row_out[j + r] += sums[r];
+      }
+    }
+    for (; j < tile.j1; ++j) {
+      const auto* yj = b.Row(j) + k0;
+      const double* y[4] = {yj, yj, yj, yj};
+      ev::kernels::Dot4(x, y, kn, sums);
+      row_out[j] += sums[0];
+    }
+  }
+}
+
+std::vector<double> SquaredNorms(const EuclideanVectorBatch& batch) {
+  std::vector<double> norms(batch.GetNumVectors());
+  for (auto i = 0; i < batch.GetNumVectors(); ++i) {
+    norms[i] = ev::kernels::Dot(batch.Row(i), batch.Row(i), batch.GetNumDimensions());
+  }
+  return norms;
+}
+
+void CheckNonZero(const std::vector<double>& squared_norms) {
+  for (auto n : squared_norms) {
+    if (n == 0) {
+      throw EuclideanVectorError(
+          "EuclideanVector with euclidean normal of 0 does not have a cosine similarity");
+    }
+  }
+}
+
+std::vector<double> Compute(const EuclideanVectorBatch& a,
+                            const EuclideanVectorBatch& b,
+                            PairwiseMetric metric,
+                            bool same,
+                            const PairwiseOptions& options) {
+  if (a.GetNumDimensions() != b.GetNumDimensions()) {
+    throw EuclideanVectorError("Dimensions of LHS(" + std::to_string(a.GetNumDimensions()) +
+                               ") and RHS(" + std::to_string(b.GetNumDimensions()) +
+                               ") do not match");
+  }
+  const auto na = a.GetNumVectors();
+  const auto nb = b.GetNumVectors();
+  const auto d = a.GetNumDimensions();
+  const auto upper_only = same && options.upper_triangle_only;
+
+  std::vector<double> a_norms;
+  std::vector<double> b_norms;
+  if (metric != PairwiseMetric::kDot) {
+    a_norms = SquaredNorms(a);
+    b_norms = same ? a_norms : SquaredNorms(b);
+    if (metric == PairwiseMetric::kCosine) {
+      CheckNonZero(a_norms);
+      CheckNonZero(b_norms);
+    }
+  }
+
+  std::vector<Tile> tiles;
+  for (auto i0 = 0; i0 < na; i0 += kRowTile) {
+    for (auto j0 = upper_only ? i0 : 0; j0 < nb; j0 += kRowTile) {
+      tiles.push_back({i0, std::min(na, i0 + kRowTile), j0, std::min(nb, j0 + kRowTile)});
+    }
+  }
+
+  std::vector<double> result(static_cast<std::size_t>(na) * nb, 0.0);
+  auto* out = result.data();
+  ev::detail::ParallelFor(
+      0, static_cast<std::int64_t>(tiles.size()), 1, options.num_threads,
+      [&](std::int64_t lo, std::int64_t hi) {
+        for (auto t = lo; t < hi; ++t) {
+          const auto& tile = tiles[t];
+          for (auto k0 = 0; k0 < d; k0 += kDepthTile) {
+            AccumulateGramTile(a, b, tile, k0, std::min(kDepthTile, d - k0), upper_only, out, nb);
+          }
+          if (metric == PairwiseMetric::kDot) {
+            continue;
+          }
+          for (auto i = tile.i0; i < tile.i1; ++i) {
+            for (auto j = upper_only ? std::max(tile.j0, i) : tile.j0; j < tile.j1; ++j) {
+              auto& entry = out[static_cast<std::int64_t>(i) * nb + j];
+              if (metric == PairwiseMetric::kSquaredL2) {
+                // The expansion can go slightly negative through cancellation.
+                entry = (same && i == j) ? 0.0 : std::max(0.0, a_norms[i] + b_norms[j] - 2 * entry);
+              } else {
+                entry /= std::sqrt(a_norms[i]) * std::sqrt(b_norms[j]);
+              }
+            }
+          }
+        }
+      });
+  return result;
+}
+
+}  // namespace
+
+std::vector<double> PairwiseMatrix(const EuclideanVectorBatch& a,
+                                   const EuclideanVectorBatch& b,
+                                   PairwiseMetric metric,
+                                   const PairwiseOptions& options) {
+  return Compute(a, b, metric, &a == &b, options);
+}
+
+std::vector<double> PairwiseMatrix(const std::vector<EuclideanVector>& a,
+                                   const std::vector<EuclideanVector>& b,
+                                   PairwiseMetric metric,
+                                   const PairwiseOptions& options) {
+  if (&a == &b) {
+    return PairwiseMatrix(a, metric, options);
+  }
+  return Compute(EuclideanVectorBatch(a), EuclideanVectorBatch(b), metric, false, options);
+}
+
+std::vector<double> PairwiseMatrix(const EuclideanVectorBatch& a,
+                                   PairwiseMetric metric,
+                                   const PairwiseOptions& options) {
+  return Compute(a, a, metric, true, options);
+}
+
+std::vector<double> PairwiseMatrix(const std::vector<EuclideanVector>& a,
+                                   PairwiseMetric metric,
+                                   const PairwiseOptions& options) {
+  const EuclideanVectorBatch batch(a);
+  return Compute(batch, batch, metric, true, options);
+}
@@ -0,0 +1,62 @@
+#ifndef ASSIGNMENTS_EV_PAIRWISE_H_
+#define ASSIGNMENTS_EV_PAIRWISE_H_
+
+#include <vector>
+
+#include "assignments/ev/euclidean_vector.h"
+#include "assignments/ev/euclidean_vector_batch.h"
+
+enum class PairwiseMetric {
+  // a * b, i.e. the Gram matrix.
+  kDot,
+  // (a - b).GetEuclideanNorm() squared, computed as |a|^2 + |b|^2 - 2 a * b.
+  kSquaredL2,
+  // (a * b) / (|a| |b|).
+  kCosine,
+};
+
+struct PairwiseOptions {
+  /*
+   * Maximum number of threads to use. 0 means one per hardware thread.
+   */
+  int num_threads = 0;
+
+  /*
+   * Only used when comparing a collection with itself. When true, only entries (i, j) with
+   * i <= j are computed and the strictly lower triangle of the result is left as 0.0, roughly
+   * halving the work for symmetric metrics.
+   */
+  bool upper_triangle_only = false;
+};
+
+/*
+ * Returns the a.GetNumVectors() x b.GetNumVectors() matrix of metric(a[i], b[j]) in row-major
+ * order, i.e. entry (i, j) is at index i * b.GetNumVectors() + j. The work is split into tiles of
+ * rows of a and b small enough to stay in cache, and tiles are computed in parallel. Norms are
+ * computed once per vector rather than once per pair.
+ * When: a and b have a different number of dimensions
+ * Throw: "Dimensions of LHS(X) and RHS(Y) do not match"
+ * When: metric is kCosine and some vector has a norm of 0
+ * Throw: "EuclideanVector with euclidean normal of 0 does not have a cosine similarity"
+ */
+std::vector<double> PairwiseMatrix(const EuclideanVectorBatch& a,
+                                   const EuclideanVectorBatch& b,
+                                   PairwiseMetric metric,
+                                   const PairwiseOptions& options = {});
+std::vector<double> PairwiseMatrix(const std::vector<EuclideanVector>& a,
+                                   const std::vector<EuclideanVector>& b,
+                                   PairwiseMetric metric,
+                                   const PairwiseOptions& options = {});
+
+/*
+ * Returns the a.GetNumVectors() x a.GetNumVectors() matrix of metric(a[i], a[j]), honouring
+ * PairwiseOptions::upper_triangle_only.
+ */
+std::vector<double> PairwiseMatrix(const EuclideanVectorBatch& a,
+                                   PairwiseMetric metric,
+                                   const PairwiseOptions& options = {});
+std::vector<double> PairwiseMatrix(const std::vector<EuclideanVector>& a,
+                                   PairwiseMetric metric,
+                                   const PairwiseOptions& options = {});
+
+#endif  // ASSIGNMENTS_EV_PAIRWISE_H_
@@ -0,0 +1,105 @@
+/*
+
+  == Explanation and rational of testing ==
+
+  Every metric is compared entry by entry against the obvious computation with operator*,
+  operator- and GetEuclideanNorm. Sizes are chosen so that neither the number of vectors nor the
+  number of dimensions is a multiple of the tile sizes, so partial tiles are exercised. We also
+  check the upper triangle option and the exceptions.
+
+*/
+
+#include "assignments/ev/pairwise.h"
+
+#include <cmath>
+#include <vector>
+
+#include "catch.h"
+
+namespace {
+
+std::vector<EuclideanVector> MakeVectors(int n, int d, double phase) {
+  std::vector<EuclideanVector> vectors;
+  for (auto i = 0; i < n; ++i) {
+    EuclideanVector v(d);
+    for (auto j = 0; j < d; ++j) {
+      v[j] = std::sin(phase + i * 0.37 + j * 0.11);
+    }
+    vectors.push_back(v);
+  }
+  return vectors;
+}
+
+}  // namespace
+
+TEST_CASE("Pairwise matrices of two collections") {
+  const auto a = MakeVectors(70, 300, 0.0);
+  const auto b = MakeVectors(131, 300, 1.0);
+
+  SECTION("TEST CASE 1 Dot products") {
+    const auto m = PairwiseMatrix(a, b, PairwiseMetric::kDot, {3, false});
+    REQUIRE(m.size() == 70 * 131);
+    for (auto i = 0; i < 70; ++i) {
+      for (auto j = 0; j < 131; ++j) {
+        REQUIRE(m[i * 131 + j] == Approx(a[i] * b[j]).margin(1e-9));
+      }
+    }
+  }
+
+  SECTION("TEST CASE 2 Squared distances") {
+    const auto m = PairwiseMatrix(a, b, PairwiseMetric::kSquaredL2);
+    for (auto i = 0; i < 70; ++i) {
+      for (auto j = 0; j < 131; ++j) {
+        const auto norm = (a[i] - b[j]).GetEuclideanNorm();
+        REQUIRE(m[i * 131 + j] == Approx(norm * norm).margin(1e-9));
+      }
+    }
+  }
+
+  SECTION("TEST CASE 3 Cosine similarities") {
+    const auto m = PairwiseMatrix(EuclideanVectorBatch(a), EuclideanVectorBatch(b),
+                                  PairwiseMetric::kCosine);
+    for (auto i = 0; i < 70; ++i) {
+      for (auto j = 0; j < 131; ++j) {
+        const auto expected = (a[i] * b[j]) / (a[i].GetEuclideanNorm() * b[j].GetEuclideanNorm());
+        REQUIRE(m[i * 131 + j] == Approx(expected).margin(1e-12));
+      }
+    }
+  }
+
+  SECTION("TEST CASE 4 Exception will be thrown when dimensions differ") {
+    const auto c = MakeVectors(3, 299, 0.0);
+    REQUIRE_THROWS_WITH(PairwiseMatrix(a, c, PairwiseMetric::kDot),
+                        Catch::Contains("Dimensions of LHS(300) and RHS(299)"));
+  }
+
+  SECTION("TEST CASE 5 Exception will be thrown for cosine of a zero vector") {
+    auto c = a;
+    c[5] = EuclideanVector(300);
+    REQUIRE_THROWS_WITH(PairwiseMatrix(c, b, PairwiseMetric::kCosine),
+                        Catch::Contains("euclidean normal of 0"));
+  }
+}
+
+TEST_CASE("Pairwise matrix of a collection with itself") {
+  const auto a = MakeVectors(150, 40, 0.5);
+  const auto full = PairwiseMatrix(a, PairwiseMetric::kSquaredL2, {2, false});
+
+  SECTION("TEST CASE 1 The full matrix is symmetric with a zero diagonal") {
+    for (auto i = 0; i < 150; ++i) {
+      REQUIRE(full[i * 150 + i] == 0.0);
+      for (auto j = 0; j < 150; ++j) {
+        REQUIRE(full[i * 150 + j] == full[j * 150 + i]);
+      }
+    }
+  }
+
+  SECTION("TEST CASE 2 The upper triangle matches and the lower triangle is left as zero") {
+    const auto upper = PairwiseMatrix(a, PairwiseMetric::kSquaredL2, {2, true});
+    for (auto i = 0; i < 150; ++i) {
+      for (auto j = 0; j < 150; ++j) {
+        REQUIRE(upper[i * 150 + j] == (j >= i ? full[i * 150 + j] : 0.0));
+      }
+    }
+  }
+}
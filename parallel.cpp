@@ -0,0 +1,125 @@
+#include "assignments/ev/parallel.h"
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+#include "assignments/ev/thread_pool.h"
+
+namespace ev::detail {
+
+namespace {
+
+// Shared between the caller and the tasks it submits. Helper tasks may start after the loop has
+// finished, so they hold the state by shared_ptr and only touch body while a chunk is unclaimed.
+struct LoopState {
+  std::int64_t begin;
+  std::int64_t end;
+  std::int64_t grain;
+  std::int64_t num_chunks;
+  const std::function<void(std::int64_t, std::int64_t)>* body;
+
+  std::atomic<std::int64_t> next_chunk{0};
+  std::atomic<std::int64_t> finished_chunks{0};
+  std::atomic<bool> cancelled{false};
+  std::exception_ptr error;
+  std::mutex mutex;
+  std::condition_variable done;
+
+  // Claims and runs chunks until none are left.
+  void Work() {
+    for (auto chunk = next_chunk.fetch_add(1); chunk < num_chunks;
+         chunk = next_chunk.fetch_add(1)) {
+      if (!cancelled.load(std::memory_order_relaxed)) {
+        const auto lo = begin + chunk * grain;
+        try {
+          (*body)(lo, std::min(end, lo + grain));
+        } catch (...) {
+          std::lock_guard<std::mutex> lock(mutex);
+          if (!error) {
+            error = std::current_exception();
+          }
+          cancelled = true;
+        }
+      }
+      if (finished_chunks.fetch_add(1) + 1 == num_chunks) {
+        std::lock_guard<std::mutex> lock(mutex);
+        done.notify_all();
+      }
+    }
+  }
+
+  bool Finished() const noexcept { return finished_chunks.load() == num_chunks; }
+};
+
+}  // namespace
+
+int ResolveThreadCount(int requested) noexcept {
+  if (requested > 0) {
+    return requested;
+  }
+  return std::max(1U, std::thread::hardware_concurrency());
+}
+
+void ParallelFor(Executor& executor,
+                 std::int64_t begin,
+                 std::int64_t end,
+                 std::int64_t grain,
+                 int num_threads,
+                 const std::function<void(std::int64_t, std::int64_t)>& body) {
+  if (end <= begin) {
+    return;
+  }
+  grain = std::max<std::int64_t>(1, grain);
+  const auto num_chunks = (end - begin + grain - 1) / grain;
+  const auto helpers = std::min<std::int64_t>(
+      {static_cast<std::int64_t>(ResolveThreadCount(num_threads)) - 1,
+       static_cast<std::int64_t>(executor.GetConcurrency()), num_chunks - 1});
+  if (helpers <= 0) {
+    for (auto lo = begin; lo < end; lo += grain) {
+      body(lo, std::min(end, lo + grain));
+    }
+    return;
+  }
+
+  // Chunks are handed out dynamically so uneven chunks do not leave threads idle.
+  auto state = std::make_shared<LoopState>();
+  state->begin = begin;
+  state->end = end;
+  state->grain = grain;
+  state->num_chunks = num_chunks;
+  state->body = &body;
+  for (auto i = 0; i < helpers; ++i) {
+    executor.Submit([state]() { state->Work(); });
+  }
+  state->Work();
+
+  // Only chunks already running on other threads remain. Help with queued work meanwhile, which
+  // is what lets a nested loop's helpers run even when every worker is inside an outer loop.
+  while (!state->Finished()) {
+    if (!executor.TryRunPendingTask()) {
+      std::unique_lock<std::mutex> lock(state->mutex);
+      state->done.wait(lock, [&state]() { return state->Finished(); });
+    }
+  }
+  if (state->error) {
+    std::rethrow_exception(state->error);
+  }
+}
+
+void ParallelFor(std::int64_t begin,
+                 std::int64_t end,
+                 std::int64_t grain,
+                 int num_threads,
+                 const std::function<void(std::int64_t, std::int64_t)>& body) {
+  const auto executor = GetDefaultExecutor();
+  ParallelFor(*executor, begin, end, grain, num_threads, body);
+}
+
+}  // namespace ev::detail
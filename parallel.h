@@ -0,0 +1,41 @@
+#ifndef ASSIGNMENTS_EV_PARALLEL_H_
+#define ASSIGNMENTS_EV_PARALLEL_H_
+
+#include <cstdint>
+#include <functional>
+
+#include "assignments/ev/thread_pool.h"
+
+namespace ev::detail {
+
+/*
+ * Resolves a user-facing thread count: values <= 0 mean "one per hardware thread".
+ */
+int ResolveThreadCount(int requested) noexcept;
+
+/*
+ * Splits [begin, end) into chunks of at most grain indices and calls body(lo, hi) for each chunk,
+ * using up to num_threads threads (the calling thread included). Returns once every chunk has run.
+ * The first exception thrown by body is rethrown on the calling thread; chunks not yet started
+ * when it was thrown are skipped.
+ *
+ * The extra threads are borrowed from executor (the library default if not given). The calling
+ * thread always works through the chunks itself and, while waiting for borrowed threads to finish,
+ * runs other queued tasks, so ParallelFor may safely be called from inside another ParallelFor.
+ */
+void ParallelFor(Executor& executor,
+                 std::int64_t begin,
+                 std::int64_t end,
+                 std::int64_t grain,
+                 int num_threads,
+                 const std::function<void(std::int64_t, std::int64_t)>& body);
+
+void ParallelFor(std::int64_t begin,
+                 std::int64_t end,
+                 std::int64_t grain,
+                 int num_threads,
+                 const std::function<void(std::int64_t, std::int64_t)>& body);
+
+}  // namespace ev::detail
+
+#endif  // ASSIGNMENTS_EV_PARALLEL_H_
@@ -0,0 +1,240 @@
+#include "assignments/ev/quantization.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "assignments/ev/euclidean_vector.h"
+#include "assignments/ev/euclidean_vector_batch.h"
+#include "assignments/ev/kernels.h"
+#include "assignments/ev/parallel.h"
+
+namespace {
+
+// Vectors per parallel chunk when scanning or quantizing.
+constexpr int kGrain = 256;
+
+int LowestCode(QuantizedType type) noexcept {
+  return type == QuantizedType::kInt8 ? -128 : 0;
+}
+
+// Maps the 256 codes starting at lowest onto [min, max].
+void SetRange(double min, double max, int lowest, double* offset, double* scale) noexcept {
+  *scale = (max - min) / 255;
+  *offset = min - *scale * lowest;
+}
+
+int Encode(double x, double offset, double scale, int lowest) noexcept {
+  if (scale == 0) {
+    return 0;
+  }
+  const auto code = std::lround((x - offset) / scale);
+  return static_cast<int>(std::clamp<long>(code, lowest, lowest + 255));
+}
+
+std::int64_t CodeDot(QuantizedType type, const std::uint8_t* a, const std::uint8_t* b, int n) {
+  if (type == QuantizedType::kInt8) {
+    return ev::kernels::DotI8(reinterpret_cast<const std::int8_t*>(a),
+                              reinterpret_cast<const std::int8_t*>(b), n);
+  }
+  return ev::kernels::DotU8(a, b, n);
+}
+
+double WeightDot(QuantizedType type, const double* w, const std::uint8_t* codes, int n) {
+  if (type == QuantizedType::kInt8) {
+    return ev::kernels::DotF64I8(w, reinterpret_cast<const std::int8_t*>(codes), n);
+  }
+  return ev::kernels::DotF64U8(w, codes, n);
+}
+
+}  // namespace
+
+// Constructors
+QuantizedVectorBatch::QuantizedVectorBatch(const EuclideanVectorBatch& batch,
+                                           QuantizedType type,
+                                           QuantizationScope scope,
+                                           int num_threads)
+  : codes_(static_cast<std::size_t>(batch.GetNumVectors()) * batch.GetNumDimensions()),
+    squared_norms_(batch.GetNumVectors()), num_vectors_{batch.GetNumVectors()},
+    num_dimensions_{batch.GetNumDimensions()}, type_{type}, scope_{scope} {
+  const auto n = num_vectors_;
+  const auto d = num_dimensions_;
+  const auto lowest = LowestCode(type);
+  if (scope == QuantizationScope::kPerDimension) {
+    offsets_.resize(d);
+    scales_.resize(d);
+    // Eight columns (one cache line of every row) per chunk.
+    ev::detail::ParallelFor(0, d, 8, num_threads, [&](std::int64_t lo, std::int64_t hi) {
+      for (auto j = lo; j < hi; ++j) {
+        auto min = n > 0 ? batch.Row(0)[j] : 0.0;
+        auto max = min;
+        for (auto i = 1; i < n; ++i) {
+          min = std::min(min, batch.Row(i)[j]);
+          max = std::max(max, batch.Row(i)[j]);
+        }
+        SetRange(min, max, lowest, &offsets_[j], &scales_[j]);
+      }
+    });
+  } else {
+    offsets_.resize(n);
+    scales_.resize(n);
+    code_sums_.resize(n);
+  }
+
+  ev::detail::ParallelFor(0, n, kGrain, num_threads, [&](std::int64_t lo, std::int64_t hi) {
+    for (auto i = static_cast<int>(lo); i < hi; ++i) {
+      const auto* row = batch.Row(i);
+      auto* codes = codes_.data() + static_cast<std::int64_t>(i) * d;
+      if (scope == QuantizationScope::kPerVector) {
+        auto min = d > 0 ? row[0] : 0.0;
+        auto max = min;
+        for (auto j = 1; j < d; ++j) {
+          min = std::min(min, row[j]);
+          max = std::max(max, row[j]);
+        }
+        SetRange(min, max, lowest, &offsets_[i], &scales_[i]);
+      }
+      std::int64_t sum = 0;
+      double squared_norm = 0;
+      for (auto j = 0; j < d; ++j) {
+        const auto code = Encode(row[j], Offset(i, j), Scale(i, j), lowest);
+        codes[j] = static_cast<std::uint8_t>(code);
+        sum += code;
+        const auto value = Offset(i, j) + Scale(i, j) * code;
+        squared_norm += value * value;
+      }
+      squared_norms_[i] = squared_norm;
+      if (scope == QuantizationScope::kPerVector) {
+        code_sums_[i] = sum;
+      }
+    }
+  });
+}
+
+int QuantizedVectorBatch::Code(int i, int j) const noexcept {
+  const auto byte = Row(i)[j];
+  return type_ == QuantizedType::kInt8 ? static_cast<std::int8_t>(byte) : byte;
+}
+
+double QuantizedVectorBatch::Offset(int i, int j) const noexcept {
+  return offsets_[scope_ == QuantizationScope::kPerVector ? i : j];
+}
+
+double QuantizedVectorBatch::Scale(int i, int j) const noexcept {
+  return scales_[scope_ == QuantizationScope::kPerVector ? i : j];
+}
+
+void QuantizedVectorBatch::CheckIndex(int i) const {
+  if (i < 0 || i >= num_vectors_) {
+    throw EuclideanVectorError("Index " + std::to_string(i) +
+                               " is not valid for this QuantizedVectorBatch object");
+  }
+}
+
+EuclideanVector QuantizedVectorBatch::GetVector(int i) const {
+  CheckIndex(i);
+  EuclideanVector v(num_dimensions_);
+  for (auto j = 0; j < num_dimensions_; ++j) {
+    v[j] = Offset(i, j) + Scale(i, j) * Code(i, j);
+  }
+  return v;
+}
+
+EuclideanVectorBatch QuantizedVectorBatch::ToBatch(int num_threads) const {
+  EuclideanVectorBatch batch(num_vectors_, num_dimensions_);
+  ev::detail::ParallelFor(0, num_vectors_, kGrain, num_threads,
+                          [&](std::int64_t lo, std::int64_t hi) {
+                            for (auto i = static_cast<int>(lo); i < hi; ++i) {
+                              auto* row = batch.Row(i);
+                              for (auto j = 0; j < num_dimensions_; ++j) {
+                                row[j] = Offset(i, j) + Scale(i, j) * Code(i, j);
+                              }
+                            }
+                          });
+  return batch;
+}
+
+double QuantizedVectorBatch::Dot(int i, int j) const {
+  CheckIndex(i);
+  CheckIndex(j);
+  const auto d = num_dimensions_;
+  if (scope_ == QuantizationScope::kPerVector) {
+    // Expanding (oi + si ci) . (oj + sj cj) leaves a single integer dot product of the codes.
+    const auto oi = offsets_[i], si = scales_[i];
+    const auto oj = offsets_[j], sj = scales_[j];
+    const auto codes = static_cast<double>(CodeDot(type_, Row(i), Row(j), d));
+    return d * oi * oj + oi * sj * code_sums_[j] + oj * si * code_sums_[i] + si * sj * codes;
+  }
+  double dot = 0;
+  for (auto k = 0; k < d; ++k) {
+    dot += (offsets_[k] + scales_[k] * Code(i, k)) * (offsets_[k] + scales_[k] * Code(j, k));
+  }
+  return dot;
+}
+
+double QuantizedVectorBatch::SquaredL2(int i, int j) const {
+  CheckIndex(i);
+  CheckIndex(j);
+  if (scope_ == QuantizationScope::kPerVector) {
+    return std::max(0.0, squared_norms_[i] + squared_norms_[j] - 2 * Dot(i, j));
+  }
+  // The offsets cancel, so the difference is exact in the codes.
+  double distance = 0;
+  for (auto k = 0; k < num_dimensions_; ++k) {
+    const auto diff = scales_[k] * (Code(i, k) - Code(j, k));
+    distance += diff * diff;
+  }
+  return distance;
+}
+
+std::vector<double> QuantizedVectorBatch::Dot(const EuclideanVector& query,
+                                              int num_threads) const {
+  if (query.GetNumDimensions() != num_dimensions_) {
+    throw EuclideanVectorError("Dimensions of LHS(" + std::to_string(num_dimensions_) +
+                               ") and RHS(" + std::to_string(query.GetNumDimensions()) +
+                               ") do not match");
+  }
+  const auto d = num_dimensions_;
+  const auto* q = query.data();
+  // q . (o + s c) is split into a part independent of the codes and a weighted sum of the codes:
+  // per vector o * sum(q) + s * (q . c), per dimension (q . o) + (q * s) . c.
+  auto constant = 0.0;
+  std::vector<double> weights;
+  if (scope_ == QuantizationScope::kPerVector) {
+    for (auto k = 0; k < d; ++k) {
+      constant += q[k];
+    }
+  } else {
+    constant = ev::kernels::Dot(q, offsets_.data(), d);
+    weights.resize(d);
+    for (auto k = 0; k < d; ++k) {
+      weights[k] = q[k] * scales_[k];
+    }
+  }
+
+  std::vector<double> result(num_vectors_);
+  ev::detail::ParallelFor(0, num_vectors_, kGrain, num_threads,
+                          [&](std::int64_t lo, std::int64_t hi) {
+                            for (auto i = static_cast<int>(lo); i < hi; ++i) {
+                              if (scope_ == QuantizationScope::kPerVector) {
+                                result[i] = offsets_[i] * constant +
+                                            scales_[i] * WeightDot(type_, q, Row(i), d);
+                              } else {
+                                result[i] = constant + WeightDot(type_, weights.data(), Row(i), d);
+                              }
+                            }
+                          });
+  return result;
+}
+
+std::vector<double> QuantizedVectorBatch::SquaredL2(const EuclideanVector& query,
+                                                    int num_threads) const {
+  auto result = Dot(query, num_threads);
+  const auto query_norm = ev::kernels::Dot(query.data(), query.data(), num_dimensions_);
+  for (auto i = 0; i < num_vectors_; ++i) {
+    result[i] = std::max(0.0, query_norm + squared_norms_[i] - 2 * result[i]);
+  }
+  return result;
+}
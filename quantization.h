@@ -0,0 +1,109 @@
+#ifndef ASSIGNMENTS_EV_QUANTIZATION_H_
+#define ASSIGNMENTS_EV_QUANTIZATION_H_
+
+#include <cstdint>
+#include <vector>
+
+#include "assignments/ev/euclidean_vector.h"
+#include "assignments/ev/euclidean_vector_batch.h"
+
+enum class QuantizedType {
+  // Codes 0..255.
+  kUint8,
+  // Codes -128..127.
+  kInt8,
+};
+
+enum class QuantizationScope {
+  // Each vector gets its own range, from its smallest to its largest coordinate. Distances
+  // between two quantized vectors are then computed entirely with integer dot products.
+  kPerVector,
+  // Each dimension gets its own range, taken over the whole batch. More accurate when
+  // dimensions have very different spreads, but only queries against full-precision vectors
+  // avoid dequantizing.
+  kPerDimension,
+};
+
+/*
+ * A batch of vectors stored as one byte per coordinate, 1/8 of the memory of an
+ * EuclideanVectorBatch. Coordinate x is stored as the code c nearest to (x - offset) / scale,
+ * where offset and scale map the code range onto the [min, max] range of its vector or dimension,
+ * so the error per coordinate is at most scale / 2.
+ *
+ * Every distance is computed against the dequantized value offset + scale * c.
+ */
+class QuantizedVectorBatch {
+ public:
+  QuantizedVectorBatch() noexcept = default;
+
+  /*
+   * Quantizes every vector of the batch, in parallel. num_threads of 0 means one per hardware
+   * thread.
+   */
+  QuantizedVectorBatch(const EuclideanVectorBatch& batch,
+                       QuantizedType type,
+                       QuantizationScope scope,
+                       int num_threads = 0);
+
+  int GetNumVectors() const noexcept { return num_vectors_; }
+  int GetNumDimensions() const noexcept { return num_dimensions_; }
+  QuantizedType GetType() const noexcept { return type_; }
+  QuantizationScope GetScope() const noexcept { return scope_; }
+
+  /*
+   * Returns a pointer to the GetNumDimensions() codes of the i-th vector, stored back to back.
+   * For kInt8 the bytes are int8_t codes. No bounds checking.
+   */
+  const std::uint8_t* Row(int i) const noexcept {
+    return codes_.data() + static_cast<std::int64_t>(i) * num_dimensions_;
+  }
+
+  /*
+   * Returns the dequantized i-th vector.
+   * When: For Input X: when X is < 0 or X is >= number of vectors
+   * Throw: "Index X is not valid for this QuantizedVectorBatch object"
+   */
+  EuclideanVector GetVector(int i) const;
+
+  /*
+   * Dequantizes every vector into a new batch.
+   */
+  EuclideanVectorBatch ToBatch(int num_threads = 0) const;
+
+  /*
+   * Dot product and squared distance between the i-th and j-th vectors. With kPerVector these
+   * run on the integer kernels (ev::kernels::DotU8/DotI8) without dequantizing.
+   * When: For Input X: when X is < 0 or X is >= number of vectors
+   * Throw: "Index X is not valid for this QuantizedVectorBatch object"
+   */
+  double Dot(int i, int j) const;
+  double SquaredL2(int i, int j) const;
+
+  /*
+   * Dot product and squared distance from a full-precision query to every vector, in order.
+   * When: query.GetNumDimensions() != GetNumDimensions()
+   * Throw: "Dimensions of LHS(X) and RHS(Y) do not match"
+   */
+  std::vector<double> Dot(const EuclideanVector& query, int num_threads = 0) const;
+  std::vector<double> SquaredL2(const EuclideanVector& query, int num_threads = 0) const;
+
+ private:
+  int Code(int i, int j) const noexcept;
+  double Offset(int i, int j) const noexcept;
+  double Scale(int i, int j) const noexcept;
+  void CheckIndex(int i) const;
+
+  std::vector<std::uint8_t> codes_;
+  // One entry per vector for kPerVector, one per dimension for kPerDimension.
+  std::vector<double> offsets_;
+  std::vector<double> scales_;
+  // Per vector: sum of the codes (kPerVector only) and squared norm of the dequantized vector.
+  std::vector<std::int64_t> code_sums_;
+  std::vector<double> squared_norms_;
+  int num_vectors_ = 0;
+  int num_dimensions_ = 0;
+  QuantizedType type_ = QuantizedType::kUint8;
+  QuantizationScope scope_ = QuantizationScope::kPerVector;
+};
+
+#endif  // ASSIGNMENTS_EV_QUANTIZATION_H_
@@ -0,0 +1,171 @@
+/*
+
+  == Explanation and rational of testing ==
+
+  Quantization is lossy, so the first tests bound the error: every coordinate must come back
+  within half a step of the original, and the extremes of each range must come back exactly.
+  Every distance is defined against the dequantized vectors, so they are compared with the
+  ordinary EuclideanVector operators applied to GetVector(), for both code types and both scopes.
+  This covers the integer kernel path of kPerVector and the mixed path used for queries.
+  Constant vectors (a zero-width range) and the error cases are tested last.
+
+*/
+
+#include "assignments/ev/quantization.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+#include "assignments/ev/euclidean_vector.h"
+#include "assignments/ev/euclidean_vector_batch.h"
+#include "catch.h"
+
+namespace {
+
+// Dimensions are given very different spreads so the two scopes behave differently.
+EuclideanVectorBatch MakeBatch(int n, int dimensions) {
+  std::mt19937_64 rng(5);
+  std::normal_distribution<double> normal(0.0, 1.0);
+  EuclideanVectorBatch batch(n, dimensions);
+  for (auto i = 0; i < n; ++i) {
+    for (auto j = 0; j < dimensions; ++j) {
+      batch.Row(i)[j] = normal(rng) * (j % 4 + 1) + j % 3;
+    }
+  }
+  return batch;
+}
+
+double SquaredNorm(const EuclideanVector& v) {
+  const auto norm = v.GetEuclideanNorm();
+  return norm * norm;
+}
+
+}  // namespace
+
+TEST_CASE("Quantization round trip") {
+  const auto batch = MakeBatch(300, 37);
+  const auto types = {QuantizedType::kUint8, QuantizedType::kInt8};
+  const auto scopes = {QuantizationScope::kPerVector, QuantizationScope::kPerDimension};
+
+  SECTION("TEST CASE 1 - Every coordinate is within half a step") {
+    std::vector<double> column_min(batch.Row(0), batch.Row(0) + 37);
+    auto column_max = column_min;
+    for (auto i = 0; i < 300; ++i) {
+      for (auto j = 0; j < 37; ++j) {
+        column_min[j] = std::min(column_min[j], batch.Row(i)[j]);
+        column_max[j] = std::max(column_max[j], batch.Row(i)[j]);
+      }
+    }
+    for (auto type : types) {
+      for (auto scope : scopes) {
+        const QuantizedVectorBatch quantized(batch, type, scope, 3);
+        REQUIRE(quantized.GetNumVectors() == 300);
+        REQUIRE(quantized.GetNumDimensions() == 37);
+        REQUIRE(quantized.GetType() == type);
+        REQUIRE(quantized.GetScope() == scope);
+        const auto restored = quantized.ToBatch(2);
+        for (auto i = 0; i < 300; ++i) {
+          const auto v = quantized.GetVector(i);
+          auto min = batch.Row(i)[0], max = min;
+          for (auto j = 0; j < 37; ++j) {
+            min = std::min(min, batch.Row(i)[j]);
+            max = std::max(max, batch.Row(i)[j]);
+          }
+          for (auto j = 0; j < 37; ++j) {
+            REQUIRE(restored.Row(i)[j] == v[j]);
+            const auto step = scope == QuantizationScope::kPerVector
+                                  ? (max - min) / 255
+                                  : (column_max[j] - column_min[j]) / 255;
+            REQUIRE(std::abs(v[j] - batch.Row(i)[j]) <= step / 2 + 1e-12);
+          }
+        }
+      }
+    }
+  }
+
+  SECTION("TEST CASE 2 - Range extremes are exact and codes cover the full range") {
+    EuclideanVector v(5);
+    v[0] = -3.0;
+    v[1] = 1.0;
+    v[2] = 5.0;
+    v[3] = 0.0;
+    v[4] = 5.0;
+    const QuantizedVectorBatch unsigned_codes(EuclideanVectorBatch({v}), QuantizedType::kUint8,
+                                              QuantizationScope::kPerVector);
+    REQUIRE(unsigned_codes.Row(0)[0] == 0);
+    REQUIRE(unsigned_codes.Row(0)[2] == 255);
+    const QuantizedVectorBatch signed_codes(EuclideanVectorBatch({v}), QuantizedType::kInt8,
+                                            QuantizationScope::kPerVector);
+    REQUIRE(static_cast<std::int8_t>(signed_codes.Row(0)[0]) == -128);
+    REQUIRE(static_cast<std::int8_t>(signed_codes.Row(0)[2]) == 127);
+    for (const auto& quantized : {unsigned_codes, signed_codes}) {
+      const auto restored = quantized.GetVector(0);
+      REQUIRE(restored[0] == Approx(-3.0));
+      REQUIRE(restored[2] == Approx(5.0));
+      REQUIRE(restored[4] == restored[2]);
+    }
+  }
+}
+
+TEST_CASE("Quantized distances") {
+  const auto batch = MakeBatch(600, 50);
+  EuclideanVector query(50);
+  for (auto j = 0; j < 50; ++j) {
+    query[j] = std::sin(j) * 2;
+  }
+
+  SECTION("TEST CASE 3 - Distances match the dequantized vectors") {
+    for (auto type : {QuantizedType::kUint8, QuantizedType::kInt8}) {
+      for (auto scope : {QuantizationScope::kPerVector, QuantizationScope::kPerDimension}) {
+        const QuantizedVectorBatch quantized(batch, type, scope);
+        const auto dots = quantized.Dot(query, 3);
+        const auto distances = quantized.SquaredL2(query, 3);
+        REQUIRE(dots.size() == 600);
+        REQUIRE(distances.size() == 600);
+        for (auto i = 0; i < 600; i += 7) {
+          const auto v = quantized.GetVector(i);
+          REQUIRE(dots[i] == Approx(query * v));
+          REQUIRE(distances[i] == Approx(SquaredNorm(query - v)));
+          const auto w = quantized.GetVector(599 - i);
+          REQUIRE(quantized.Dot(i, 599 - i) == Approx(v * w));
+          REQUIRE(quantized.SquaredL2(i, 599 - i) == Approx(SquaredNorm(v - w)));
+        }
+        REQUIRE(quantized.SquaredL2(4, 4) == Approx(0.0).margin(1e-9));
+      }
+    }
+  }
+
+  SECTION("TEST CASE 4 - Constant vectors and dimensions") {
+    EuclideanVectorBatch constant(3, 4);
+    for (auto i = 0; i < 3; ++i) {
+      for (auto j = 0; j < 4; ++j) {
+        constant.Row(i)[j] = 2.5;
+      }
+    }
+    for (auto scope : {QuantizationScope::kPerVector, QuantizationScope::kPerDimension}) {
+      const QuantizedVectorBatch quantized(constant, QuantizedType::kInt8, scope);
+      REQUIRE(quantized.GetVector(1) == EuclideanVector(4, 2.5));
+      REQUIRE(quantized.Dot(0, 2) == Approx(25.0));
+      REQUIRE(quantized.Dot(EuclideanVector(4, 1.0))[1] == Approx(10.0));
+    }
+  }
+}
+
+TEST_CASE("Quantization errors") {
+  SECTION("TEST CASE 5 - Invalid indices and dimensions") {
+    const QuantizedVectorBatch quantized(MakeBatch(3, 4), QuantizedType::kUint8,
+                                         QuantizationScope::kPerVector);
+    REQUIRE_THROWS_WITH(
+        quantized.GetVector(3),
+        Catch::Contains("Index 3 is not valid for this QuantizedVectorBatch object"));
+    REQUIRE_THROWS_WITH(quantized.Dot(-1, 0), Catch::Contains("Index -1 is not valid"));
+    REQUIRE_THROWS_WITH(quantized.SquaredL2(0, 5), Catch::Contains("Index 5 is not valid"));
+    REQUIRE_THROWS_WITH(quantized.Dot(EuclideanVector(5)),
+                        Catch::Contains("Dimensions of LHS(4) and RHS(5) do not match"));
+    REQUIRE_THROWS_WITH(quantized.SquaredL2(EuclideanVector(3)),
+                        Catch::Contains("Dimensions of LHS(4) and RHS(3) do not match"));
+  }
+}
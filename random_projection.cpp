@@ -0,0 +1,191 @@
+#include "assignments/ev/random_projection.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <numeric>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "assignments/ev/euclidean_matrix.h"
+#include "assignments/ev/euclidean_vector.h"
+#include "assignments/ev/euclidean_vector_batch.h"
+#include "assignments/ev/parallel.h"
+
+namespace {
+
+// Rows handed to a thread at a time when projecting a batch with the sparse or Hadamard kinds.
+constexpr int kProjectGrain = 64;
+
+void DimensionMismatch(int lhs, int rhs) {
+  throw EuclideanVectorError("Dimensions of LHS(" + std::to_string(lhs) + ") and RHS(" +
+                             std::to_string(rhs) + ") do not match");
+}
+
+int NextPowerOfTwo(int n) {
+  auto p = 1;
+  while (p < n) {
+    p *= 2;
+  }
+  return p;
+}
+
+// In-place unnormalised fast Walsh-Hadamard transform of x[0, n), n a power of two.
+void WalshHadamard(double* x, int n) noexcept {
+  for (auto h = 1; h < n; h *= 2) {
+    for (auto i = 0; i < n; i += 2 * h) {
+      auto* __restrict lo = x + i;
+      auto* __restrict hi = x + i + h;
+      for (auto j = 0; j < h; ++j) {
+        const auto a = lo[j];
+        const auto b = hi[j];
+        lo[j] = a + b;
+        hi[j] = a - b;
+      }
+    }
+  }
+}
+
+}  // namespace
+
+RandomProjection::RandomProjection(int input_dimensions,
+                                   int output_dimensions,
+                                   ProjectionKind kind,
+                                   std::uint64_t seed)
+  : input_dimensions_{input_dimensions}, output_dimensions_{output_dimensions}, kind_{kind} {
+  if (input_dimensions < 1 || output_dimensions < 1 ||
+      (kind == ProjectionKind::kHadamard && output_dimensions > NextPowerOfTwo(input_dimensions))) {
+    throw EuclideanVectorError("Cannot project from " + std::to_string(input_dimensions) + " to " +
+                               std::to_string(output_dimensions) + " dimensions");
+  }
+
+  std::mt19937_64 rng(seed);
+  switch (kind) {
+  case ProjectionKind::kGaussian: {
+    std::normal_distribution<double> normal(0.0, 1.0 / std::sqrt(output_dimensions));
+    matrix_ = EuclideanMatrix(output_dimensions, input_dimensions);
+    for (auto r = 0; r < output_dimensions; ++r) {
+      for (auto c = 0; c < input_dimensions; ++c) {
+        matrix_.Row(r)[c] = normal(rng);
+      }
+    }
+    break;
+  }
+  case ProjectionKind::kAchlioptas: {
+    std::uniform_int_distribution<int> die(0, 5);
+    std::vector<int> negative;
+    sparse_offset_.push_back(0);
+    for (auto r = 0; r < output_dimensions; ++r) {
+      negative.clear();
+      for (auto c = 0; c < input_dimensions; ++c) {
+        const auto roll = die(rng);
+        if (roll == 0) {
+          sparse_index_.push_back(c);
+        } else if (roll == 1) {
+          negative.push_back(c);
+        }
+      }
+      sparse_split_.push_back(static_cast<int>(sparse_index_.size()));
+      sparse_index_.insert(sparse_index_.end(), negative.begin(), negative.end());
+      sparse_offset_.push_back(static_cast<int>(sparse_index_.size()));
+    }
+    sparse_scale_ = std::sqrt(3.0 / output_dimensions);
+    break;
+  }
+  case ProjectionKind::kHadamard: {
+    padded_dimensions_ = NextPowerOfTwo(input_dimensions);
+    std::bernoulli_distribution coin(0.5);
+    signs_.resize(input_dimensions);
+    for (auto& s : signs_) {
+      s = coin(rng) ? 1.0 : -1.0;
+    }
+    // Partial Fisher-Yates shuffle picks output_dimensions distinct coordinates.
+    std::vector<int> coordinates(padded_dimensions_);
+    std::iota(coordinates.begin(), coordinates.end(), 0);
+    for (auto i = 0; i < output_dimensions; ++i) {
+      std::uniform_int_distribution<int> pick(i, padded_dimensions_ - 1);
+      std::swap(coordinates[i], coordinates[pick(rng)]);
+    }
+    sampled_.assign(coordinates.begin(), coordinates.begin() + output_dimensions);
+    std::sort(sampled_.begin(), sampled_.end());
+    // sqrt(P / d) for the subsampling times 1 / sqrt(P) to make H orthonormal.
+    hadamard_scale_ = 1.0 / std::sqrt(output_dimensions);
+    break;
+  }
+  }
+}
+
+// Used by the kinds without a stored matrix; kGaussian goes through EuclideanMatrix instead.
+void RandomProjection::ProjectRow(const double* in, double* out, double* scratch) const {
+  if (kind_ == ProjectionKind::kAchlioptas) {
+    for (auto r = 0; r < output_dimensions_; ++r) {
+      double sum = 0;
+      for (auto p = sparse_offset_[r]; p < sparse_split_[r]; ++p) {
+        sum += in[sparse_index_[p]];
+      }
+      for (auto p = sparse_split_[r]; p < sparse_offset_[r + 1]; ++p) {
+        sum -= in[sparse_index_[p]];
+      }
+      out[r] = sum * sparse_scale_;
+    }
+    return;
+  }
+
+  for (auto c = 0; c < input_dimensions_; ++c) {
+    scratch[c] = signs_[c] * in[c];
+  }
+  std::fill(scratch + input_dimensions_, scratch + padded_dimensions_, 0.0);
+  WalshHadamard(scratch, padded_dimensions_);
+  for (auto r = 0; r < output_dimensions_; ++r) {
+    out[r] = scratch[sampled_[r]] * hadamard_scale_;
+  }
+}
+
+EuclideanVector RandomProjection::Project(const EuclideanVector& v) const {
+  if (v.GetNumDimensions() != input_dimensions_) {
+    DimensionMismatch(input_dimensions_, v.GetNumDimensions());
+  }
+  if (kind_ == ProjectionKind::kGaussian) {
+    return matrix_ * v;
+  }
+  EuclideanVector result(output_dimensions_);
+  std::vector<double> scratch(padded_dimensions_);
+  ProjectRow(v.data(), result.data(), scratch.data());
+  return result;
+}
+
+EuclideanVectorBatch RandomProjection::Project(const EuclideanVectorBatch& batch,
+                                               int num_threads) const {
+  EuclideanVectorBatch result(batch.GetNumVectors(), output_dimensions_);
+  Project(batch, result, num_threads);
+  return result;
+}
+
+void RandomProjection::Project(const EuclideanVectorBatch& in,
+                               EuclideanVectorBatch& out,
+                               int num_threads) const {
+  if (kind_ == ProjectionKind::kGaussian) {
+    // A whole batch is one cache-blocked GEMM against the stored matrix.
+    Apply(matrix_, in, out, num_threads);
+    return;
+  }
+  if (in.GetNumDimensions() != input_dimensions_) {
+    DimensionMismatch(input_dimensions_, in.GetNumDimensions());
+  }
+  if (out.GetNumDimensions() != output_dimensions_) {
+    DimensionMismatch(out.GetNumDimensions(), output_dimensions_);
+  }
+  if (out.GetNumVectors() < in.GetNumVectors()) {
+    throw EuclideanVectorError("Output batch has fewer rows(" +
+                               std::to_string(out.GetNumVectors()) + ") than input batch(" +
+                               std::to_string(in.GetNumVectors()) + ")");
+  }
+  ev::detail::ParallelFor(
+      0, in.GetNumVectors(), kProjectGrain, num_threads, [&](std::int64_t lo, std::int64_t hi) {
+        std::vector<double> scratch(padded_dimensions_);
+        for (auto i = static_cast<int>(lo); i < hi; ++i) {
+          ProjectRow(in.Row(i), out.Row(i), scratch.data());
+        }
+      });
+}
@@ -0,0 +1,98 @@
+#ifndef ASSIGNMENTS_EV_RANDOM_PROJECTION_H_
+#define ASSIGNMENTS_EV_RANDOM_PROJECTION_H_
+
+#include <cstdint>
+#include <vector>
+
+#include "assignments/ev/euclidean_matrix.h"
+#include "assignments/ev/euclidean_vector.h"
+#include "assignments/ev/euclidean_vector_batch.h"
+
+enum class ProjectionKind {
+  // Dense matrix of N(0, 1/d) entries. O(D * d) per vector.
+  kGaussian,
+  // Achlioptas' sparse matrix: sqrt(3/d) * {+1, 0, -1} with probabilities {1/6, 2/3, 1/6}.
+  // About a third of the work of kGaussian.
+  kAchlioptas,
+  // Subsampled randomised Hadamard transform: random sign flips, a fast Walsh-Hadamard transform
+  // over D rounded up to a power of two, then d randomly chosen coordinates. O(D log D) per
+  // vector and no stored matrix.
+  kHadamard,
+};
+
+/*
+ * A Johnson-Lindenstrauss random projection from GetInputDimensions() to GetOutputDimensions()
+ * dimensions. Every kind is scaled so that squared norms and distances are preserved in
+ * expectation. The projection is fully determined by (dimensions, kind, seed), so the same seed
+ * reproduces the same projection across runs.
+ */
+class RandomProjection {
+ public:
+  /*
+   * When: input_dimensions < 1 or output_dimensions < 1
+   * Throw: "Cannot project from D to d dimensions"
+   * When: kind is kHadamard and output_dimensions is larger than input_dimensions rounded up to a
+   * power of two
+   * Throw: "Cannot project from D to d dimensions"
+   */
+  RandomProjection(int input_dimensions,
+                   int output_dimensions,
+                   ProjectionKind kind,
+                   std::uint64_t seed);
+
+  int GetInputDimensions() const noexcept { return input_dimensions_; }
+  int GetOutputDimensions() const noexcept { return output_dimensions_; }
+  ProjectionKind GetKind() const noexcept { return kind_; }
+
+  /*
+   * Projects one vector.
+   * When: v.GetNumDimensions() != GetInputDimensions()
+   * Throw: "Dimensions of LHS(X) and RHS(Y) do not match"
+   */
+  EuclideanVector Project(const EuclideanVector& v) const;
+
+  /*
+   * Projects every vector of the batch, in parallel.
+   * When: batch.GetNumDimensions() != GetInputDimensions()
+   * Throw: "Dimensions of LHS(X) and RHS(Y) do not match"
+   */
+  EuclideanVectorBatch Project(const EuclideanVectorBatch& batch, int num_threads = 0) const;
+
+  /*
+   * Projects in into the first in.GetNumVectors() rows of out, which must already have
+   * GetOutputDimensions() dimensions. Meant for streaming: a dataset read chunk by chunk can be
+   * projected into one reused output batch without allocating per chunk.
+   * When: in.GetNumDimensions() != GetInputDimensions() or out.GetNumDimensions() !=
+   * GetOutputDimensions()
+   * Throw: "Dimensions of LHS(X) and RHS(Y) do not match"
+   * When: out has fewer rows than in
+   * Throw: "Output batch has fewer rows(X) than input batch(Y)"
+   */
+  void Project(const EuclideanVectorBatch& in,
+               EuclideanVectorBatch& out,
+               int num_threads = 0) const;
+
+ private:
+  void ProjectRow(const double* in, double* out, double* scratch) const;
+
+  int input_dimensions_;
+  int output_dimensions_;
+  ProjectionKind kind_;
+
+  // kGaussian
+  EuclideanMatrix matrix_;
+  // kAchlioptas: output row r adds the input coordinates sparse_index_[sparse_offset_[r] ..
+  // sparse_split_[r]) and subtracts those in sparse_index_[sparse_split_[r] ..
+  // sparse_offset_[r + 1]).
+  std::vector<int> sparse_offset_;
+  std::vector<int> sparse_split_;
+  std::vector<int> sparse_index_;
+  double sparse_scale_ = 0;
+  // kHadamard
+  int padded_dimensions_ = 0;
+  std::vector<double> signs_;
+  std::vector<int> sampled_;
+  double hadamard_scale_ = 0;
+};
+
+#endif  // ASSIGNMENTS_EV_RANDOM_PROJECTION_H_
@@ -0,0 +1,111 @@
+/*
+
+  == Explanation and rational of testing ==
+
+  A random projection has no single right answer, so we test the properties it promises: the
+  output has the requested dimension, the same seed reproduces the same projection, the batch and
+  single-vector paths agree, and squared norms are preserved on average (checked over many
+  vectors with a loose tolerance). The Hadamard transform is also checked against the known
+  exact case of projecting a power-of-two dimension onto itself, which must preserve norms
+  exactly. Finally we test the exceptions.
+
+*/
+
+#include "assignments/ev/random_projection.h"
+
+#include <cmath>
+#include <vector>
+
+#include "assignments/ev/euclidean_vector_batch.h"
+#include "catch.h"
+
+namespace {
+
+EuclideanVectorBatch MakeBatch(int n, int d) {
+  EuclideanVectorBatch batch(n, d);
+  for (auto i = 0; i < n; ++i) {
+    for (auto j = 0; j < d; ++j) {
+      batch.Row(i)[j] = std::sin(i * 1.7 + j * 0.31) + (j % 5 == i % 5 ? 1.0 : 0.0);
+    }
+  }
+  return batch;
+}
+
+// Mean over the batch of |projected|^2 / |original|^2, which should be close to 1.
+double MeanNormRatio(const EuclideanVectorBatch& in, const EuclideanVectorBatch& out) {
+  double sum = 0;
+  for (auto i = 0; i < in.GetNumVectors(); ++i) {
+    const auto a = out.GetVector(i).GetEuclideanNorm();
+    const auto b = in.GetVector(i).GetEuclideanNorm();
+    sum += (a * a) / (b * b);
+  }
+  return sum / in.GetNumVectors();
+}
+
+}  // namespace
+
+TEST_CASE("Random projections preserve norms on average") {
+  const auto in = MakeBatch(400, 300);
+  for (auto kind :
+       {ProjectionKind::kGaussian, ProjectionKind::kAchlioptas, ProjectionKind::kHadamard}) {
+    const RandomProjection projection(300, 64, kind, 1234);
+    const auto out = projection.Project(in, 2);
+    REQUIRE(out.GetNumVectors() == 400);
+    REQUIRE(out.GetNumDimensions() == 64);
+    REQUIRE(MeanNormRatio(in, out) == Approx(1.0).epsilon(0.1));
+  }
+}
+
+TEST_CASE("Random projections are reproducible and consistent") {
+  const auto in = MakeBatch(20, 100);
+  for (auto kind :
+       {ProjectionKind::kGaussian, ProjectionKind::kAchlioptas, ProjectionKind::kHadamard}) {
+    const RandomProjection a(100, 16, kind, 99);
+    const RandomProjection b(100, 16, kind, 99);
+    const RandomProjection c(100, 16, kind, 100);
+
+    SECTION("TEST CASE 1 The same seed gives the same projection") {
+      REQUIRE(a.Project(in.GetVector(3)) == b.Project(in.GetVector(3)));
+      REQUIRE(a.Project(in.GetVector(3)) != c.Project(in.GetVector(3)));
+    }
+
+    SECTION("TEST CASE 2 Batch and single vector projections agree") {
+      const auto out = a.Project(in);
+      for (auto i = 0; i < in.GetNumVectors(); ++i) {
+        const auto single = a.Project(in.GetVector(i));
+        for (auto j = 0; j < 16; ++j) {
+          REQUIRE(out.Row(i)[j] == Approx(single.at(j)).margin(1e-12));
+        }
+      }
+    }
+
+    SECTION("TEST CASE 3 Streaming into a reused output batch") {
+      EuclideanVectorBatch out(32, 16);
+      a.Project(in, out);
+      REQUIRE(out.GetVector(7) == a.Project(in).GetVector(7));
+      REQUIRE(out.GetVector(25) == EuclideanVector(16));
+    }
+  }
+}
+
+TEST_CASE("Hadamard projection onto the full power-of-two dimension is an isometry") {
+  const auto in = MakeBatch(10, 64);
+  const RandomProjection projection(64, 64, ProjectionKind::kHadamard, 5);
+  for (auto i = 0; i < in.GetNumVectors(); ++i) {
+    const auto v = in.GetVector(i);
+    REQUIRE(projection.Project(v).GetEuclideanNorm() == Approx(v.GetEuclideanNorm()));
+  }
+}
+
+TEST_CASE("Random projection exceptions") {
+  REQUIRE_THROWS_WITH(RandomProjection(0, 4, ProjectionKind::kGaussian, 0),
+                      Catch::Contains("Cannot project from 0 to 4 dimensions"));
+  REQUIRE_THROWS_WITH(RandomProjection(100, 129, ProjectionKind::kHadamard, 0),
+                      Catch::Contains("Cannot project from 100 to 129 dimensions"));
+  const RandomProjection projection(10, 4, ProjectionKind::kAchlioptas, 0);
+  REQUIRE_THROWS_WITH(projection.Project(EuclideanVector(9)),
+                      Catch::Contains("Dimensions of LHS(10) and RHS(9)"));
+  EuclideanVectorBatch small(1, 4);
+  REQUIRE_THROWS_WITH(projection.Project(EuclideanVectorBatch(2, 10), small),
+                      Catch::Contains("Output batch has fewer rows(1) than input batch(2)"));
+}
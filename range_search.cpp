@@ -0,0 +1,115 @@
+#include "assignments/ev/range_search.h"
+
+#include <cmath>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "assignments/ev/euclidean_vector.h"
+#include "assignments/ev/euclidean_vector_batch.h"
+#include "assignments/ev/kernels.h"
+#include "assignments/ev/neighbor.h"
+#include "assignments/ev/parallel.h"
+
+namespace {
+
+// Vectors per parallel chunk, and so per result buffer.
+constexpr int kScanGrain = 1024;
+
+void CheckRadius(double radius) {
+  if (!(radius >= 0)) {
+    throw EuclideanVectorError("Cannot search within a radius of " + std::to_string(radius));
+  }
+}
+
+void CheckDimensions(int expected, int actual) {
+  if (expected != actual) {
+    throw EuclideanVectorError("Dimensions of LHS(" + std::to_string(expected) + ") and RHS(" +
+                               std::to_string(actual) + ") do not match");
+  }
+}
+
+// Appends the hits among rows [begin, end) to out. row(i) returns the data of vector i.
+template <typename RowFn>
+void Scan(const RowFn& row,
+          int begin,
+          int end,
+          const double* query,
+          int dimensions,
+          double squared_radius,
+          std::vector<Neighbor>& out) {
+  for (auto i = begin; i < end; ++i) {
+    const auto d = ev::kernels::SquaredL2Bounded(query, row(i), dimensions, squared_radius);
+    if (d <= squared_radius) {
+      out.push_back({i, d});
+    }
+  }
+}
+
+template <typename RowFn>
+std::vector<Neighbor> ParallelScan(const RowFn& row,
+                                   int n,
+                                   const double* query,
+                                   int dimensions,
+                                   double squared_radius,
+                                   int num_threads) {
+  const auto num_chunks = (n + kScanGrain - 1) / kScanGrain;
+  std::vector<std::vector<Neighbor>> hits(num_chunks);
+  ev::detail::ParallelFor(0, num_chunks, 1, num_threads, [&](std::int64_t lo, std::int64_t hi) {
+    for (auto c = static_cast<int>(lo); c < hi; ++c) {
+      const auto begin = c * kScanGrain;
+      const auto end = n - begin < kScanGrain ? n : begin + kScanGrain;
+      Scan(row, begin, end, query, dimensions, squared_radius, hits[c]);
+    }
+  });
+
+  // Chunks cover consecutive index ranges, so concatenating them keeps index order.
+  std::vector<Neighbor> result;
+  for (const auto& chunk : hits) {
+    result.insert(result.end(), chunk.begin(), chunk.end());
+  }
+  return result;
+}
+
+}  // namespace
+
+std::vector<Neighbor> RangeSearch(const EuclideanVectorBatch& dataset,
+                                  const EuclideanVector& query,
+                                  double radius,
+                                  int num_threads) {
+  CheckRadius(radius);
+  CheckDimensions(dataset.GetNumDimensions(), query.GetNumDimensions());
+  return ParallelScan([&dataset](int i) { return dataset.Row(i); }, dataset.GetNumVectors(),
+                      query.data(), query.GetNumDimensions(), radius * radius, num_threads);
+}
+
+std::vector<Neighbor> RangeSearch(const std::vector<EuclideanVector>& dataset,
+                                  const EuclideanVector& query,
+                                  double radius,
+                                  int num_threads) {
+  CheckRadius(radius);
+  for (const auto& v : dataset) {
+    CheckDimensions(v.GetNumDimensions(), query.GetNumDimensions());
+  }
+  return ParallelScan([&dataset](int i) { return dataset[i].data(); },
+                      static_cast<int>(dataset.size()), query.data(), query.GetNumDimensions(),
+                      radius * radius, num_threads);
+}
+
+std::vector<std::vector<Neighbor>> RangeSearch(const EuclideanVectorBatch& dataset,
+                                               const EuclideanVectorBatch& queries,
+                                               double radius,
+                                               int num_threads) {
+  CheckRadius(radius);
+  CheckDimensions(dataset.GetNumDimensions(), queries.GetNumDimensions());
+  const auto row = [&dataset](int i) { return dataset.Row(i); };
+  std::vector<std::vector<Neighbor>> result(queries.GetNumVectors());
+  ev::detail::ParallelFor(0, queries.GetNumVectors(), 1, num_threads,
+                          [&](std::int64_t lo, std::int64_t hi) {
+                            for (auto q = static_cast<int>(lo); q < hi; ++q) {
+                              Scan(row, 0, dataset.GetNumVectors(), queries.Row(q),
+                                   dataset.GetNumDimensions(), radius * radius, result[q]);
+                            }
+                          });
+  return result;
+}
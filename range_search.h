@@ -0,0 +1,39 @@
+#ifndef ASSIGNMENTS_EV_RANGE_SEARCH_H_
+#define ASSIGNMENTS_EV_RANGE_SEARCH_H_
+
+#include <vector>
+
+#include "assignments/ev/euclidean_vector.h"
+#include "assignments/ev/euclidean_vector_batch.h"
+#include "assignments/ev/neighbor.h"
+
+/*
+ * Returns every vector of dataset whose euclidean distance to query is <= radius, in index order,
+ * with Neighbor::score the squared distance. Distances are summed with
+ * ev::kernels::SquaredL2Bounded, so a candidate is dropped as soon as its partial sum passes
+ * radius^2; when few vectors are in range most of the arithmetic is skipped. The dataset is
+ * scanned in parallel chunks, each collecting its hits into its own buffer.
+ * When: radius is negative or NaN
+ * Throw: "Cannot search within a radius of R"
+ * When: the query and dataset have a different number of dimensions
+ * Throw: "Dimensions of LHS(X) and RHS(Y) do not match"
+ */
+std::vector<Neighbor> RangeSearch(const EuclideanVectorBatch& dataset,
+                                  const EuclideanVector& query,
+                                  double radius,
+                                  int num_threads = 0);
+std::vector<Neighbor> RangeSearch(const std::vector<EuclideanVector>& dataset,
+                                  const EuclideanVector& query,
+                                  double radius,
+                                  int num_threads = 0);
+
+/*
+ * RangeSearch for every row of queries: element q is the result for queries.Row(q). Queries are
+ * searched in parallel, one at a time per thread.
+ */
+std::vector<std::vector<Neighbor>> RangeSearch(const EuclideanVectorBatch& dataset,
+                                               const EuclideanVectorBatch& queries,
+                                               double radius,
+                                               int num_threads = 0);
+
+#endif  // ASSIGNMENTS_EV_RANGE_SEARCH_H_
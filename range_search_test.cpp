@@ -0,0 +1,105 @@
+/*
+
+  == Explanation and rational of testing ==
+
+  Results are compared with a brute-force filter on (a - b).GetEuclideanNorm(), for radii that
+  catch none, some and all of the dataset, across thread counts and with enough vectors to span
+  several scan chunks. Dimensions are well past the 32-element block of the early-exit kernel so
+  the exit actually happens. The three overloads must agree. Points exactly on the radius are
+  included. Finally the error cases are tested.
+
+*/
+
+#include "assignments/ev/range_search.h"
+
+#include <cmath>
+#include <limits>
+#include <vector>
+
+#include "assignments/ev/euclidean_vector.h"
+#include "assignments/ev/euclidean_vector_batch.h"
+#include "assignments/ev/neighbor.h"
+#include "assignments/ev/test_vectors.h"
+#include "catch.h"
+
+namespace {
+
+std::vector<Neighbor> BruteForce(const std::vector<EuclideanVector>& dataset,
+                                 const EuclideanVector& query,
+                                 double radius) {
+  std::vector<Neighbor> result;
+  for (auto i = 0; i < static_cast<int>(dataset.size()); ++i) {
+    const auto distance = (dataset[i] - query).GetEuclideanNorm();
+    if (distance <= radius) {
+      result.push_back({i, distance * distance});
+    }
+  }
+  return result;
+}
+
+void RequireSame(const std::vector<Neighbor>& actual, const std::vector<Neighbor>& expected) {
+  REQUIRE(actual.size() == expected.size());
+  for (auto i = std::size_t{0}; i < actual.size(); ++i) {
+    REQUIRE(actual[i].index == expected[i].index);
+    REQUIRE(actual[i].score == Approx(expected[i].score));
+  }
+}
+
+}  // namespace
+
+TEST_CASE("Range search") {
+  const auto vectors = MakeGaussianVectors(5000, 100, 1);
+  const EuclideanVectorBatch dataset(vectors);
+
+  SECTION("TEST CASE 1 - Matches a brute-force filter") {
+    // The median distance between two such vectors is about sqrt(200).
+    const auto query = vectors[10] * 0.9;
+    for (auto radius : {0.0, 5.0, 13.0, 14.0, 100.0}) {
+      const auto expected = BruteForce(vectors, query, radius);
+      for (auto threads : {1, 3, 0}) {
+        RequireSame(RangeSearch(dataset, query, radius, threads), expected);
+        RequireSame(RangeSearch(vectors, query, radius, threads), expected);
+      }
+    }
+    REQUIRE(RangeSearch(dataset, query, 100.0).size() == 5000);
+    REQUIRE(RangeSearch(dataset, query, 0.0).empty());
+  }
+
+  SECTION("TEST CASE 2 - Many queries at once") {
+    const auto queries = MakeGaussianVectors(20, 100, 2);
+    const auto results = RangeSearch(dataset, EuclideanVectorBatch(queries), 13.5, 4);
+    REQUIRE(results.size() == 20);
+    for (auto q = 0; q < 20; ++q) {
+      RequireSame(results[q], BruteForce(vectors, queries[q], 13.5));
+    }
+  }
+
+  SECTION("TEST CASE 3 - The radius is inclusive") {
+    EuclideanVector origin(64);
+    std::vector<EuclideanVector> points{EuclideanVector(64, 0.5), EuclideanVector(64, 0.25)};
+    // Every distance here is exact: |(0.5, ..., 0.5)| = sqrt(64 * 0.25) = 4.
+    const auto result = RangeSearch(points, origin, 4.0);
+    REQUIRE(result.size() == 2);
+    REQUIRE(result[0] == Neighbor{0, 16.0});
+    REQUIRE(result[1] == Neighbor{1, 4.0});
+    REQUIRE(RangeSearch(points, origin, 3.0) == std::vector<Neighbor>{{1, 4.0}});
+  }
+}
+
+TEST_CASE("Range search errors") {
+  SECTION("TEST CASE 4 - Invalid radius and dimensions") {
+    const EuclideanVectorBatch dataset(3, 4);
+    REQUIRE_THROWS_WITH(RangeSearch(dataset, EuclideanVector(4), -1.0),
+                        Catch::Contains("Cannot search within a radius of -1"));
+    REQUIRE_THROWS_WITH(
+        RangeSearch(dataset, EuclideanVector(4), std::numeric_limits<double>::quiet_NaN()),
+        Catch::Contains("Cannot search within a radius of"));
+    REQUIRE_THROWS_WITH(RangeSearch(dataset, EuclideanVector(5), 1.0),
+                        Catch::Contains("Dimensions of LHS(4) and RHS(5) do not match"));
+    REQUIRE_THROWS_WITH(RangeSearch(dataset, EuclideanVectorBatch(2, 3), 1.0),
+                        Catch::Contains("Dimensions of LHS(4) and RHS(3) do not match"));
+    const std::vector<EuclideanVector> vectors{EuclideanVector(4), EuclideanVector(2)};
+    REQUIRE_THROWS_WITH(RangeSearch(vectors, EuclideanVector(4), 1.0),
+                        Catch::Contains("Dimensions of LHS(2) and RHS(4) do not match"));
+  }
+}
@@ -0,0 +1,182 @@
+#include "assignments/ev/reductions.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "assignments/ev/aligned_buffer.h"
+#include "assignments/ev/euclidean_vector.h"
+#include "assignments/ev/euclidean_vector_batch.h"
+#include "assignments/ev/kernels.h"
+#include "assignments/ev/parallel.h"
+
+namespace {
+
+// Deterministic mode never uses fewer vectors per block than this, nor more blocks than
+// kMaxDeterministicBlocks, so the partial results stay small for very large collections.
+constexpr int kMinDeterministicBlock = 64;
+constexpr int kMaxDeterministicBlocks = 1024;
+
+// Roughly how many doubles a thread should touch per task when combining partial results.
+constexpr int kCombineGrainElements = 1 << 14;
+
+enum class ReduceOp { kSum, kWeightedSum, kMin, kMax };
+
+void Combine(ReduceOp op, double* dst, const double* src, int n) noexcept {
+  switch (op) {
+  case ReduceOp::kSum:
+  case ReduceOp::kWeightedSum: ev::kernels::Add(dst, src, n); break;
+  case ReduceOp::kMin: ev::kernels::Min(dst, src, n); break;
+  case ReduceOp::kMax: ev::kernels::Max(dst, src, n); break;
+  }
+}
+
+// Reduces rows [0, n) of dimension d, where row_at(i) returns a pointer to the i-th row.
+template <typename RowAt>
+EuclideanVector BlockedReduce(int n,
+                              int d,
+                              RowAt row_at,
+                              ReduceOp op,
+                              const double* weights,
+                              const ReductionOptions& options) {
+  if (n == 0) {
+    throw EuclideanVectorError("Cannot reduce an empty collection of EuclideanVectors");
+  }
+
+  int block_size;
+  if (options.deterministic) {
+    block_size = std::max(kMinDeterministicBlock,
+                          (n + kMaxDeterministicBlocks - 1) / kMaxDeterministicBlocks);
+  } else {
+    const auto threads = std::min(n, ev::detail::ResolveThreadCount(options.num_threads));
+    block_size = (n + threads - 1) / threads;
+  }
+  const auto num_blocks = (n + block_size - 1) / block_size;
+  const auto stride = ev::detail::PadToCacheLine(d);
+  auto partials = ev::detail::AllocateAligned(static_cast<std::size_t>(num_blocks) * stride);
+
+  // Reduce each block serially into its own partial result.
+  ev::detail::ParallelFor(
+      0, num_blocks, 1, options.num_threads, [&](std::int64_t first, std::int64_t last) {
+        for (auto b = first; b < last; ++b) {
+          auto* partial = partials.get() + b * stride;
+          const auto lo = static_cast<int>(b * block_size);
+          const auto hi = std::min(n, lo + block_size);
+          if (op == ReduceOp::kWeightedSum) {
+            for (auto i = lo; i < hi; ++i) {
+              ev::kernels::Axpy(partial, weights[i], row_at(i), d);
+            }
+          } else {
+            std::copy(row_at(lo), row_at(lo) + d, partial);
+            for (auto i = lo + 1; i < hi; ++i) {
+              Combine(op, partial, row_at(i), d);
+            }
+          }
+        }
+      });
+
+  // Combine the partial results pairwise: level k adds block b + 2^k into block b.
+  const auto grain = std::max(1, kCombineGrainElements / std::max(1, d));
+  for (auto step = 1; step < num_blocks; step *= 2) {
+    const auto num_pairs = (num_blocks + 2 * step - 1) / (2 * step);
+    ev::detail::ParallelFor(
+        0, num_pairs, grain, options.num_threads, [&](std::int64_t first, std::int64_t last) {
+          for (auto p = first; p < last; ++p) {
+            const auto b = p * 2 * step;
+            if (b + step < num_blocks) {
+              Combine(op, partials.get() + b * stride, partials.get() + (b + step) * stride, d);
+            }
+          }
+        });
+  }
+
+  EuclideanVector result(d);
+  std::copy(partials.get(), partials.get() + d, result.data());
+  return result;
+}
+
+EuclideanVector Reduce(const std::vector<EuclideanVector>& vectors,
+                       ReduceOp op,
+                       const double* weights,
+                       const ReductionOptions& options) {
+  const auto d = ev::detail::CommonDimension(vectors);
+  return BlockedReduce(
+      static_cast<int>(vectors.size()), d, [&](int i) { return vectors[i].data(); }, op,
+      weights, options);
+}
+
+EuclideanVector Reduce(const EuclideanVectorBatch& batch,
+                       ReduceOp op,
+                       const double* weights,
+                       const ReductionOptions& options) {
+  return BlockedReduce(
+      batch.GetNumVectors(), batch.GetNumDimensions(), [&](int i) { return batch.Row(i); }, op,
+      weights, options);
+}
+
+void CheckWeights(const std::vector<double>& weights, int num_vectors) {
+  if (static_cast<int>(weights.size()) != num_vectors) {
+    throw EuclideanVectorError("Number of weights(" + std::to_string(weights.size()) +
+                               ") does not match number of vectors(" +
+                               std::to_string(num_vectors) + ")");
+  }
+}
+
+}  // namespace
+
+// Sum
+EuclideanVector Sum(const std::vector<EuclideanVector>& vectors, const ReductionOptions& options) {
+  return Reduce(vectors, ReduceOp::kSum, nullptr, options);
+}
+
+EuclideanVector Sum(const EuclideanVectorBatch& batch, const ReductionOptions& options) {
+  return Reduce(batch, ReduceOp::kSum, nullptr, options);
+}
+
+// Mean
+EuclideanVector Mean(const std::vector<EuclideanVector>& vectors, const ReductionOptions& options) {
+  auto result = Sum(vectors, options);
+  result /= static_cast<double>(vectors.size());
+  return result;
+}
+
+EuclideanVector Mean(const EuclideanVectorBatch& batch, const ReductionOptions& options) {
+  auto result = Sum(batch, options);
+  result /= static_cast<double>(batch.GetNumVectors());
+  return result;
+}
+
+// Weighted sum
+EuclideanVector WeightedSum(const std::vector<EuclideanVector>& vectors,
+                            const std::vector<double>& weights,
+                            const ReductionOptions& options) {
+  CheckWeights(weights, static_cast<int>(vectors.size()));
+  return Reduce(vectors, ReduceOp::kWeightedSum, weights.data(), options);
+}
+
+EuclideanVector WeightedSum(const EuclideanVectorBatch& batch,
+                            const std::vector<double>& weights,
+                            const ReductionOptions& options) {
+  CheckWeights(weights, batch.GetNumVectors());
+  return Reduce(batch, ReduceOp::kWeightedSum, weights.data(), options);
+}
+
+// Element-wise min / max
+EuclideanVector ElementwiseMin(const std::vector<EuclideanVector>& vectors,
+                               const ReductionOptions& options) {
+  return Reduce(vectors, ReduceOp::kMin, nullptr, options);
+}
+
+EuclideanVector ElementwiseMin(const EuclideanVectorBatch& batch, const ReductionOptions& options) {
+  return Reduce(batch, ReduceOp::kMin, nullptr, options);
+}
+
+EuclideanVector ElementwiseMax(const std::vector<EuclideanVector>& vectors,
+                               const ReductionOptions& options) {
+  return Reduce(vectors, ReduceOp::kMax, nullptr, options);
+}
+
+EuclideanVector ElementwiseMax(const EuclideanVectorBatch& batch, const ReductionOptions& options) {
+  return Reduce(batch, ReduceOp::kMax, nullptr, options);
+}
@@ -0,0 +1,76 @@
+#ifndef ASSIGNMENTS_EV_REDUCTIONS_H_
+#define ASSIGNMENTS_EV_REDUCTIONS_H_
+
+#include <vector>
+
+#include "assignments/ev/euclidean_vector.h"
+#include "assignments/ev/euclidean_vector_batch.h"
+
+/*
+ * Controls how a reduction over a collection of EuclideanVectors is parallelised.
+ */
+struct ReductionOptions {
+  /*
+   * Maximum number of threads to use. 0 means one per hardware thread.
+   */
+  int num_threads = 0;
+
+  /*
+   * When true the collection is split into blocks whose boundaries depend only on the number of
+   * vectors, and the per-block partial results are combined in a fixed pairwise tree. The result
+   * is then bit-identical for any num_threads. When false the split follows the thread count,
+   * which needs fewer partial results but makes rounding depend on num_threads.
+   */
+  bool deterministic = false;
+};
+
+/*
+ * Returns the element-wise sum of the vectors.
+ * When: the collection is empty
+ * Throw: "Cannot reduce an empty collection of EuclideanVectors"
+ * When: the vectors do not all have the same number of dimensions
+ * Throw: "Dimensions of LHS(X) and RHS(Y) do not match"
+ */
+EuclideanVector Sum(const std::vector<EuclideanVector>& vectors,
+                    const ReductionOptions& options = {});
+EuclideanVector Sum(const EuclideanVectorBatch& batch, const ReductionOptions& options = {});
+
+/*
+ * Returns the mean (centroid) of the vectors, i.e. Sum(vectors) / number of vectors.
+ * Throws in the same cases as Sum.
+ */
+EuclideanVector Mean(const std::vector<EuclideanVector>& vectors,
+                     const ReductionOptions& options = {});
+EuclideanVector Mean(const EuclideanVectorBatch& batch, const ReductionOptions& options = {});
+
+/*
+ * Returns sum of weights[i] * vectors[i]. Dividing by the sum of the weights gives a weighted
+ * centroid.
+ * When: weights.size() does not equal the number of vectors
+ * Throw: "Number of weights(X) does not match number of vectors(Y)"
+ * Otherwise throws in the same cases as Sum.
+ */
+EuclideanVector WeightedSum(const std::vector<EuclideanVector>& vectors,
+                            const std::vector<double>& weights,
+                            const ReductionOptions& options = {});
+EuclideanVector WeightedSum(const EuclideanVectorBatch& batch,
+                            const std::vector<double>& weights,
+                            const ReductionOptions& options = {});
+
+/*
+ * Returns the element-wise minimum of the vectors. Throws in the same cases as Sum.
+ */
+EuclideanVector ElementwiseMin(const std::vector<EuclideanVector>& vectors,
+                               const ReductionOptions& options = {});
+EuclideanVector ElementwiseMin(const EuclideanVectorBatch& batch,
+                               const ReductionOptions& options = {});
+
+/*
+ * Returns the element-wise maximum of the vectors. Throws in the same cases as Sum.
+ */
+EuclideanVector ElementwiseMax(const std::vector<EuclideanVector>& vectors,
+                               const ReductionOptions& options = {});
+EuclideanVector ElementwiseMax(const EuclideanVectorBatch& batch,
+                               const ReductionOptions& options = {});
+
+#endif  // ASSIGNMENTS_EV_REDUCTIONS_H_
@@ -0,0 +1,132 @@
+/*
+
+  == Explanation and rational of testing ==
+
+  Each reduction is checked against a value worked out by hand, for both the std::vector and the
+  batch overloads. Collections are made large enough to be split into several blocks so the
+  parallel combine step is exercised. Deterministic mode is tested by comparing the results of
+  different thread counts bit for bit, using values whose sum depends on the order of addition.
+
+*/
+
+#include "assignments/ev/reductions.h"
+
+#include <vector>
+
+#include "assignments/ev/euclidean_vector_batch.h"
+#include "catch.h"
+
+namespace {
+
+// Vectors [i, -i, 1] for i in [0, n).
+std::vector<EuclideanVector> MakeVectors(int n) {
+  std::vector<EuclideanVector> vectors;
+  for (auto i = 0; i < n; ++i) {
+    std::vector<double> l{static_cast<double>(i), static_cast<double>(-i), 1.0};
+    vectors.emplace_back(l.begin(), l.end());
+  }
+  return vectors;
+}
+
+}  // namespace
+
+TEST_CASE("Sum and Mean of a collection of Euclidean Vectors") {
+  const int n = 1000;
+  const auto vectors = MakeVectors(n);
+  const EuclideanVectorBatch batch(vectors);
+  const double expected = n * (n - 1) / 2.0;
+
+  SECTION("TEST CASE 1 Sum over a std::vector") {
+    const auto sum = Sum(vectors, {4, false});
+    REQUIRE(sum.GetNumDimensions() == 3);
+    REQUIRE(sum.at(0) == expected);
+    REQUIRE(sum.at(1) == -expected);
+    REQUIRE(sum.at(2) == n);
+  }
+
+  SECTION("TEST CASE 2 Sum over a batch") {
+    REQUIRE(Sum(batch, {3, true}) == Sum(vectors, {1, false}));
+  }
+
+  SECTION("TEST CASE 3 Mean is the centroid") {
+    const auto mean = Mean(batch);
+    REQUIRE(mean.at(0) == expected / n);
+    REQUIRE(mean.at(1) == -expected / n);
+    REQUIRE(mean.at(2) == 1.0);
+    REQUIRE(Mean(vectors) == mean);
+  }
+
+  SECTION("TEST CASE 4 Exception will be thrown on an empty collection") {
+    REQUIRE_THROWS_WITH(Sum(std::vector<EuclideanVector>{}),
+                        Catch::Contains("Cannot reduce an empty collection"));
+    REQUIRE_THROWS_WITH(Mean(EuclideanVectorBatch(0, 3)),
+                        Catch::Contains("Cannot reduce an empty collection"));
+  }
+
+  SECTION("TEST CASE 5 Exception will be thrown when dimensions differ") {
+    auto bad = vectors;
+    bad.push_back(EuclideanVector(2));
+    REQUIRE_THROWS_WITH(Sum(bad), Catch::Contains("Dimensions of LHS"));
+  }
+}
+
+TEST_CASE("Deterministic reductions do not depend on the thread count") {
+  // Magnitudes spanning many orders of magnitude, so the rounding depends on the summation order.
+  std::vector<EuclideanVector> vectors;
+  for (auto i = 0; i < 5000; ++i) {
+    vectors.emplace_back(4, (i % 7 == 0 ? 1e16 : 1.0) / (i + 1));
+  }
+
+  const auto reference = Sum(vectors, {1, true});
+  for (auto threads : {2, 3, 8}) {
+    const auto sum = Sum(vectors, {threads, true});
+    for (auto i = 0; i < sum.GetNumDimensions(); ++i) {
+      REQUIRE(sum.at(i) == reference.at(i));
+    }
+  }
+}
+
+TEST_CASE("Weighted sum of a collection of Euclidean Vectors") {
+  const auto vectors = MakeVectors(300);
+  std::vector<double> weights(300, 0.0);
+  weights[10] = 2.0;
+  weights[299] = -1.0;
+
+  SECTION("TEST CASE 1 Weighted sum over a std::vector") {
+    const auto sum = WeightedSum(vectors, weights, {4, true});
+    REQUIRE(sum.at(0) == 20.0 - 299.0);
+    REQUIRE(sum.at(1) == -20.0 + 299.0);
+    REQUIRE(sum.at(2) == 1.0);
+  }
+
+  SECTION("TEST CASE 2 Weighted sum over a batch") {
+    REQUIRE(WeightedSum(EuclideanVectorBatch(vectors), weights) == WeightedSum(vectors, weights));
+  }
+
+  SECTION("TEST CASE 3 Exception will be thrown when the number of weights differs") {
+    weights.pop_back();
+    REQUIRE_THROWS_WITH(WeightedSum(vectors, weights),
+                        Catch::Contains("Number of weights(299) does not match"));
+  }
+}
+
+TEST_CASE("Element-wise minimum and maximum of a collection of Euclidean Vectors") {
+  const auto vectors = MakeVectors(500);
+  const EuclideanVectorBatch batch(vectors);
+
+  SECTION("TEST CASE 1 Minimum") {
+    const auto min = ElementwiseMin(vectors, {4, false});
+    REQUIRE(min.at(0) == 0.0);
+    REQUIRE(min.at(1) == -499.0);
+    REQUIRE(min.at(2) == 1.0);
+    REQUIRE(ElementwiseMin(batch, {2, true}) == min);
+  }
+
+  SECTION("TEST CASE 2 Maximum") {
+    const auto max = ElementwiseMax(batch, {4, true});
+    REQUIRE(max.at(0) == 499.0);
+    REQUIRE(max.at(1) == 0.0);
+    REQUIRE(max.at(2) == 1.0);
+    REQUIRE(ElementwiseMax(vectors) == max);
+  }
+}
@@ -0,0 +1,153 @@
+#include "assignments/ev/running_statistics.h"
+
+#include <algorithm>
+#include <string>
+
+#include "assignments/ev/euclidean_matrix.h"
+#include "assignments/ev/euclidean_vector.h"
+#include "assignments/ev/euclidean_vector_batch.h"
+#include "assignments/ev/euclidean_vector_status.h"
+#include "assignments/ev/kernels.h"
+
+namespace {
+
+void CheckSameDimensions(int lhs, int rhs) {
+  if (lhs != rhs) {
+    EuclideanVectorStatus(EuclideanVectorErrc::kDimensionMismatch, lhs, rhs).ThrowIfError();
+  }
+}
+
+}  // namespace
+
+// Constructors
+RunningStatistics::RunningStatistics(int num_dimensions, bool track_covariance)
+  : track_covariance_{track_covariance}, mean_(num_dimensions), m2_(num_dimensions),
+    comoment_(track_covariance ? num_dimensions : 0, track_covariance ? num_dimensions : 0),
+    delta_(num_dimensions) {}
+
+void RunningStatistics::Add(const EuclideanVector& v) {
+  const auto n = GetNumDimensions();
+  CheckSameDimensions(n, v.GetNumDimensions());
+  ++count_;
+  const auto inv_count = 1.0 / count_;
+  ev::kernels::WelfordStep(mean_.data(), m2_.data(), delta_.data(), v.data(), inv_count, n);
+  if (track_covariance_) {
+    // A rank-1 update: v minus the new mean is (1 - inv_count) * delta.
+    const auto* delta = delta_.data();
+    for (auto r = 0; r < n; ++r) {
+      ev::kernels::Axpy(comoment_.Row(r), (1 - inv_count) * delta[r], delta, n);
+    }
+  }
+}
+
+void RunningStatistics::Add(const EuclideanVectorBatch& batch) {
+  const auto n = GetNumDimensions();
+  CheckSameDimensions(n, batch.GetNumDimensions());
+  const auto k = batch.GetNumVectors();
+  if (k == 0) {
+    return;
+  }
+  RunningStatistics part(n);
+  for (auto i = 0; i < k; ++i) {
+    ++part.count_;
+    ev::kernels::WelfordStep(part.mean_.data(), part.m2_.data(), part.delta_.data(),
+                             batch.Row(i), 1.0 / part.count_, n);
+  }
+  if (track_covariance_) {
+    // The batch's comoment is C^T C for the batch centred on its own mean: one rank-k GEMM
+    // instead of k rank-1 updates.
+    EuclideanMatrix centered(k, n);
+    for (auto i = 0; i < k; ++i) {
+      std::copy(batch.Row(i), batch.Row(i) + n, centered.Row(i));
+      ev::kernels::Sub(centered.Row(i), part.mean_.data(), n);
+    }
+    part.comoment_ = centered.Transpose() * centered;
+    part.track_covariance_ = true;
+  }
+  Merge(part);
+}
+
+void RunningStatistics::Merge(const RunningStatistics& other) {
+  if (&other == this) {
+    const auto copy = other;
+    Merge(copy);
+    return;
+  }
+  const auto n = GetNumDimensions();
+  CheckSameDimensions(n, other.GetNumDimensions());
+  if (track_covariance_ && !other.track_covariance_) {
+    throw EuclideanVectorError(
+        "Cannot merge statistics without a covariance into ones with a covariance");
+  }
+  if (other.count_ == 0) {
+    return;
+  }
+  const auto total = count_ + other.count_;
+  // delta = other.mean_ - mean_; the mean moves by other.count_ / total of it, and the
+  // comoments gain count_ * other.count_ / total times its outer product.
+  auto* delta = delta_.data();
+  std::copy(other.mean_.data(), other.mean_.data() + n, delta);
+  ev::kernels::Sub(delta, mean_.data(), n);
+  const auto weight = static_cast<double>(count_) * other.count_ / total;
+  ev::kernels::Axpy(mean_.data(), static_cast<double>(other.count_) / total, delta, n);
+  ev::kernels::Add(m2_.data(), other.m2_.data(), n);
+  auto* m2 = m2_.data();
+  for (auto i = 0; i < n; ++i) {
+    m2[i] += weight * delta[i] * delta[i];
+  }
+  if (track_covariance_) {
+    for (auto r = 0; r < n; ++r) {
+      ev::kernels::Add(comoment_.Row(r), other.comoment_.Row(r), n);
+      ev::kernels::Axpy(comoment_.Row(r), weight * delta[r], delta, n);
+    }
+  }
+  count_ = total;
+}
+
+EuclideanVector RunningStatistics::GetMean() const {
+  CheckCount(1);
+  return mean_;
+}
+
+EuclideanVector RunningStatistics::GetVariance() const {
+  CheckCount(1);
+  return m2_ / static_cast<double>(count_);
+}
+
+EuclideanVector RunningStatistics::GetSampleVariance() const {
+  CheckCount(2);
+  return m2_ / static_cast<double>(count_ - 1);
+}
+
+EuclideanMatrix RunningStatistics::GetCovariance() const {
+  CheckCovariance();
+  CheckCount(1);
+  return ScaledComoment(1.0 / count_);
+}
+
+EuclideanMatrix RunningStatistics::GetSampleCovariance() const {
+  CheckCovariance();
+  CheckCount(2);
+  return ScaledComoment(1.0 / (count_ - 1));
+}
+
+void RunningStatistics::CheckCount(long minimum) const {
+  if (count_ < minimum) {
+    throw EuclideanVectorError("Cannot compute this statistic from " + std::to_string(count_) +
+                               " vectors");
+  }
+}
+
+void RunningStatistics::CheckCovariance() const {
+  if (!track_covariance_) {
+    throw EuclideanVectorError("These statistics do not track the covariance");
+  }
+}
+
+EuclideanMatrix RunningStatistics::ScaledComoment(double scale) const {
+  auto result = comoment_;
+  for (auto r = 0; r < result.GetNumRows(); ++r) {
+    ev::kernels::Scale(result.Row(r), scale, result.GetNumCols());
+  }
+  return result;
+}
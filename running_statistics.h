@@ -0,0 +1,86 @@
+#ifndef ASSIGNMENTS_EV_RUNNING_STATISTICS_H_
+#define ASSIGNMENTS_EV_RUNNING_STATISTICS_H_
+
+#include "assignments/ev/euclidean_matrix.h"
+#include "assignments/ev/euclidean_vector.h"
+#include "assignments/ev/euclidean_vector_batch.h"
+
+/*
+ * Per-dimension mean and variance, and optionally the covariance matrix, of a stream of
+ * EuclideanVectors, kept without storing the vectors. Each vector is folded in with Welford's
+ * method in O(D) (O(D^2) with covariance). A batch is summarised on its own, its covariance with
+ * one rank-k matrix product, and then merged in. Statistics gathered separately, e.g. one per
+ * thread, are combined with Merge; the result matches adding every vector to one object up to
+ * rounding.
+ */
+class RunningStatistics {
+ public:
+  /*
+   * Empty statistics of vectors with num_dimensions dimensions. The D x D covariance is only
+   * kept when track_covariance is set.
+   */
+  explicit RunningStatistics(int num_dimensions, bool track_covariance = false);
+
+  /*
+   * Folds in one vector, or every vector of a batch.
+   * When: the vector or batch does not have GetNumDimensions() dimensions
+   * Throw: "Dimensions of LHS(X) and RHS(Y) do not match"
+   */
+  void Add(const EuclideanVector& v);
+  void Add(const EuclideanVectorBatch& batch);
+
+  /*
+   * Folds in the statistics of other (Chan et al.'s parallel update).
+   * When: other does not have GetNumDimensions() dimensions
+   * Throw: "Dimensions of LHS(X) and RHS(Y) do not match"
+   * When: these statistics track the covariance and other does not
+   * Throw: "Cannot merge statistics without a covariance into ones with a covariance"
+   */
+  void Merge(const RunningStatistics& other);
+
+  int GetNumDimensions() const noexcept { return mean_.GetNumDimensions(); }
+  long GetCount() const noexcept { return count_; }
+  bool TracksCovariance() const noexcept { return track_covariance_; }
+
+  /*
+   * The per-dimension mean.
+   * When: no vector has been added
+   * Throw: "Cannot compute this statistic from 0 vectors"
+   */
+  EuclideanVector GetMean() const;
+
+  /*
+   * The per-dimension variance, dividing by the count (population) or the count minus one
+   * (sample).
+   * When: the count is below 1 (population) or 2 (sample)
+   * Throw: "Cannot compute this statistic from X vectors"
+   */
+  EuclideanVector GetVariance() const;
+  EuclideanVector GetSampleVariance() const;
+
+  /*
+   * The D x D covariance matrix, dividing as GetVariance and GetSampleVariance do.
+   * When: the covariance is not tracked
+   * Throw: "These statistics do not track the covariance"
+   * Otherwise throws in the same cases as GetVariance and GetSampleVariance.
+   */
+  EuclideanMatrix GetCovariance() const;
+  EuclideanMatrix GetSampleCovariance() const;
+
+ private:
+  void CheckCount(long minimum) const;
+  void CheckCovariance() const;
+  EuclideanMatrix ScaledComoment(double scale) const;
+
+  long count_ = 0;
+  bool track_covariance_;
+  EuclideanVector mean_;
+  // Sum of squared differences from the mean, per dimension.
+  EuclideanVector m2_;
+  // Sum of the outer products of the differences from the mean; 0 x 0 when not tracked.
+  EuclideanMatrix comoment_;
+  // Scratch space for the difference of the latest vector from the mean.
+  EuclideanVector delta_;
+};
+
+#endif  // ASSIGNMENTS_EV_RUNNING_STATISTICS_H_
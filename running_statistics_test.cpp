@@ -0,0 +1,182 @@
+/*
+
+  == Explanation and rational of testing ==
+
+  Every statistic is compared with a two-pass computation over the stored vectors: first the
+  mean, then the squared differences from it. The vectors sit on a large offset, where summing
+  squares and subtracting the squared mean would lose most digits, so a naive streaming formula
+  would fail the comparison. The same vectors are then fed one by one, as batches of several
+  sizes, and split across accumulators that are merged in different orders, and every route must
+  agree. The error cases are tested last.
+
+*/
+
+#include "assignments/ev/running_statistics.h"
+
+#include <cmath>
+#include <vector>
+
+#include "assignments/ev/euclidean_matrix.h"
+#include "assignments/ev/euclidean_vector.h"
+#include "assignments/ev/euclidean_vector_batch.h"
+#include "catch.h"
+
+namespace {
+
+constexpr auto kDimensions = 11;
+
+std::vector<EuclideanVector> MakeVectors(int count) {
+  std::vector<EuclideanVector> vectors;
+  for (auto i = 0; i < count; ++i) {
+    EuclideanVector v(kDimensions);
+    for (auto d = 0; d < kDimensions; ++d) {
+      v[d] = 1e6 + std::sin(i * 0.37 + d * 1.1) * (d + 1) + (d % 2 == 0 ? i * 0.01 : 0);
+    }
+    vectors.push_back(v);
+  }
+  return vectors;
+}
+
+struct TwoPass {
+  explicit TwoPass(const std::vector<EuclideanVector>& vectors)
+    : mean(kDimensions), comoment(kDimensions, kDimensions) {
+    for (const auto& v : vectors) {
+      mean += v;
+    }
+    mean /= static_cast<double>(vectors.size());
+    for (const auto& v : vectors) {
+      const auto diff = v - mean;
+      for (auto r = 0; r < kDimensions; ++r) {
+        for (auto c = 0; c < kDimensions; ++c) {
+          comoment.at(r, c) += diff[r] * diff[c];
+        }
+      }
+    }
+  }
+
+  EuclideanVector mean;
+  EuclideanMatrix comoment;
+};
+
+void RequireMatches(const RunningStatistics& stats, const std::vector<EuclideanVector>& vectors) {
+  const TwoPass expected(vectors);
+  const auto n = static_cast<double>(vectors.size());
+  REQUIRE(stats.GetCount() == static_cast<long>(vectors.size()));
+  const auto mean = stats.GetMean();
+  const auto variance = stats.GetVariance();
+  const auto sample_variance = stats.GetSampleVariance();
+  for (auto d = 0; d < kDimensions; ++d) {
+    REQUIRE(mean[d] == Approx(expected.mean[d]).epsilon(1e-14));
+    REQUIRE(variance[d] == Approx(expected.comoment.at(d, d) / n).epsilon(1e-9));
+    REQUIRE(sample_variance[d] == Approx(expected.comoment.at(d, d) / (n - 1)).epsilon(1e-9));
+  }
+  if (stats.TracksCovariance()) {
+    const auto covariance = stats.GetCovariance();
+    const auto sample_covariance = stats.GetSampleCovariance();
+    for (auto r = 0; r < kDimensions; ++r) {
+      for (auto c = 0; c < kDimensions; ++c) {
+        REQUIRE(covariance.at(r, c) == Approx(expected.comoment.at(r, c) / n).margin(1e-9));
+        REQUIRE(sample_covariance.at(r, c) ==
+                Approx(expected.comoment.at(r, c) / (n - 1)).margin(1e-9));
+      }
+      REQUIRE(covariance.at(r, r) == Approx(variance[r]).epsilon(1e-9));
+    }
+  }
+}
+
+EuclideanVectorBatch MakeBatch(const std::vector<EuclideanVector>& vectors, int begin, int end) {
+  return EuclideanVectorBatch(
+      std::vector<EuclideanVector>(vectors.begin() + begin, vectors.begin() + end));
+}
+
+}  // namespace
+
+TEST_CASE("Streaming statistics") {
+  const auto vectors = MakeVectors(200);
+
+  SECTION("TEST CASE 1 - One vector at a time matches two passes") {
+    RunningStatistics stats(kDimensions, true);
+    for (const auto& v : vectors) {
+      stats.Add(v);
+    }
+    RequireMatches(stats, vectors);
+
+    RunningStatistics no_covariance(kDimensions);
+    for (const auto& v : vectors) {
+      no_covariance.Add(v);
+    }
+    REQUIRE_FALSE(no_covariance.TracksCovariance());
+    RequireMatches(no_covariance, vectors);
+  }
+
+  SECTION("TEST CASE 2 - Batches of several sizes match two passes") {
+    RunningStatistics stats(kDimensions, true);
+    stats.Add(MakeBatch(vectors, 0, 1));
+    stats.Add(MakeBatch(vectors, 1, 64));
+    stats.Add(EuclideanVectorBatch(0, kDimensions));
+    stats.Add(vectors[64]);
+    stats.Add(MakeBatch(vectors, 65, 200));
+    RequireMatches(stats, vectors);
+  }
+
+  SECTION("TEST CASE 3 - Merging accumulators in any order matches two passes") {
+    RunningStatistics a(kDimensions, true);
+    RunningStatistics b(kDimensions, true);
+    RunningStatistics c(kDimensions, true);
+    RunningStatistics empty(kDimensions, true);
+    for (auto i = 0; i < 30; ++i) {
+      a.Add(vectors[i]);
+    }
+    b.Add(MakeBatch(vectors, 30, 150));
+    for (auto i = 150; i < 200; ++i) {
+      c.Add(vectors[i]);
+    }
+    auto abc = empty;
+    abc.Merge(a);
+    abc.Merge(b);
+    abc.Merge(c);
+    abc.Merge(empty);
+    RequireMatches(abc, vectors);
+    c.Merge(b);
+    c.Merge(a);
+    RequireMatches(c, vectors);
+
+    // Merging with itself is the same as seeing every vector twice.
+    auto twice = a;
+    twice.Merge(twice);
+    auto doubled = std::vector<EuclideanVector>(vectors.begin(), vectors.begin() + 30);
+    doubled.insert(doubled.end(), vectors.begin(), vectors.begin() + 30);
+    RequireMatches(twice, doubled);
+
+    // Statistics without a covariance take in ones with it, ignoring the covariance.
+    RunningStatistics means_only(kDimensions);
+    means_only.Merge(abc);
+    RequireMatches(means_only, vectors);
+  }
+}
+
+TEST_CASE("Streaming statistics errors") {
+  SECTION("TEST CASE 4 - Dimensions, counts and missing covariances") {
+    RunningStatistics stats(3, true);
+    RunningStatistics means_only(3);
+    REQUIRE_THROWS_WITH(stats.Add(EuclideanVector(4)),
+                        Catch::Contains("Dimensions of LHS(3) and RHS(4) do not match"));
+    REQUIRE_THROWS_WITH(stats.Add(EuclideanVectorBatch(2, 2)),
+                        Catch::Contains("Dimensions of LHS(3) and RHS(2) do not match"));
+    REQUIRE_THROWS_WITH(stats.Merge(RunningStatistics(5)),
+                        Catch::Contains("Dimensions of LHS(3) and RHS(5) do not match"));
+    REQUIRE_THROWS_WITH(stats.Merge(means_only),
+                        Catch::Contains("Cannot merge statistics without a covariance into ones "
+                                        "with a covariance"));
+    REQUIRE_THROWS_WITH(stats.GetMean(),
+                        Catch::Contains("Cannot compute this statistic from 0 vectors"));
+    stats.Add(EuclideanVector(3, 1.0));
+    REQUIRE(stats.GetVariance() == EuclideanVector(3));
+    REQUIRE_THROWS_WITH(stats.GetSampleVariance(),
+                        Catch::Contains("Cannot compute this statistic from 1 vectors"));
+    REQUIRE_THROWS_WITH(stats.GetSampleCovariance(),
+                        Catch::Contains("Cannot compute this statistic from 1 vectors"));
+    REQUIRE_THROWS_WITH(means_only.GetCovariance(),
+                        Catch::Contains("These statistics do not track the covariance"));
+  }
+}
@@ -0,0 +1,137 @@
+#include "assignments/ev/scan.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "assignments/ev/euclidean_vector.h"
+#include "assignments/ev/euclidean_vector_batch.h"
+#include "assignments/ev/kernels.h"
+#include "assignments/ev/pairwise.h"
+#include "assignments/ev/parallel.h"
+
+namespace {
+
+// Vectors per parallel chunk. Prefetching does not reach across chunks, so chunks are long.
+constexpr int kScanGrain = 4096;
+
+void CheckMetric(PairwiseMetric metric) {
+  if (metric == PairwiseMetric::kCosine) {
+    throw EuclideanVectorError("Scans require the kDot or kSquaredL2 metric");
+  }
+}
+
+void CheckDimensions(int expected, int actual) {
+  if (expected != actual) {
+    throw EuclideanVectorError("Dimensions of LHS(" + std::to_string(expected) + ") and RHS(" +
+                               std::to_string(actual) + ") do not match");
+  }
+}
+
+void CheckCandidate(int candidate, int size) {
+  if (candidate < 0 || candidate >= size) {
+    throw EuclideanVectorError("Index " + std::to_string(candidate) +
+                               " is not valid for this dataset");
+  }
+}
+
+// A candidate's magnitudes sit behind two dependent loads: the EuclideanVector in the dataset,
+// then its buffer. The kernels prefetch the buffer; this requests the EuclideanVector of the
+// candidate distance positions ahead.
+void PrefetchCandidate(const std::vector<EuclideanVector>& dataset,
+                       const std::vector<int>& candidates,
+                       std::size_t i,
+                       int distance) noexcept {
+  if (distance > 0 && i + distance < candidates.size()) {
+    __builtin_prefetch(&dataset[candidates[i + distance]], 0, 3);
+  }
+}
+
+// Scores the count vectors returned by row(i), collecting each chunk's row pointers first so the
+// kernel can prefetch ahead along them. prefetch(i) is called while collecting, ahead of row(i),
+// for row functions that themselves chase a pointer.
+template <typename RowFn, typename PrefetchFn>
+void ScanRows(const EuclideanVector& query,
+              const RowFn& row,
+              const PrefetchFn& prefetch,
+              int count,
+              PairwiseMetric metric,
+              double* out,
+              const ScanOptions& options) {
+  const auto n = query.GetNumDimensions();
+  ev::detail::ParallelFor(0, count, kScanGrain, options.num_threads,
+                          [&](std::int64_t lo, std::int64_t hi) {
+                            std::vector<const double*> rows(hi - lo);
+                            for (auto i = lo; i < hi; ++i) {
+                              prefetch(static_cast<int>(i));
+                              rows[i - lo] = row(static_cast<int>(i));
+                            }
+                            const auto size = static_cast<int>(hi - lo);
+                            if (metric == PairwiseMetric::kDot) {
+                              ev::kernels::DotRows(query.data(), rows.data(), n, size, out + lo,
+                                                   options.prefetch_distance,
+                                                   options.stream_results);
+                            } else {
+                              ev::kernels::SquaredL2Rows(query.data(), rows.data(), n, size,
+                                                         out + lo, options.prefetch_distance,
+                                                         options.stream_results);
+                            }
+                          });
+}
+
+}  // namespace
+
+void ScanCandidates(const EuclideanVector& query,
+                    const std::vector<EuclideanVector>& dataset,
+                    const std::vector<int>& candidates,
+                    PairwiseMetric metric,
+                    double* out,
+                    const ScanOptions& options) {
+  CheckMetric(metric);
+  const auto size = static_cast<int>(dataset.size());
+  // Checked in two passes so the second can prefetch indices the first has validated.
+  for (auto candidate : candidates) {
+    CheckCandidate(candidate, size);
+  }
+  for (std::size_t i = 0; i < candidates.size(); ++i) {
+    PrefetchCandidate(dataset, candidates, i, options.prefetch_distance);
+    CheckDimensions(query.GetNumDimensions(), dataset[candidates[i]].GetNumDimensions());
+  }
+  ScanRows(
+      query, [&](int i) { return dataset[candidates[i]].data(); },
+      [&](int i) { PrefetchCandidate(dataset, candidates, i, options.prefetch_distance); },
+      static_cast<int>(candidates.size()), metric, out, options);
+}
+
+void ScanCandidates(const EuclideanVector& query,
+                    const EuclideanVectorBatch& dataset,
+                    const std::vector<int>& candidates,
+                    PairwiseMetric metric,
+                    double* out,
+                    const ScanOptions& options) {
+  CheckMetric(metric);
+  CheckDimensions(query.GetNumDimensions(), dataset.GetNumDimensions());
+  for (auto candidate : candidates) {
+    CheckCandidate(candidate, dataset.GetNumVectors());
+  }
+  // Rows are found by arithmetic on the index, so there is no first load to prefetch.
+  ScanRows(
+      query, [&](int i) { return dataset.Row(candidates[i]); }, [](int) {},
+      static_cast<int>(candidates.size()), metric, out, options);
+}
+
+void ScanAll(const EuclideanVector& query,
+             const std::vector<EuclideanVector>& dataset,
+             PairwiseMetric metric,
+             double* out,
+             const ScanOptions& options) {
+  CheckMetric(metric);
+  for (const auto& v : dataset) {
+    CheckDimensions(query.GetNumDimensions(), v.GetNumDimensions());
+  }
+  // The vectors are visited in order, which the hardware prefetcher follows by itself.
+  ScanRows(
+      query, [&](int i) { return dataset[i].data(); }, [](int) {},
+      static_cast<int>(dataset.size()), metric, out, options);
+}
@@ -0,0 +1,64 @@
+#ifndef ASSIGNMENTS_EV_SCAN_H_
+#define ASSIGNMENTS_EV_SCAN_H_
+
+#include <vector>
+
+#include "assignments/ev/euclidean_vector.h"
+#include "assignments/ev/euclidean_vector_batch.h"
+#include "assignments/ev/pairwise.h"
+
+struct ScanOptions {
+  /*
+   * How many vectors ahead of the one being scored to prefetch. The right value covers the memory
+   * latency: larger for short vectors, smaller for long ones. 0 turns prefetching off.
+   */
+  int prefetch_distance = 8;
+
+  /*
+   * Write the results with non-temporal stores. Worth it when the output is much larger than the
+   * last-level cache and is not read again right away: the stores then do not evict the vectors
+   * still to be scanned.
+   */
+  bool stream_results = false;
+
+  /*
+   * Maximum number of threads to use. 0 means one per hardware thread.
+   */
+  int num_threads = 0;
+};
+
+/*
+ * out[i] = metric(query, dataset[candidates[i]]) for every candidate, where metric is kDot or
+ * kSquaredL2. The candidates may come in any order (e.g. from an index); the vectors they name
+ * are prefetched ahead of use, see ScanOptions. out must have room for candidates.size() values.
+ * When: metric is kCosine
+ * Throw: "Scans require the kDot or kSquaredL2 metric"
+ * When: For Input X: some candidate X is < 0 or >= the number of vectors in dataset
+ * Throw: "Index X is not valid for this dataset"
+ * When: the query and a scanned vector have a different number of dimensions
+ * Throw: "Dimensions of LHS(X) and RHS(Y) do not match"
+ */
+void ScanCandidates(const EuclideanVector& query,
+                    const std::vector<EuclideanVector>& dataset,
+                    const std::vector<int>& candidates,
+                    PairwiseMetric metric,
+                    double* out,
+                    const ScanOptions& options = {});
+void ScanCandidates(const EuclideanVector& query,
+                    const EuclideanVectorBatch& dataset,
+                    const std::vector<int>& candidates,
+                    PairwiseMetric metric,
+                    double* out,
+                    const ScanOptions& options = {});
+
+/*
+ * out[i] = metric(query, dataset[i]) for every vector of dataset. Each EuclideanVector owns a
+ * separate allocation, so even a full scan is a chain of pointers that benefits from prefetching.
+ */
+void ScanAll(const EuclideanVector& query,
+             const std::vector<EuclideanVector>& dataset,
+             PairwiseMetric metric,
+             double* out,
+             const ScanOptions& options = {});
+
+#endif  // ASSIGNMENTS_EV_SCAN_H_
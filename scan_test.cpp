@@ -0,0 +1,107 @@
+/*
+
+  == Explanation and rational of testing ==
+
+  Prefetching and streaming stores change how memory is touched, never the results, so every
+  combination of the options must give exactly the scores of the plain kernels. Candidate lists
+  are shuffled and contain repeats, and there are enough of them to span several parallel chunks.
+  The error cases are tested last.
+
+*/
+
+#include "assignments/ev/scan.h"
+
+#include <algorithm>
+#include <random>
+#include <vector>
+
+#include "assignments/ev/euclidean_vector.h"
+#include "assignments/ev/euclidean_vector_batch.h"
+#include "assignments/ev/kernels.h"
+#include "assignments/ev/pairwise.h"
+#include "assignments/ev/test_vectors.h"
+#include "catch.h"
+
+namespace {
+
+double Expected(PairwiseMetric metric, const EuclideanVector& a, const EuclideanVector& b) {
+  const auto n = a.GetNumDimensions();
+  return metric == PairwiseMetric::kDot ? ev::kernels::Dot(a.data(), b.data(), n)
+                                        : ev::kernels::SquaredL2(a.data(), b.data(), n);
+}
+
+ScanOptions MakeOptions(int prefetch_distance, bool stream_results, int num_threads) {
+  ScanOptions options;
+  options.prefetch_distance = prefetch_distance;
+  options.stream_results = stream_results;
+  options.num_threads = num_threads;
+  return options;
+}
+
+}  // namespace
+
+TEST_CASE("Scans") {
+  const auto vectors = MakeGaussianVectors(10000, 24, 4);
+  const EuclideanVectorBatch batch(vectors);
+  const auto query = MakeGaussianVectors(1, 24, 4)[0] * 0.5;
+  std::vector<int> candidates;
+  std::mt19937 rng(1);
+  std::uniform_int_distribution<int> pick(0, 9999);
+  for (auto i = 0; i < 12000; ++i) {
+    candidates.push_back(pick(rng));
+  }
+  const auto metrics = {PairwiseMetric::kDot, PairwiseMetric::kSquaredL2};
+
+  SECTION("TEST CASE 1 - Candidate scans match the plain kernels for every option") {
+    std::vector<double> from_vectors(candidates.size()), from_batch(candidates.size());
+    for (auto metric : metrics) {
+      for (auto distance : {0, 1, 8}) {
+        for (auto stream : {false, true}) {
+          const auto options = MakeOptions(distance, stream, 3);
+          ScanCandidates(query, vectors, candidates, metric, from_vectors.data(), options);
+          ScanCandidates(query, batch, candidates, metric, from_batch.data(), options);
+          for (auto i = std::size_t{0}; i < candidates.size(); ++i) {
+            const auto expected = Expected(metric, query, vectors[candidates[i]]);
+            REQUIRE(from_vectors[i] == expected);
+            REQUIRE(from_batch[i] == expected);
+          }
+        }
+      }
+    }
+  }
+
+  SECTION("TEST CASE 2 - Full scans match the plain kernels") {
+    // One spare element so the output starts misaligned.
+    std::vector<double> out(vectors.size() + 1);
+    for (auto metric : metrics) {
+      ScanAll(query, vectors, metric, out.data() + 1, MakeOptions(4, true, 0));
+      for (auto i = std::size_t{0}; i < vectors.size(); ++i) {
+        REQUIRE(out[i + 1] == Expected(metric, query, vectors[i]));
+      }
+    }
+  }
+}
+
+TEST_CASE("Scan errors") {
+  SECTION("TEST CASE 3 - Invalid metric, candidates and dimensions") {
+    const std::vector<EuclideanVector> vectors{EuclideanVector(3), EuclideanVector(4)};
+    const EuclideanVectorBatch batch(2, 3);
+    double out[2];
+    REQUIRE_THROWS_WITH(ScanAll(EuclideanVector(3), vectors, PairwiseMetric::kCosine, out),
+                        Catch::Contains("Scans require the kDot or kSquaredL2 metric"));
+    REQUIRE_THROWS_WITH(
+        ScanCandidates(EuclideanVector(3), batch, {0, 2}, PairwiseMetric::kDot, out),
+        Catch::Contains("Index 2 is not valid for this dataset"));
+    REQUIRE_THROWS_WITH(
+        ScanCandidates(EuclideanVector(3), vectors, {-1}, PairwiseMetric::kDot, out),
+        Catch::Contains("Index -1 is not valid for this dataset"));
+    REQUIRE_THROWS_WITH(
+        ScanCandidates(EuclideanVector(3), vectors, {0, 1}, PairwiseMetric::kDot, out),
+        Catch::Contains("Dimensions of LHS(3) and RHS(4) do not match"));
+    REQUIRE_THROWS_WITH(
+        ScanCandidates(EuclideanVector(2), batch, {0}, PairwiseMetric::kSquaredL2, out),
+        Catch::Contains("Dimensions of LHS(2) and RHS(3) do not match"));
+    REQUIRE_THROWS_WITH(ScanAll(EuclideanVector(3), vectors, PairwiseMetric::kDot, out),
+                        Catch::Contains("Dimensions of LHS(3) and RHS(4) do not match"));
+  }
+}
@@ -0,0 +1,127 @@
+#include "assignments/ev/sign_sketch.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "assignments/ev/euclidean_vector.h"
+#include "assignments/ev/euclidean_vector_batch.h"
+#include "assignments/ev/kernels.h"
+#include "assignments/ev/neighbor.h"
+#include "assignments/ev/parallel.h"
+#include "assignments/ev/random_projection.h"
+
+namespace {
+
+// Sketches per parallel chunk when scanning: 4096 sketches of a few words are well under L2.
+constexpr int kScanGrain = 4096;
+
+void PackSigns(const double* values, int n, std::uint64_t* words) noexcept {
+  for (auto w = 0; w < (n + 63) / 64; ++w) {
+    std::uint64_t word = 0;
+    const auto end = std::min(64, n - w * 64);
+    for (auto b = 0; b < end; ++b) {
+      word |= static_cast<std::uint64_t>(values[w * 64 + b] >= 0) << b;
+    }
+    words[w] = word;
+  }
+}
+
+bool Closer(const Neighbor& a, const Neighbor& b) noexcept {
+  return a.score != b.score ? a.score < b.score : a.index < b.index;
+}
+
+}  // namespace
+
+// Constructors
+SignSketchBatch::SignSketchBatch(int num_sketches, int num_bits)
+  : words_(static_cast<std::size_t>(num_sketches) * ((num_bits + 63) / 64)),
+    num_sketches_{num_sketches}, num_bits_{num_bits}, num_words_{(num_bits + 63) / 64} {}
+
+std::vector<int> SignSketchBatch::HammingDistances(const std::uint64_t* query) const {
+  std::vector<int> distances(num_sketches_);
+  ev::kernels::HammingRows(query, words_.data(), num_words_, num_sketches_, distances.data());
+  return distances;
+}
+
+std::vector<Neighbor> SignSketchBatch::Nearest(const std::uint64_t* query,
+                                               int k,
+                                               int num_threads) const {
+  k = std::clamp(k, 0, num_sketches_);
+  if (k == 0) {
+    return {};
+  }
+  // Each chunk keeps its own k best, then the chunks' winners are merged.
+  const auto num_chunks = (num_sketches_ + kScanGrain - 1) / kScanGrain;
+  std::vector<std::vector<Neighbor>> best(num_chunks);
+  ev::detail::ParallelFor(0, num_chunks, 1, num_threads, [&](std::int64_t lo, std::int64_t hi) {
+    std::vector<int> distances(kScanGrain);
+    for (auto c = lo; c < hi; ++c) {
+      const auto first = static_cast<int>(c) * kScanGrain;
+      const auto count = std::min(kScanGrain, num_sketches_ - first);
+      ev::kernels::HammingRows(query, Row(first), num_words_, count, distances.data());
+      auto& chunk = best[c];
+      chunk.resize(count);
+      for (auto i = 0; i < count; ++i) {
+        chunk[i] = {first + i, static_cast<double>(distances[i])};
+      }
+      const auto kept = std::min(k, count);
+      std::partial_sort(chunk.begin(), chunk.begin() + kept, chunk.end(), Closer);
+      chunk.resize(kept);
+    }
+  });
+
+  std::vector<Neighbor> result;
+  for (const auto& chunk : best) {
+    result.insert(result.end(), chunk.begin(), chunk.end());
+  }
+  std::partial_sort(result.begin(), result.begin() + k, result.end(), Closer);
+  result.resize(k);
+  return result;
+}
+
+SignSketcher::SignSketcher(int num_dimensions, const SignSketchOptions& options)
+  : num_dimensions_{num_dimensions}, options_{options} {
+  if (num_dimensions < 1) {
+    throw EuclideanVectorError("Cannot sketch vectors with " + std::to_string(num_dimensions) +
+                               " dimensions");
+  }
+  if (options.rotate) {
+    rotation_.emplace(num_dimensions, num_dimensions, ProjectionKind::kHadamard, options.seed);
+  }
+}
+
+std::vector<std::uint64_t> SignSketcher::Sketch(const EuclideanVector& v) const {
+  if (v.GetNumDimensions() != num_dimensions_) {
+    throw EuclideanVectorError("Dimensions of LHS(" + std::to_string(num_dimensions_) +
+                               ") and RHS(" + std::to_string(v.GetNumDimensions()) +
+                               ") do not match");
+  }
+  std::vector<std::uint64_t> words(GetNumWords());
+  if (rotation_) {
+    PackSigns(rotation_->Project(v).data(), num_dimensions_, words.data());
+  } else {
+    PackSigns(v.data(), num_dimensions_, words.data());
+  }
+  return words;
+}
+
+SignSketchBatch SignSketcher::Sketch(const EuclideanVectorBatch& batch) const {
+  if (batch.GetNumDimensions() != num_dimensions_) {
+    throw EuclideanVectorError("Dimensions of LHS(" + std::to_string(num_dimensions_) +
+                               ") and RHS(" + std::to_string(batch.GetNumDimensions()) +
+                               ") do not match");
+  }
+  const auto rotated = rotation_ ? rotation_->Project(batch, options_.num_threads)
+                                 : EuclideanVectorBatch();
+  const auto& source = rotation_ ? rotated : batch;
+  SignSketchBatch sketches(batch.GetNumVectors(), num_dimensions_);
+  ev::detail::ParallelFor(0, batch.GetNumVectors(), 256, options_.num_threads,
+                          [&](std::int64_t lo, std::int64_t hi) {
+                            for (auto i = static_cast<int>(lo); i < hi; ++i) {
+                              PackSigns(source.Row(i), num_dimensions_, sketches.Row(i));
+                            }
+                          });
+  return sketches;
+}
@@ -0,0 +1,121 @@
+#ifndef ASSIGNMENTS_EV_SIGN_SKETCH_H_
+#define ASSIGNMENTS_EV_SIGN_SKETCH_H_
+
+#include <cstdint>
+#include <optional>
+#include <vector>
+
+#include "assignments/ev/euclidean_vector.h"
+#include "assignments/ev/euclidean_vector_batch.h"
+#include "assignments/ev/neighbor.h"
+#include "assignments/ev/random_projection.h"
+
+/*
+ * A collection of 1-bit-per-dimension sketches, packed 64 dimensions to a word and stored back to
+ * back, so a sketch takes 1/64 of the memory of the vector it came from.
+ */
+class SignSketchBatch {
+ public:
+  SignSketchBatch() noexcept = default;
+
+  /*
+   * num_sketches zeroed sketches of num_bits bits each.
+   */
+  SignSketchBatch(int num_sketches, int num_bits);
+
+  int GetNumSketches() const noexcept { return num_sketches_; }
+  int GetNumBits() const noexcept { return num_bits_; }
+
+  /*
+   * Number of 64-bit words per sketch, which is also the distance between consecutive sketches.
+   */
+  int GetNumWords() const noexcept { return num_words_; }
+
+  /*
+   * Returns a pointer to the words of the i-th sketch. No bounds checking.
+   */
+  const std::uint64_t* Row(int i) const noexcept {
+    return words_.data() + static_cast<std::int64_t>(i) * num_words_;
+  }
+  std::uint64_t* Row(int i) noexcept {
+    return words_.data() + static_cast<std::int64_t>(i) * num_words_;
+  }
+
+  /*
+   * Hamming distance from query (a sketch of GetNumWords() words) to every sketch, in order.
+   */
+  std::vector<int> HammingDistances(const std::uint64_t* query) const;
+
+  /*
+   * The (at most) k sketches closest to query in Hamming distance, closest first, ties broken by
+   * the lower index. Neighbor::score is the distance. Meant as a first-stage filter: re-rank the
+   * returned indices with exact distances.
+   */
+  std::vector<Neighbor> Nearest(const std::uint64_t* query, int k, int num_threads = 0) const;
+
+ private:
+  std::vector<std::uint64_t> words_;
+  int num_sketches_ = 0;
+  int num_bits_ = 0;
+  int num_words_ = 0;
+};
+
+struct SignSketchOptions {
+  /*
+   * When true, vectors are passed through a randomised Hadamard transform (see ProjectionKind::
+   * kHadamard) before taking signs. This spreads the information of each coordinate over every
+   * bit, so the Hamming distance tracks the angle between vectors whatever the data looks like.
+   * When false the bits are the signs of the raw coordinates, which only says which orthant a
+   * vector lies in: data that is not centred, e.g. all-positive features, gives every vector the
+   * same sketch.
+   */
+  bool rotate = true;
+
+  /*
+   * Seed of the rotation. Sketches are only comparable when made with the same seed.
+   */
+  std::uint64_t seed = 0;
+
+  /*
+   * Maximum number of threads used to sketch a batch. 0 means one per hardware thread.
+   */
+  int num_threads = 0;
+};
+
+/*
+ * Turns vectors of GetNumDimensions() dimensions into sketches of as many bits: bit j is set when
+ * coordinate j (after the rotation, if enabled) is >= 0. With the rotation, the expected Hamming
+ * distance between two sketches is roughly proportional to the angle between the two vectors.
+ */
+class SignSketcher {
+ public:
+  /*
+   * When: num_dimensions < 1
+   * Throw: "Cannot sketch vectors with D dimensions"
+   */
+  explicit SignSketcher(int num_dimensions, const SignSketchOptions& options = {});
+
+  int GetNumDimensions() const noexcept { return num_dimensions_; }
+  int GetNumWords() const noexcept { return (num_dimensions_ + 63) / 64; }
+
+  /*
+   * Returns the GetNumWords() words of v's sketch.
+   * When: v.GetNumDimensions() != GetNumDimensions()
+   * Throw: "Dimensions of LHS(X) and RHS(Y) do not match"
+   */
+  std::vector<std::uint64_t> Sketch(const EuclideanVector& v) const;
+
+  /*
+   * Sketches every vector of the batch, in parallel.
+   * When: batch.GetNumDimensions() != GetNumDimensions()
+   * Throw: "Dimensions of LHS(X) and RHS(Y) do not match"
+   */
+  SignSketchBatch Sketch(const EuclideanVectorBatch& batch) const;
+
+ private:
+  int num_dimensions_;
+  SignSketchOptions options_;
+  std::optional<RandomProjection> rotation_;
+};
+
+#endif  // ASSIGNMENTS_EV_SIGN_SKETCH_H_
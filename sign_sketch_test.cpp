@@ -0,0 +1,120 @@
+/*
+
+  == Explanation and rational of testing ==
+
+  Bit packing is checked on a hand-built vector spanning two words. The batch sketcher must agree
+  with the single-vector one, with and without rotation. Nearest is compared with a brute-force
+  sort of the Hamming distances for several thread counts, on enough sketches to span several
+  scan chunks. Finally the sketch is used as intended, as a prefilter: a slightly perturbed copy
+  of an indexed vector must find that vector among its few nearest sketches.
+
+*/
+
+#include "assignments/ev/sign_sketch.h"
+
+#include <algorithm>
+#include <vector>
+
+#include "assignments/ev/euclidean_vector.h"
+#include "assignments/ev/euclidean_vector_batch.h"
+#include "assignments/ev/neighbor.h"
+#include "assignments/ev/test_vectors.h"
+#include "catch.h"
+
+TEST_CASE("Sign sketches") {
+  SECTION("TEST CASE 1 - One bit per coordinate, 64 to a word") {
+    EuclideanVector v(70, -1.0);
+    v[0] = 2.0;
+    v[5] = 0.0;
+    v[64] = 0.5;
+    v[69] = 3.0;
+    SignSketchOptions raw;
+    raw.rotate = false;
+    const auto sketch = SignSketcher(70, raw).Sketch(v);
+    REQUIRE(sketch.size() == 2);
+    REQUIRE(sketch[0] == ((1ULL << 0) | (1ULL << 5)));
+    REQUIRE(sketch[1] == ((1ULL << 0) | (1ULL << 5)));
+
+    // All-positive vectors share their raw sketch; the default rotation tells them apart.
+    EuclideanVector a(64);
+    EuclideanVector b(64);
+    for (auto j = 0; j < 64; ++j) {
+      a[j] = 1 + j;
+      b[j] = 64 - j;
+    }
+    REQUIRE(SignSketcher(64, raw).Sketch(a) == SignSketcher(64, raw).Sketch(b));
+    REQUIRE(SignSketcher(64).Sketch(a) != SignSketcher(64).Sketch(b));
+  }
+
+  SECTION("TEST CASE 2 - Batch and single-vector sketches agree") {
+    const auto vectors = MakeGaussianVectors(100, 130, 1);
+    const EuclideanVectorBatch batch(vectors);
+    for (auto rotate : {false, true}) {
+      SignSketchOptions options;
+      options.rotate = rotate;
+      options.seed = 3;
+      const SignSketcher sketcher(130, options);
+      const auto sketches = sketcher.Sketch(batch);
+      REQUIRE(sketches.GetNumSketches() == 100);
+      REQUIRE(sketches.GetNumBits() == 130);
+      REQUIRE(sketches.GetNumWords() == 3);
+      for (auto i = 0; i < 100; ++i) {
+        const auto single = sketcher.Sketch(vectors[i]);
+        REQUIRE(std::equal(single.begin(), single.end(), sketches.Row(i)));
+      }
+    }
+  }
+}
+
+TEST_CASE("Hamming search over sign sketches") {
+  const auto vectors = MakeGaussianVectors(9000, 64, 2);
+  SignSketchOptions options;
+  options.rotate = true;
+  const SignSketcher sketcher(64, options);
+  const auto sketches = sketcher.Sketch(EuclideanVectorBatch(vectors));
+
+  SECTION("TEST CASE 3 - Nearest matches a brute-force sort") {
+    const auto query = sketcher.Sketch(vectors[17]);
+    const auto distances = sketches.HammingDistances(query.data());
+    std::vector<Neighbor> expected;
+    for (auto i = 0; i < 9000; ++i) {
+      expected.push_back({i, static_cast<double>(distances[i])});
+    }
+    std::sort(expected.begin(), expected.end(), [](const Neighbor& a, const Neighbor& b) {
+      return a.score != b.score ? a.score < b.score : a.index < b.index;
+    });
+    expected.resize(25);
+    for (auto threads : {1, 2, 5}) {
+      REQUIRE(sketches.Nearest(query.data(), 25, threads) == expected);
+    }
+    REQUIRE(expected[0] == Neighbor{17, 0.0});
+    REQUIRE(sketches.Nearest(query.data(), 0).empty());
+    REQUIRE(sketches.Nearest(query.data(), 10000).size() == 9000);
+  }
+
+  SECTION("TEST CASE 4 - Near-duplicates survive the prefilter") {
+    const auto noise = MakeGaussianVectors(50, 64, 3);
+    for (auto i = 0; i < 50; ++i) {
+      const auto query = vectors[i * 31] + noise[i] * 0.05;
+      const auto candidates = sketches.Nearest(sketcher.Sketch(query).data(), 20);
+      REQUIRE(std::any_of(candidates.begin(), candidates.end(),
+                          [i](const Neighbor& n) { return n.index == i * 31; }));
+    }
+  }
+}
+
+TEST_CASE("Sign sketch errors") {
+  SECTION("TEST CASE 5 - Invalid dimensions") {
+    REQUIRE_THROWS_WITH(SignSketcher(0),
+                        Catch::Contains("Cannot sketch vectors with 0 dimensions"));
+    SignSketchOptions unrotated;
+    unrotated.rotate = false;
+    REQUIRE_THROWS_WITH(SignSketcher(-2, unrotated),
+                        Catch::Contains("Cannot sketch vectors with -2 dimensions"));
+    const SignSketcher sketcher(4);
+    REQUIRE_THROWS_WITH(sketcher.Sketch(EuclideanVector(3)),
+                        Catch::Contains("Dimensions of LHS(4) and RHS(3) do not match"));
+    REQUIRE_THROWS_WITH(sketcher.Sketch(EuclideanVectorBatch(2, 5)),
+                        Catch::Contains("Dimensions of LHS(4) and RHS(5) do not match"));
+  }
+}
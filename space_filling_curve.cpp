@@ -0,0 +1,212 @@
+#include "assignments/ev/space_filling_curve.h"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <numeric>
+#include <string>
+#include <vector>
+
+#include "assignments/ev/euclidean_vector.h"
+#include "assignments/ev/euclidean_vector_batch.h"
+#include "assignments/ev/parallel.h"
+
+namespace {
+
+// At most this many dimensions contribute to a key: one bit each.
+constexpr int kMaxCurveDimensions = 64;
+// Keys are sorted 8 bits at a time.
+constexpr int kRadixBits = 8;
+constexpr int kRadix = 1 << kRadixBits;
+// Fewest keys worth a separate radix sort chunk.
+constexpr int kMinSortChunk = 1 << 14;
+
+// Skilling's transform ("Programming the Hilbert curve", 2004): turns the coordinates of a point
+// into the "transposed" Hilbert index, whose bits interleaved like a Morton key give the position
+// along the curve.
+void AxesToTranspose(std::uint32_t* x, int bits, int n) noexcept {
+  const auto top = std::uint32_t{1} << (bits - 1);
+  for (auto q = top; q > 1; q >>= 1) {
+    const auto p = q - 1;
+    for (auto i = 0; i < n; ++i) {
+      if (x[i] & q) {
+        x[0] ^= p;
+      } else {
+        const auto t = (x[0] ^ x[i]) & p;
+        x[0] ^= t;
+        x[i] ^= t;
+      }
+    }
+  }
+  for (auto i = 1; i < n; ++i) {
+    x[i] ^= x[i - 1];
+  }
+  std::uint32_t t = 0;
+  for (auto q = top; q > 1; q >>= 1) {
+    if (x[n - 1] & q) {
+      t ^= q - 1;
+    }
+  }
+  for (auto i = 0; i < n; ++i) {
+    x[i] ^= t;
+  }
+}
+
+// Most significant bit of every coordinate first, coordinate 0 first within each bit.
+std::uint64_t Interleave(const std::uint32_t* x, int bits, int n) noexcept {
+  std::uint64_t key = 0;
+  for (auto b = bits - 1; b >= 0; --b) {
+    for (auto i = 0; i < n; ++i) {
+      key = (key << 1) | ((x[i] >> b) & 1);
+    }
+  }
+  return key;
+}
+
+// Stable LSD radix sort of the indices 0..n-1 by keys. Each pass counts digits per chunk in
+// parallel, turns the counts into per-chunk output positions, then scatters each chunk in order.
+std::vector<int> RadixSortOrder(std::vector<std::uint64_t> keys, int num_threads) {
+  const auto n = static_cast<int>(keys.size());
+  std::vector<int> order(n);
+  std::iota(order.begin(), order.end(), 0);
+  if (n < 2) {
+    return order;
+  }
+  // Digits on which every key agrees would not move anything.
+  std::uint64_t differ = 0;
+  for (auto key : keys) {
+    differ |= key ^ keys[0];
+  }
+
+  const auto num_chunks = std::clamp((n + kMinSortChunk - 1) / kMinSortChunk, 1,
+                                     ev::detail::ResolveThreadCount(num_threads));
+  const auto chunk_begin = [n, num_chunks](int c) {
+    return static_cast<int>(static_cast<std::int64_t>(n) * c / num_chunks);
+  };
+  std::vector<std::array<int, kRadix>> positions(num_chunks);
+  std::vector<std::uint64_t> next_keys(n);
+  std::vector<int> next_order(n);
+  for (auto shift = 0; shift < 64; shift += kRadixBits) {
+    if (((differ >> shift) & (kRadix - 1)) == 0) {
+      continue;
+    }
+    ev::detail::ParallelFor(0, num_chunks, 1, num_threads, [&](std::int64_t lo, std::int64_t hi) {
+      for (auto c = static_cast<int>(lo); c < hi; ++c) {
+        auto& counts = positions[c];
+        counts.fill(0);
+        for (auto i = chunk_begin(c); i < chunk_begin(c + 1); ++i) {
+          ++counts[(keys[i] >> shift) & (kRadix - 1)];
+        }
+      }
+    });
+    // Digit-major, chunk-minor prefix sum keeps equal digits in chunk (and so input) order.
+    auto offset = 0;
+    for (auto digit = 0; digit < kRadix; ++digit) {
+      for (auto& counts : positions) {
+        const auto count = counts[digit];
+        counts[digit] = offset;
+        offset += count;
+      }
+    }
+    ev::detail::ParallelFor(0, num_chunks, 1, num_threads, [&](std::int64_t lo, std::int64_t hi) {
+      for (auto c = static_cast<int>(lo); c < hi; ++c) {
+        auto& next = positions[c];
+        for (auto i = chunk_begin(c); i < chunk_begin(c + 1); ++i) {
+          const auto position = next[(keys[i] >> shift) & (kRadix - 1)]++;
+          next_keys[position] = keys[i];
+          next_order[position] = order[i];
+        }
+      }
+    });
+    keys.swap(next_keys);
+    order.swap(next_order);
+  }
+  return order;
+}
+
+}  // namespace
+
+std::vector<std::uint64_t> SpaceFillingCurveKeys(const EuclideanVectorBatch& batch,
+                                                 const CurveOrderOptions& options) {
+  const auto n = batch.GetNumVectors();
+  const auto dimensions = std::min(batch.GetNumDimensions(), kMaxCurveDimensions);
+  std::vector<std::uint64_t> keys(n);
+  if (n == 0 || dimensions == 0) {
+    return keys;
+  }
+  const auto bits = std::min(32, 64 / dimensions);
+  const auto max_code = static_cast<double>((std::uint64_t{1} << bits) - 1);
+
+  // Per-dimension range over the batch, eight columns (one cache line of every row) per chunk.
+  // Coordinates are halved before subtracting, so even a range of -DBL_MAX to DBL_MAX stays finite.
+  // bad_row[j] is the first row whose coordinate j is not finite, or n if there is none.
+  std::vector<double> min(dimensions);
+  std::vector<double> scale(dimensions);
+  std::vector<int> bad_row(dimensions, n);
+  ev::detail::ParallelFor(0, dimensions, 8, options.num_threads,
+                          [&](std::int64_t lo, std::int64_t hi) {
+                            for (auto j = lo; j < hi; ++j) {
+                              auto low = batch.Row(0)[j];
+                              auto high = low;
+                              for (auto i = 0; i < n; ++i) {
+                                const auto x = batch.Row(i)[j];
+                                if (!std::isfinite(x)) {
+                                  bad_row[j] = i;
+                                  break;
+                                }
+                                low = std::min(low, x);
+                                high = std::max(high, x);
+                              }
+                              min[j] = 0.5 * low;
+                              scale[j] = high > low ? max_code / (0.5 * high - 0.5 * low) : 0.0;
+                            }
+                          });
+  const auto first_bad = *std::min_element(bad_row.begin(), bad_row.end());
+  if (first_bad < n) {
+    throw EuclideanVectorError("Vector " + std::to_string(first_bad) +
+                               " has a magnitude that is not finite");
+  }
+
+  ev::detail::ParallelFor(0, n, 1024, options.num_threads, [&](std::int64_t lo, std::int64_t hi) {
+    std::uint32_t cell[kMaxCurveDimensions];
+    for (auto i = static_cast<int>(lo); i < hi; ++i) {
+      const auto* row = batch.Row(i);
+      for (auto j = 0; j < dimensions; ++j) {
+        const auto code = std::floor((0.5 * row[j] - min[j]) * scale[j] + 0.5);
+        cell[j] = static_cast<std::uint32_t>(std::clamp(code, 0.0, max_code));
+      }
+      if (options.curve == SpaceFillingCurve::kHilbert) {
+        AxesToTranspose(cell, bits, dimensions);
+      }
+      keys[i] = Interleave(cell, bits, dimensions);
+    }
+  });
+  return keys;
+}
+
+std::vector<int> SpaceFillingCurveOrder(const EuclideanVectorBatch& batch,
+                                        const CurveOrderOptions& options) {
+  return RadixSortOrder(SpaceFillingCurveKeys(batch, options), options.num_threads);
+}
+
+EuclideanVectorBatch ReorderBatch(const EuclideanVectorBatch& batch,
+                                  const std::vector<int>& order,
+                                  int num_threads) {
+  for (auto index : order) {
+    if (index < 0 || index >= batch.GetNumVectors()) {
+      throw EuclideanVectorError("Index " + std::to_string(index) +
+                                 " is not valid for this EuclideanVectorBatch object");
+    }
+  }
+  const auto dimensions = batch.GetNumDimensions();
+  EuclideanVectorBatch reordered(static_cast<int>(order.size()), dimensions);
+  ev::detail::ParallelFor(0, static_cast<std::int64_t>(order.size()), 256, num_threads,
+                          [&](std::int64_t lo, std::int64_t hi) {
+                            for (auto i = static_cast<int>(lo); i < hi; ++i) {
+                              const auto* row = batch.Row(order[i]);
+                              std::copy(row, row + dimensions, reordered.Row(i));
+                            }
+                          });
+  return reordered;
+}
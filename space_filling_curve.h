@@ -0,0 +1,57 @@
+#ifndef ASSIGNMENTS_EV_SPACE_FILLING_CURVE_H_
+#define ASSIGNMENTS_EV_SPACE_FILLING_CURVE_H_
+
+#include <cstdint>
+#include <vector>
+
+#include "assignments/ev/euclidean_vector_batch.h"
+
+enum class SpaceFillingCurve {
+  // Z-order: the bits of the coordinates interleaved. Cheap, but jumps across space at every
+  // power-of-two boundary.
+  kMorton,
+  // Hilbert order: consecutive keys are always neighbouring cells, so nearby points end up
+  // closer together in memory than with kMorton.
+  kHilbert,
+};
+
+struct CurveOrderOptions {
+  SpaceFillingCurve curve = SpaceFillingCurve::kHilbert;
+
+  /*
+   * Maximum number of threads used for the keys and the sort. 0 means one per hardware thread.
+   */
+  int num_threads = 0;
+};
+
+/*
+ * Returns the 64-bit curve key of every vector of batch. Each coordinate is scaled onto the
+ * [min, max] range of its dimension over the batch and quantized to 64 / D bits (at most 32),
+ * where D is the number of dimensions. Only the first 64 dimensions are used, so the curve is
+ * meant for low-dimensional data.
+ * When: vector I is the first with a NaN or infinite magnitude in one of the dimensions used
+ * Throw: "Vector I has a magnitude that is not finite"
+ */
+std::vector<std::uint64_t> SpaceFillingCurveKeys(const EuclideanVectorBatch& batch,
+                                                 const CurveOrderOptions& options = {});
+
+/*
+ * Returns the permutation that sorts batch by curve key: element i is the index in batch of the
+ * vector that belongs at position i. Vectors with equal keys keep their relative order. The keys
+ * are sorted with a parallel least-significant-digit radix sort.
+ * When: vector I is the first with a NaN or infinite magnitude in one of the dimensions used
+ * Throw: "Vector I has a magnitude that is not finite"
+ */
+std::vector<int> SpaceFillingCurveOrder(const EuclideanVectorBatch& batch,
+                                        const CurveOrderOptions& options = {});
+
+/*
+ * Returns a batch whose row i is batch.Row(order[i]), e.g. for order from SpaceFillingCurveOrder.
+ * When: some element X of order is < 0 or >= batch.GetNumVectors()
+ * Throw: "Index X is not valid for this EuclideanVectorBatch object"
+ */
+EuclideanVectorBatch ReorderBatch(const EuclideanVectorBatch& batch,
+                                  const std::vector<int>& order,
+                                  int num_threads = 0);
+
+#endif  // ASSIGNMENTS_EV_SPACE_FILLING_CURVE_H_
@@ -0,0 +1,177 @@
+/*
+
+  == Explanation and rational of testing ==
+
+  On integer grids the curves have exact, checkable shapes: Morton keys are the interleaved bits
+  of the cell coordinates, and walking a Hilbert order always steps to an adjacent cell. The
+  parallel radix sort is compared with std::stable_sort on the keys for many points with plenty
+  of duplicate keys, across thread counts. The point of the reordering, locality, is checked by
+  comparing the average step between consecutive rows with the original random order. Finally
+  ReorderBatch and its error case are tested, as are coordinates at the ends of the double range
+  and the error for ones that are infinite or NaN.
+
+*/
+
+#include "assignments/ev/space_filling_curve.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <numeric>
+#include <random>
+#include <vector>
+
+#include "assignments/ev/euclidean_vector.h"
+#include "assignments/ev/euclidean_vector_batch.h"
+#include "catch.h"
+
+namespace {
+
+// Every cell of a side^dimensions grid, in row-major order.
+EuclideanVectorBatch MakeGrid(int side, int dimensions) {
+  auto n = 1;
+  for (auto j = 0; j < dimensions; ++j) {
+    n *= side;
+  }
+  EuclideanVectorBatch grid(n, dimensions);
+  for (auto i = 0; i < n; ++i) {
+    auto rest = i;
+    for (auto j = dimensions - 1; j >= 0; --j) {
+      grid.Row(i)[j] = rest % side;
+      rest /= side;
+    }
+  }
+  return grid;
+}
+
+double AverageStep(const EuclideanVectorBatch& batch) {
+  double total = 0;
+  for (auto i = 1; i < batch.GetNumVectors(); ++i) {
+    total += (batch.GetVector(i) - batch.GetVector(i - 1)).GetEuclideanNorm();
+  }
+  return total / (batch.GetNumVectors() - 1);
+}
+
+CurveOrderOptions MakeOptions(SpaceFillingCurve curve, int num_threads = 0) {
+  CurveOrderOptions options;
+  options.curve = curve;
+  options.num_threads = num_threads;
+  return options;
+}
+
+}  // namespace
+
+TEST_CASE("Curve keys on grids") {
+  SECTION("TEST CASE 1 - Morton keys interleave the cell coordinates") {
+    // 4 x 4 cells span the full 32 bits per dimension, so scale by 2^32 - 1 over 3 steps.
+    const auto grid = MakeGrid(4, 2);
+    const auto keys = SpaceFillingCurveKeys(grid, MakeOptions(SpaceFillingCurve::kMorton));
+    const auto step = ((std::uint64_t{1} << 32) - 1) / 3;
+    for (auto i = 0; i < 16; ++i) {
+      const auto x = static_cast<std::uint64_t>(grid.Row(i)[0]) * step;
+      const auto y = static_cast<std::uint64_t>(grid.Row(i)[1]) * step;
+      std::uint64_t expected = 0;
+      for (auto b = 31; b >= 0; --b) {
+        expected = (expected << 2) | (((x >> b) & 1) << 1) | ((y >> b) & 1);
+      }
+      REQUIRE(keys[i] == expected);
+    }
+  }
+
+  SECTION("TEST CASE 2 - Hilbert order only steps between adjacent cells") {
+    for (auto dimensions : {2, 3}) {
+      // Grid step k quantizes to a code whose top three bits are k, so the points sit in distinct
+      // cells of the curve's 8-per-side level and the walk follows that level exactly.
+      const auto grid = MakeGrid(8, dimensions);
+      const auto order =
+          SpaceFillingCurveOrder(grid, MakeOptions(SpaceFillingCurve::kHilbert, 2));
+      const auto walk = ReorderBatch(grid, order);
+      for (auto i = 1; i < walk.GetNumVectors(); ++i) {
+        auto manhattan = 0.0;
+        for (auto j = 0; j < dimensions; ++j) {
+          manhattan += std::abs(walk.Row(i)[j] - walk.Row(i - 1)[j]);
+        }
+        REQUIRE(manhattan == 1.0);
+      }
+    }
+  }
+}
+
+TEST_CASE("Curve ordering of point clouds") {
+  std::mt19937_64 rng(9);
+  std::uniform_real_distribution<double> uniform(0.0, 1.0);
+  EuclideanVectorBatch points(100000, 3);
+  for (auto i = 0; i < points.GetNumVectors(); ++i) {
+    for (auto j = 0; j < 3; ++j) {
+      // Rounded so many points share a cell, and so a key.
+      points.Row(i)[j] = std::round(uniform(rng) * 40) / 40;
+    }
+  }
+
+  SECTION("TEST CASE 3 - The radix sort is a stable sort by key") {
+    for (auto curve : {SpaceFillingCurve::kMorton, SpaceFillingCurve::kHilbert}) {
+      const auto keys = SpaceFillingCurveKeys(points, MakeOptions(curve));
+      std::vector<int> expected(keys.size());
+      std::iota(expected.begin(), expected.end(), 0);
+      std::stable_sort(expected.begin(), expected.end(),
+                       [&keys](int a, int b) { return keys[a] < keys[b]; });
+      for (auto threads : {1, 3, 0}) {
+        REQUIRE(SpaceFillingCurveOrder(points, MakeOptions(curve, threads)) == expected);
+      }
+    }
+  }
+
+  SECTION("TEST CASE 4 - Reordering brings neighbours together") {
+    const auto before = AverageStep(points);
+    const auto morton =
+        AverageStep(ReorderBatch(points, SpaceFillingCurveOrder(
+                                             points, MakeOptions(SpaceFillingCurve::kMorton))));
+    const auto hilbert =
+        AverageStep(ReorderBatch(points, SpaceFillingCurveOrder(
+                                             points, MakeOptions(SpaceFillingCurve::kHilbert))));
+    REQUIRE(morton < before / 10);
+    REQUIRE(hilbert < morton);
+  }
+}
+
+TEST_CASE("Reordering batches") {
+  SECTION("TEST CASE 5 - ReorderBatch gathers rows and checks indices") {
+    const auto grid = MakeGrid(3, 2);
+    const auto reordered = ReorderBatch(grid, {8, 0, 8});
+    REQUIRE(reordered.GetNumVectors() == 3);
+    REQUIRE(reordered.GetVector(0) == grid.GetVector(8));
+    REQUIRE(reordered.GetVector(1) == grid.GetVector(0));
+    REQUIRE(reordered.GetVector(2) == grid.GetVector(8));
+    REQUIRE_THROWS_WITH(
+        ReorderBatch(grid, {0, 9}),
+        Catch::Contains("Index 9 is not valid for this EuclideanVectorBatch object"));
+    REQUIRE(SpaceFillingCurveOrder(EuclideanVectorBatch(0, 2)).empty());
+    REQUIRE(SpaceFillingCurveOrder(EuclideanVectorBatch(3, 2)) == std::vector<int>{0, 1, 2});
+  }
+}
+
+TEST_CASE("Curve keys of extreme coordinates") {
+  SECTION("TEST CASE 6 - Finite extremes are keyed and non-finite magnitudes are rejected") {
+    const auto max = std::numeric_limits<double>::max();
+    EuclideanVectorBatch extremes(3, 1);
+    extremes.Row(0)[0] = -max;
+    extremes.Row(1)[0] = 0;
+    extremes.Row(2)[0] = max;
+    const auto keys = SpaceFillingCurveKeys(extremes, MakeOptions(SpaceFillingCurve::kMorton));
+    REQUIRE(keys[0] == 0);
+    REQUIRE(keys[1] == std::uint64_t{1} << 31);
+    REQUIRE(keys[2] == (std::uint64_t{1} << 32) - 1);
+
+    for (auto curve : {SpaceFillingCurve::kMorton, SpaceFillingCurve::kHilbert}) {
+      auto points = MakeGrid(4, 2);
+      points.Row(9)[1] = std::numeric_limits<double>::quiet_NaN();
+      points.Row(5)[0] = std::numeric_limits<double>::infinity();
+      REQUIRE_THROWS_WITH(SpaceFillingCurveKeys(points, MakeOptions(curve)),
+                          Catch::Contains("Vector 5 has a magnitude that is not finite"));
+      points.Row(5)[0] = 0;
+      REQUIRE_THROWS_WITH(SpaceFillingCurveOrder(points, MakeOptions(curve, 2)),
+                          Catch::Contains("Vector 9 has a magnitude that is not finite"));
+    }
+  }
+}
@@ -0,0 +1,28 @@
+#ifndef ASSIGNMENTS_EV_TEST_VECTORS_H_
+#define ASSIGNMENTS_EV_TEST_VECTORS_H_
+
+#include <cstdint>
+#include <random>
+#include <vector>
+
+#include "assignments/ev/euclidean_vector.h"
+
+/*
+ * Test fixture: n vectors of the given number of dimensions whose magnitudes are drawn from a
+ * standard normal distribution. The same seed always gives the same vectors.
+ */
+inline std::vector<EuclideanVector> MakeGaussianVectors(int n, int dimensions, std::uint64_t seed) {
+  std::mt19937_64 rng(seed);
+  std::normal_distribution<double> normal(0.0, 1.0);
+  std::vector<EuclideanVector> vectors;
+  for (auto i = 0; i < n; ++i) {
+    EuclideanVector v(dimensions);
+    for (auto j = 0; j < dimensions; ++j) {
+      v[j] = normal(rng);
+    }
+    vectors.push_back(v);
+  }
+  return vectors;
+}
+
+#endif  // ASSIGNMENTS_EV_TEST_VECTORS_H_
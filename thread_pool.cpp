@@ -0,0 +1,158 @@
+#include "assignments/ev/thread_pool.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <utility>
+
+#if defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+namespace {
+
+// Identifies the pool (and the deque within it) owned by the current thread, if any.
+thread_local const WorkStealingThreadPool* current_pool = nullptr;
+thread_local std::size_t current_queue = 0;
+
+void PinCurrentThread(std::size_t index) {
+#if defined(__linux__)
+  const auto cpus = std::max(1U, std::thread::hardware_concurrency());
+  cpu_set_t set;
+  CPU_ZERO(&set);
+  CPU_SET(index % cpus, &set);
+  // Pinning is a hint; a worker that cannot be pinned still runs.
+  pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+#else
+  static_cast<void>(index);
+#endif
+}
+
+std::mutex default_executor_mutex;
+std::shared_ptr<Executor> default_executor;
+
+}  // namespace
+
+WorkStealingThreadPool::WorkStealingThreadPool(const ThreadPoolOptions& options) {
+  const auto num_threads = options.num_threads > 0
+                               ? static_cast<std::size_t>(options.num_threads)
+                               : std::max(1U, std::thread::hardware_concurrency());
+  queues_.reserve(num_threads);
+  for (auto i = std::size_t{0}; i < num_threads; ++i) {
+    queues_.push_back(std::make_unique<WorkerQueue>());
+  }
+  workers_.reserve(num_threads);
+  for (auto i = std::size_t{0}; i < num_threads; ++i) {
+    workers_.emplace_back([this, i, pin = options.pin_threads]() {
+      if (pin) {
+        PinCurrentThread(i);
+      }
+      WorkerLoop(i);
+    });
+  }
+}
+
+WorkStealingThreadPool::~WorkStealingThreadPool() {
+  {
+    std::lock_guard<std::mutex> lock(sleep_mutex_);
+    stopping_ = true;
+  }
+  wake_.notify_all();
+  for (auto& worker : workers_) {
+    worker.join();
+  }
+}
+
+int WorkStealingThreadPool::GetConcurrency() const noexcept {
+  return static_cast<int>(workers_.size());
+}
+
+void WorkStealingThreadPool::Submit(std::function<void()> task) {
+  // Workers keep their own tasks local; everyone else spreads them over the deques.
+  const auto queue = current_pool == this ? current_queue : next_queue_++ % queues_.size();
+  {
+    std::lock_guard<std::mutex> lock(queues_[queue]->mutex);
+    queues_[queue]->tasks.push_back(std::move(task));
+  }
+  {
+    std::lock_guard<std::mutex> lock(sleep_mutex_);
+    ++pending_;
+  }
+  wake_.notify_one();
+}
+
+bool WorkStealingThreadPool::TryRunPendingTask() {
+  std::function<void()> task;
+  if (!PopOrSteal(current_pool == this ? current_queue : queues_.size(), task)) {
+    return false;
+  }
+  task();
+  return true;
+}
+
+bool WorkStealingThreadPool::PopOrSteal(std::size_t home, std::function<void()>& task) {
+  const auto num_queues = queues_.size();
+  if (home < num_queues) {
+    auto& own = *queues_[home];
+    std::lock_guard<std::mutex> lock(own.mutex);
+    if (!own.tasks.empty()) {
+      task = std::move(own.tasks.back());
+      own.tasks.pop_back();
+      --pending_;
+      return true;
+    }
+  }
+  const auto start = home < num_queues ? home + 1 : next_queue_.load();
+  for (auto i = std::size_t{0}; i < num_queues; ++i) {
+    const auto victim = (start + i) % num_queues;
+    if (victim == home) {
+      continue;
+    }
+    auto& other = *queues_[victim];
+    std::lock_guard<std::mutex> lock(other.mutex);
+    if (!other.tasks.empty()) {
+      task = std::move(other.tasks.front());
+      other.tasks.pop_front();
+      --pending_;
+      return true;
+    }
+  }
+  return false;
+}
+
+void WorkStealingThreadPool::WorkerLoop(std::size_t index) {
+  current_pool = this;
+  current_queue = index;
+  std::function<void()> task;
+  for (;;) {
+    if (PopOrSteal(index, task)) {
+      task();
+      task = nullptr;
+      continue;
+    }
+    std::unique_lock<std::mutex> lock(sleep_mutex_);
+    // pending_ can briefly run ahead of the deques while a Submit is between its two steps; the
+    // worker then simply looks again.
+    wake_.wait(lock, [this]() { return stopping_ || pending_ > 0; });
+    if (stopping_ && pending_ == 0) {
+      return;
+    }
+  }
+}
+
+std::shared_ptr<Executor> GetDefaultExecutor() {
+  std::lock_guard<std::mutex> lock(default_executor_mutex);
+  if (!default_executor) {
+    default_executor = std::make_shared<WorkStealingThreadPool>();
+  }
+  return default_executor;
+}
+
+void SetDefaultExecutor(std::shared_ptr<Executor> executor) {
+  std::lock_guard<std::mutex> lock(default_executor_mutex);
+  default_executor = std::move(executor);
+}
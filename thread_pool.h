@@ -0,0 +1,103 @@
+#ifndef ASSIGNMENTS_EV_THREAD_POOL_H_
+#define ASSIGNMENTS_EV_THREAD_POOL_H_
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/*
+ * Interface to whatever runs the library's background work. Every parallel operation (batch
+ * arithmetic, reductions, clustering, index builds) hands its tasks to an Executor instead of
+ * starting threads of its own, so several subsystems running in one process share one set of
+ * workers. Implement this to run the library on an executor owned by the application.
+ */
+class Executor {
+ public:
+  virtual ~Executor() = default;
+
+  /*
+   * Number of tasks this executor can run at the same time, not counting the submitting thread.
+   * An executor that returns 0 makes every parallel operation run on the calling thread.
+   */
+  virtual int GetConcurrency() const noexcept = 0;
+
+  /*
+   * Queues task to run at some later point on one of the executor's threads. Tasks submitted by
+   * the library never throw and may be run in any order.
+   */
+  virtual void Submit(std::function<void()> task) = 0;
+
+  /*
+   * Runs one queued task on the calling thread if there is one, returning whether a task ran.
+   * Threads waiting on work they submitted call this to help instead of blocking, which is what
+   * keeps nested parallel loops from deadlocking. The default never helps, which is still safe:
+   * the library only relies on it for throughput.
+   */
+  virtual bool TryRunPendingTask() { return false; }
+};
+
+struct ThreadPoolOptions {
+  // Number of worker threads; values <= 0 mean one per hardware thread.
+  int num_threads = 0;
+  // Binds worker i to CPU i (modulo the number of CPUs) where the platform supports it.
+  bool pin_threads = false;
+};
+
+/*
+ * Executor with one task deque per worker. A worker pushes and pops tasks at the back of its own
+ * deque, and when that is empty steals from the front of the others, so recently submitted
+ * (cache-warm) work stays local and idle workers take the oldest, usually largest, pieces.
+ * Tasks submitted from outside the pool are spread round-robin over the deques.
+ *
+ * The destructor runs every task still queued before joining the workers.
+ */
+class WorkStealingThreadPool final : public Executor {
+ public:
+  explicit WorkStealingThreadPool(const ThreadPoolOptions& options = ThreadPoolOptions{});
+  WorkStealingThreadPool(const WorkStealingThreadPool&) = delete;
+  WorkStealingThreadPool& operator=(const WorkStealingThreadPool&) = delete;
+  ~WorkStealingThreadPool() override;
+
+  int GetConcurrency() const noexcept override;
+  void Submit(std::function<void()> task) override;
+  bool TryRunPendingTask() override;
+
+ private:
+  struct WorkerQueue {
+    std::mutex mutex;
+    std::deque<std::function<void()>> tasks;
+  };
+
+  bool PopOrSteal(std::size_t home, std::function<void()>& task);
+  void WorkerLoop(std::size_t index);
+
+  std::vector<std::unique_ptr<WorkerQueue>> queues_;
+  std::vector<std::thread> workers_;
+  std::atomic<std::size_t> next_queue_{0};
+  std::atomic<std::int64_t> pending_{0};
+  std::mutex sleep_mutex_;
+  std::condition_variable wake_;
+  bool stopping_ = false;
+};
+
+/*
+ * Returns the executor used by every parallel operation in the library. Until one is installed
+ * with SetDefaultExecutor this is a WorkStealingThreadPool with default options, created on first
+ * use. The returned pointer keeps the executor alive even if it is replaced concurrently.
+ */
+std::shared_ptr<Executor> GetDefaultExecutor();
+
+/*
+ * Installs executor as the library-wide default. Passing nullptr restores the library's own pool.
+ * Operations already running finish on the executor they started with.
+ */
+void SetDefaultExecutor(std::shared_ptr<Executor> executor);
+
+#endif  // ASSIGNMENTS_EV_THREAD_POOL_H_
@@ -0,0 +1,184 @@
+/*
+
+  == Explanation and rational of testing ==
+
+  The pool is tested directly (every submitted task runs, also when workers are pinned and when
+  the pool is destroyed with work still queued) and through ParallelFor, which is how the rest of
+  the library uses it. For ParallelFor we check every index is visited exactly once, exceptions
+  reach the caller, and nested loops finish even when the pool has fewer workers than the outer
+  loop has chunks, which would deadlock if waiting threads did not help. Executor injection is
+  tested with a wrapper that counts the tasks it is given.
+
+*/
+
+#include "assignments/ev/thread_pool.h"
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#include "assignments/ev/parallel.h"
+#include "catch.h"
+
+namespace {
+
+// Forwards to a pool and counts what is submitted to it.
+class CountingExecutor : public Executor {
+ public:
+  explicit CountingExecutor(int num_threads) : pool_(ThreadPoolOptions{num_threads, false}) {}
+
+  int GetConcurrency() const noexcept override { return pool_.GetConcurrency(); }
+  void Submit(std::function<void()> task) override {
+    ++submitted;
+    pool_.Submit(std::move(task));
+  }
+  bool TryRunPendingTask() override { return pool_.TryRunPendingTask(); }
+
+  std::atomic<int> submitted{0};
+
+ private:
+  WorkStealingThreadPool pool_;
+};
+
+// Runs nothing in the background: every loop runs on the calling thread.
+class InlineExecutor : public Executor {
+ public:
+  int GetConcurrency() const noexcept override { return 0; }
+  void Submit(std::function<void()> task) override { task(); }
+};
+
+}  // namespace
+
+TEST_CASE("Work-stealing pool runs every task") {
+  SECTION("TEST CASE 1 - Tasks submitted from outside the pool") {
+    std::atomic<int> ran{0};
+    {
+      WorkStealingThreadPool pool(ThreadPoolOptions{3, false});
+      REQUIRE(pool.GetConcurrency() == 3);
+      for (auto i = 0; i < 1000; ++i) {
+        pool.Submit([&ran]() { ++ran; });
+      }
+    }
+    // The destructor drains the queues before joining.
+    REQUIRE(ran == 1000);
+  }
+
+  SECTION("TEST CASE 2 - Tasks that submit more tasks") {
+    std::atomic<int> ran{0};
+    {
+      WorkStealingThreadPool pool(ThreadPoolOptions{2, false});
+      for (auto i = 0; i < 10; ++i) {
+        pool.Submit([&pool, &ran]() {
+          for (auto j = 0; j < 10; ++j) {
+            pool.Submit([&ran]() { ++ran; });
+          }
+        });
+      }
+      while (ran < 100) {
+        pool.TryRunPendingTask();
+      }
+    }
+    REQUIRE(ran == 100);
+  }
+
+  SECTION("TEST CASE 3 - Pinned workers") {
+    std::atomic<int> ran{0};
+    {
+      WorkStealingThreadPool pool(ThreadPoolOptions{2, true});
+      for (auto i = 0; i < 100; ++i) {
+        pool.Submit([&ran]() { ++ran; });
+      }
+    }
+    REQUIRE(ran == 100);
+  }
+
+  SECTION("TEST CASE 4 - A caller can run queued tasks itself") {
+    WorkStealingThreadPool pool(ThreadPoolOptions{1, false});
+    auto ran = 0;
+    // Keep the only worker busy so the second task stays queued.
+    std::atomic<bool> release{false};
+    std::atomic<bool> started{false};
+    pool.Submit([&]() {
+      started = true;
+      while (!release) {
+      }
+    });
+    while (!started) {
+    }
+    pool.Submit([&ran]() { ++ran; });
+    REQUIRE(pool.TryRunPendingTask());
+    REQUIRE(ran == 1);
+    REQUIRE_FALSE(pool.TryRunPendingTask());
+    release = true;
+  }
+}
+
+TEST_CASE("ParallelFor on an executor") {
+  SECTION("TEST CASE 5 - Every index is visited exactly once") {
+    WorkStealingThreadPool pool(ThreadPoolOptions{4, false});
+    std::vector<std::atomic<int>> visits(10007);
+    ev::detail::ParallelFor(pool, 0, 10007, 13, 0, [&visits](std::int64_t lo, std::int64_t hi) {
+      for (auto i = lo; i < hi; ++i) {
+        ++visits[i];
+      }
+    });
+    for (const auto& v : visits) {
+      REQUIRE(v == 1);
+    }
+  }
+
+  SECTION("TEST CASE 6 - Exceptions reach the caller") {
+    WorkStealingThreadPool pool(ThreadPoolOptions{4, false});
+    auto run = [&pool]() {
+      ev::detail::ParallelFor(pool, 0, 1000, 1, 0, [](std::int64_t lo, std::int64_t) {
+        if (lo == 500) {
+          throw std::runtime_error("chunk 500");
+        }
+      });
+    };
+    REQUIRE_THROWS_WITH(run(), Catch::Contains("chunk 500"));
+  }
+
+  SECTION("TEST CASE 7 - Nested loops on a small pool finish") {
+    WorkStealingThreadPool pool(ThreadPoolOptions{2, false});
+    std::atomic<std::int64_t> total{0};
+    ev::detail::ParallelFor(pool, 0, 16, 1, 0, [&](std::int64_t, std::int64_t) {
+      ev::detail::ParallelFor(pool, 0, 100, 7, 0, [&](std::int64_t lo, std::int64_t hi) {
+        total += hi - lo;
+      });
+    });
+    REQUIRE(total == 1600);
+  }
+
+  SECTION("TEST CASE 8 - An executor without workers runs the loop inline") {
+    InlineExecutor executor;
+    auto sum = std::int64_t{0};
+    ev::detail::ParallelFor(executor, 0, 100, 10, 8, [&sum](std::int64_t lo, std::int64_t hi) {
+      for (auto i = lo; i < hi; ++i) {
+        sum += i;
+      }
+    });
+    REQUIRE(sum == 4950);
+  }
+}
+
+TEST_CASE("Default executor injection") {
+  SECTION("TEST CASE 9 - Library loops use the installed executor") {
+    auto executor = std::make_shared<CountingExecutor>(2);
+    SetDefaultExecutor(executor);
+    REQUIRE(GetDefaultExecutor() == executor);
+    std::atomic<int> chunks{0};
+    ev::detail::ParallelFor(0, 64, 1, 3, [&chunks](std::int64_t, std::int64_t) { ++chunks; });
+    REQUIRE(chunks == 64);
+    // Three threads requested: the caller plus two borrowed from the executor.
+    REQUIRE(executor->submitted == 2);
+
+    SetDefaultExecutor(nullptr);
+    REQUIRE(GetDefaultExecutor() != executor);
+    REQUIRE(GetDefaultExecutor() != nullptr);
+  }
+}
@@ -0,0 +1,353 @@
+#include "assignments/ev/vector_pool.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <new>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "assignments/ev/aligned_buffer.h"
+
+namespace {
+
+// Buffers a thread keeps per size class; when full, half of them move to the shared lists, and
+// an empty class is refilled with half as many. Only the first few size classes a thread sees
+// get a cache, as the pool is meant for a handful of recurring dimensions.
+constexpr std::size_t kThreadCacheBuffers = 32;
+constexpr std::size_t kThreadCacheClasses = 8;
+
+std::atomic<bool> pool_enabled{false};
+std::atomic<std::size_t> max_cached_bytes{VectorPoolOptions{}.max_cached_bytes};
+std::atomic<int> max_pooled_dimensions{VectorPoolOptions{}.max_pooled_dimensions};
+
+std::atomic<std::int64_t> hits{0};
+std::atomic<std::int64_t> misses{0};
+std::atomic<std::int64_t> recycled{0};
+std::atomic<std::int64_t> released{0};
+std::atomic<std::int64_t> cached_bytes{0};
+
+std::size_t Bytes(int capacity) noexcept {
+  return static_cast<std::size_t>(capacity) * sizeof(double);
+}
+
+bool IsPooled(int capacity) noexcept {
+  const auto limit = max_pooled_dimensions.load(std::memory_order_relaxed);
+  return capacity <= ev::detail::PadToCacheLine(limit);
+}
+
+double* HeapAllocate(int capacity) {
+  return static_cast<double*>(
+      ::operator new[](Bytes(capacity), std::align_val_t{ev::detail::kCacheLineSize}));
+}
+
+void HeapFree(double* p) noexcept {
+  ::operator delete[](p, std::align_val_t{ev::detail::kCacheLineSize});
+}
+
+// Frees a buffer that was counted in cached_bytes.
+void HeapFreeCached(double* p, int capacity) noexcept {
+  cached_bytes.fetch_sub(static_cast<std::int64_t>(Bytes(capacity)), std::memory_order_relaxed);
+  HeapFree(p);
+}
+
+// Counts bytes as cached if they fit under max_cached_bytes, returning whether they did.
+bool ReserveCached(std::size_t bytes) noexcept {
+  auto current = cached_bytes.load(std::memory_order_relaxed);
+  do {
+    const auto limit = max_cached_bytes.load(std::memory_order_relaxed);
+    if (static_cast<std::size_t>(current) + bytes > limit) {
+      return false;
+    }
+  } while (!cached_bytes.compare_exchange_weak(current, current + static_cast<std::int64_t>(bytes),
+                                               std::memory_order_relaxed));
+  return true;
+}
+
+// Free lists shared by every thread, one per size class.
+class SharedLists {
+ public:
+  // Moves up to count buffers of the size class into out, returning how many it moved.
+  std::size_t Take(int capacity, double** out, std::size_t count) noexcept {
+    std::lock_guard<std::mutex> lock(mutex_);
+    const auto it = lists_.find(capacity);
+    if (it == lists_.end()) {
+      return 0;
+    }
+    auto& list = it->second;
+    const auto taken = std::min(count, list.size());
+    std::copy(list.end() - static_cast<std::ptrdiff_t>(taken), list.end(), out);
+    list.resize(list.size() - taken);
+    return taken;
+  }
+
+  // Adds the buffers to the size class's list, returning false if the list could not grow.
+  bool Put(int capacity, double* const* buffers, std::size_t count) noexcept {
+    try {
+      std::lock_guard<std::mutex> lock(mutex_);
+      auto& list = lists_[capacity];
+      list.insert(list.end(), buffers, buffers + count);
+      return true;
+    } catch (const std::bad_alloc&) {
+      return false;
+    }
+  }
+
+  void Trim() noexcept {
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (auto& [capacity, list] : lists_) {
+      for (auto* p : list) {
+        HeapFreeCached(p, capacity);
+      }
+    }
+    lists_.clear();
+  }
+
+ private:
+  std::mutex mutex_;
+  std::unordered_map<int, std::vector<double*>> lists_;
+};
+
+SharedLists& Shared() noexcept {
+  // Never destroyed, so vectors destroyed during static destruction can still free into it.
+  static auto* const lists = new SharedLists;
+  return *lists;
+}
+
+// Hands buffers to the shared lists, or to the heap if they cannot take them.
+void PutShared(int capacity, double* const* buffers, std::size_t count) noexcept {
+  if (!Shared().Put(capacity, buffers, count)) {
+    for (std::size_t i = 0; i < count; ++i) {
+      HeapFreeCached(buffers[i], capacity);
+    }
+  }
+}
+
+class ThreadCache;
+
+// The calling thread's cache, once created; set back to nullptr when the thread exits.
+thread_local ThreadCache* local_cache = nullptr;
+thread_local bool local_cache_destroyed = false;
+
+// Per-thread free lists, used without locking.
+class ThreadCache {
+ public:
+  ThreadCache() noexcept = default;
+  ThreadCache(const ThreadCache&) = delete;
+  ThreadCache& operator=(const ThreadCache&) = delete;
+
+  // Buffers outlive the thread on the shared lists, where other threads can use them.
+  ~ThreadCache() {
+    for (auto& bin : bins_) {
+      if (pool_enabled.load(std::memory_order_relaxed)) {
+        PutShared(bin.capacity, bin.buffers.data(), bin.buffers.size());
+      } else {
+        for (auto* p : bin.buffers) {
+          HeapFreeCached(p, bin.capacity);
+        }
+      }
+    }
+    local_cache = nullptr;
+    local_cache_destroyed = true;
+  }
+
+  // Returns a cached buffer of the size class, refilling from the shared lists when out of
+  // them, or nullptr.
+  double* Take(int capacity) noexcept {
+    auto* bin = FindBin(capacity);
+    if (bin == nullptr) {
+      double* p = nullptr;
+      return Shared().Take(capacity, &p, 1) == 1 ? p : nullptr;
+    }
+    if (bin->buffers.empty()) {
+      double* refill[kThreadCacheBuffers / 2];
+      const auto count = Shared().Take(capacity, refill, kThreadCacheBuffers / 2);
+      bin->buffers.insert(bin->buffers.end(), refill, refill + count);
+      if (count == 0) {
+        return nullptr;
+      }
+    }
+    auto* p = bin->buffers.back();
+    bin->buffers.pop_back();
+    return p;
+  }
+
+  // Keeps a buffer already counted in cached_bytes, moving half the size class to the shared
+  // lists when it is full.
+  void Put(double* p, int capacity) noexcept {
+    auto* bin = FindBin(capacity);
+    if (bin == nullptr) {
+      PutShared(capacity, &p, 1);
+      return;
+    }
+    if (bin->buffers.size() == kThreadCacheBuffers) {
+      const auto half = kThreadCacheBuffers / 2;
+      PutShared(capacity, bin->buffers.data() + half, half);
+      bin->buffers.resize(half);
+    }
+    bin->buffers.push_back(p);
+  }
+
+  // Gives every cached buffer back to the heap.
+  void Drain() noexcept {
+    for (auto& bin : bins_) {
+      for (auto* p : bin.buffers) {
+        HeapFreeCached(p, bin.capacity);
+      }
+      bin.buffers.clear();
+    }
+  }
+
+  bool IsEmpty() const noexcept {
+    return std::all_of(bins_.begin(), bins_.end(),
+                       [](const Bin& bin) { return bin.buffers.empty(); });
+  }
+
+ private:
+  struct Bin {
+    int capacity;
+    // Reserved to kThreadCacheBuffers up front, so Take and Put never allocate.
+    std::vector<double*> buffers;
+  };
+
+  // Returns the size class's bin, adding one if there is room, or nullptr.
+  Bin* FindBin(int capacity) noexcept {
+    for (auto& bin : bins_) {
+      if (bin.capacity == capacity) {
+        return &bin;
+      }
+    }
+    if (bins_.size() == kThreadCacheClasses) {
+      return nullptr;
+    }
+    try {
+      bins_.reserve(kThreadCacheClasses);
+      Bin bin{capacity, {}};
+      bin.buffers.reserve(kThreadCacheBuffers);
+      bins_.push_back(std::move(bin));
+      return &bins_.back();
+    } catch (const std::bad_alloc&) {
+      return nullptr;
+    }
+  }
+
+  std::vector<Bin> bins_;
+};
+
+ThreadCache* LocalCache() noexcept {
+  if (local_cache == nullptr && !local_cache_destroyed) {
+    static thread_local ThreadCache cache;
+    local_cache = &cache;
+  }
+  return local_cache;
+}
+
+// With the pool disabled, a thread hands back what it cached while it was enabled.
+void DrainIfDisabled() noexcept {
+  if (local_cache != nullptr && !local_cache->IsEmpty()) {
+    local_cache->Drain();
+  }
+}
+
+}  // namespace
+
+void SetVectorPoolOptions(const VectorPoolOptions& options) {
+  max_cached_bytes.store(options.max_cached_bytes, std::memory_order_relaxed);
+  max_pooled_dimensions.store(std::max(options.max_pooled_dimensions, 0),
+                              std::memory_order_relaxed);
+  pool_enabled.store(options.enabled, std::memory_order_relaxed);
+  if (!options.enabled ||
+      static_cast<std::size_t>(cached_bytes.load(std::memory_order_relaxed)) >
+          options.max_cached_bytes) {
+    TrimVectorPool();
+  }
+}
+
+VectorPoolOptions GetVectorPoolOptions() {
+  VectorPoolOptions options;
+  options.enabled = pool_enabled.load(std::memory_order_relaxed);
+  options.max_cached_bytes = max_cached_bytes.load(std::memory_order_relaxed);
+  options.max_pooled_dimensions = max_pooled_dimensions.load(std::memory_order_relaxed);
+  return options;
+}
+
+VectorPoolStatistics GetVectorPoolStatistics() noexcept {
+  VectorPoolStatistics statistics;
+  statistics.hits = hits.load(std::memory_order_relaxed);
+  statistics.misses = misses.load(std::memory_order_relaxed);
+  statistics.recycled = recycled.load(std::memory_order_relaxed);
+  statistics.released = released.load(std::memory_order_relaxed);
+  statistics.cached_bytes = cached_bytes.load(std::memory_order_relaxed);
+  return statistics;
+}
+
+void ResetVectorPoolStatistics() noexcept {
+  hits.store(0, std::memory_order_relaxed);
+  misses.store(0, std::memory_order_relaxed);
+  recycled.store(0, std::memory_order_relaxed);
+  released.store(0, std::memory_order_relaxed);
+}
+
+void TrimVectorPool() {
+  Shared().Trim();
+  if (local_cache != nullptr) {
+    local_cache->Drain();
+  }
+}
+
+namespace ev::detail {
+
+VectorBuffer AllocateVectorBuffer(int count) {
+  if (count <= 0) {
+    return VectorBuffer(nullptr, VectorBufferDeleter{0});
+  }
+  const auto capacity = CheckedPadToCacheLine(count);
+  if (pool_enabled.load(std::memory_order_relaxed)) {
+    if (IsPooled(capacity)) {
+      auto* cache = LocalCache();
+      double* p = nullptr;
+      if (cache != nullptr) {
+        p = cache->Take(capacity);
+      } else if (Shared().Take(capacity, &p, 1) == 0) {
+        p = nullptr;
+      }
+      if (p != nullptr) {
+        cached_bytes.fetch_sub(static_cast<std::int64_t>(Bytes(capacity)),
+                               std::memory_order_relaxed);
+        hits.fetch_add(1, std::memory_order_relaxed);
+        return VectorBuffer(p, VectorBufferDeleter{capacity});
+      }
+    }
+    misses.fetch_add(1, std::memory_order_relaxed);
+  } else {
+    DrainIfDisabled();
+  }
+  return VectorBuffer(HeapAllocate(capacity), VectorBufferDeleter{capacity});
+}
+
+void FreeVectorBuffer(double* p, int capacity) noexcept {
+  if (p == nullptr) {
+    return;
+  }
+  if (pool_enabled.load(std::memory_order_relaxed)) {
+    if (IsPooled(capacity) && ReserveCached(Bytes(capacity))) {
+      auto* cache = LocalCache();
+      if (cache != nullptr) {
+        cache->Put(p, capacity);
+      } else {
+        PutShared(capacity, &p, 1);
+      }
+      recycled.fetch_add(1, std::memory_order_relaxed);
+      return;
+    }
+    released.fetch_add(1, std::memory_order_relaxed);
+  } else {
+    DrainIfDisabled();
+  }
+  HeapFree(p);
+}
+
+}  // namespace ev::detail
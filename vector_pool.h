@@ -0,0 +1,107 @@
+#ifndef ASSIGNMENTS_EV_VECTOR_POOL_H_
+#define ASSIGNMENTS_EV_VECTOR_POOL_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+/*
+ * Recycling of the buffers behind EuclideanVector. Buffers are cache-line aligned and sized in
+ * whole cache lines (a size class); with the pool enabled a destroyed vector's buffer is kept on a
+ * free list of its size class and handed to the next vector of that class, so a workload that
+ * keeps creating vectors of a few dimensions stops calling malloc and free once warmed up.
+ *
+ * Each thread caches a few buffers per size class without locking, and overflows into (or refills
+ * from) free lists shared by all threads. A buffer freed on another thread than it was allocated
+ * on is fine.
+ */
+struct VectorPoolOptions {
+  /*
+   * Off by default: every buffer then comes from, and goes back to, the heap.
+   */
+  bool enabled = false;
+
+  /*
+   * Most bytes kept on free lists, over all threads. A buffer freed while the lists are full goes
+   * back to the heap.
+   */
+  std::size_t max_cached_bytes = std::size_t{64} << 20;
+
+  /*
+   * Buffers of vectors with more dimensions than this always come from and go back to the heap.
+   */
+  int max_pooled_dimensions = 1 << 16;
+};
+
+struct VectorPoolStatistics {
+  // Buffers taken from a free list.
+  std::int64_t hits = 0;
+  // Buffers allocated from the heap, with the pool enabled.
+  std::int64_t misses = 0;
+  // Buffers put on a free list.
+  std::int64_t recycled = 0;
+  // Buffers given back to the heap with the pool enabled, because they were too large or the
+  // free lists were full.
+  std::int64_t released = 0;
+  // Bytes on free lists right now.
+  std::int64_t cached_bytes = 0;
+
+  /*
+   * hits / (hits + misses), or 0 before any allocation.
+   */
+  double GetHitRate() const noexcept {
+    const auto total = hits + misses;
+    return total == 0 ? 0.0 : static_cast<double>(hits) / static_cast<double>(total);
+  }
+};
+
+/*
+ * Replaces the pool's options. Disabling the pool, or lowering max_cached_bytes, frees what no
+ * longer fits from the shared free lists and the calling thread's cache; other threads give back
+ * their cached buffers the next time they allocate or free one.
+ */
+void SetVectorPoolOptions(const VectorPoolOptions& options);
+VectorPoolOptions GetVectorPoolOptions();
+
+/*
+ * Counters since the start of the process or the last ResetVectorPoolStatistics. They are
+ * updated without synchronising the threads, so a snapshot taken while other threads allocate may
+ * be slightly inconsistent.
+ */
+VectorPoolStatistics GetVectorPoolStatistics() noexcept;
+void ResetVectorPoolStatistics() noexcept;
+
+/*
+ * Frees every buffer on the shared free lists and in the calling thread's cache.
+ */
+void TrimVectorPool();
+
+namespace ev::detail {
+
+/*
+ * Gives a buffer of capacity doubles back to the pool or the heap.
+ */
+void FreeVectorBuffer(double* p, int capacity) noexcept;
+
+struct VectorBufferDeleter {
+  // Doubles in the buffer: the size class, not the number of dimensions of the vector.
+  int capacity = 0;
+
+  void operator()(double* p) const noexcept { FreeVectorBuffer(p, capacity); }
+};
+
+using VectorBuffer = std::unique_ptr<double[], VectorBufferDeleter>;
+
+/*
+ * Returns an uninitialised, cache-line aligned buffer of at least count doubles, rounded up to
+ * whole cache lines, or an empty buffer when count is 0.
+ * When: count > kMaxPaddedCount (see aligned_buffer.h)
+ * Throw: std::bad_array_new_length
+ * When: the heap is exhausted
+ * Throw: std::bad_alloc
+ */
+VectorBuffer AllocateVectorBuffer(int count);
+
+}  // namespace ev::detail
+
+#endif  // ASSIGNMENTS_EV_VECTOR_POOL_H_
@@ -0,0 +1,162 @@
+/*
+
+  == Explanation and rational of testing ==
+
+  The pool is global, so each section starts from trimmed free lists and reset counters, and
+  leaves the pool disabled. We check that buffers are aligned whether or not the pool is on, that
+  a warmed-up loop of a few dimensions is served almost entirely from the free lists, and that
+  a freed buffer is the next one handed out for its size class. The byte cap and the dimension
+  limit must send buffers back to the heap. Threads that allocate and free, and exit with buffers
+  cached, must leave every buffer accounted for. Vector values must not be affected at any point.
+
+*/
+
+#include "assignments/ev/vector_pool.h"
+
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+#include "assignments/ev/euclidean_vector.h"
+#include "catch.h"
+
+namespace {
+
+// Enables the pool with the given options for the lifetime of the object, starting and ending
+// with empty free lists and zeroed counters.
+struct ScopedPool {
+  explicit ScopedPool(VectorPoolOptions options = {}) {
+    options.enabled = true;
+    TrimVectorPool();
+    ResetVectorPoolStatistics();
+    SetVectorPoolOptions(options);
+  }
+  ~ScopedPool() {
+    SetVectorPoolOptions({});
+    ResetVectorPoolStatistics();
+  }
+};
+
+bool IsCacheLineAligned(const EuclideanVector& v) {
+  return reinterpret_cast<std::uintptr_t>(v.data()) % 64 == 0;
+}
+
+}  // namespace
+
+TEST_CASE("Vector pool") {
+  SECTION("TEST CASE 1 - Buffers are aligned and the pool is off by default") {
+    REQUIRE_FALSE(GetVectorPoolOptions().enabled);
+    ResetVectorPoolStatistics();
+    for (auto n : {1, 3, 8, 9, 100}) {
+      const EuclideanVector v(n, 2.0);
+      REQUIRE(IsCacheLineAligned(v));
+      REQUIRE(v.Sum() == 2.0 * n);
+    }
+    REQUIRE(GetVectorPoolStatistics().hits == 0);
+    REQUIRE(GetVectorPoolStatistics().misses == 0);
+  }
+
+  SECTION("TEST CASE 2 - A warmed-up loop is served from the free lists") {
+    ScopedPool pool;
+    for (auto i = 0; i < 1000; ++i) {
+      for (auto n : {3, 16, 100}) {
+        EuclideanVector v(n, i);
+        const auto w = v * 2.0;
+        REQUIRE(IsCacheLineAligned(w));
+        REQUIRE(w[n - 1] == 2.0 * i);
+      }
+    }
+    const auto statistics = GetVectorPoolStatistics();
+    REQUIRE(statistics.hits + statistics.misses == 6000);
+    REQUIRE(statistics.misses <= 6);
+    REQUIRE(statistics.GetHitRate() > 0.99);
+    REQUIRE(statistics.recycled == 6000);
+    REQUIRE(statistics.released == 0);
+    REQUIRE(statistics.cached_bytes > 0);
+    TrimVectorPool();
+    REQUIRE(GetVectorPoolStatistics().cached_bytes == 0);
+  }
+
+  SECTION("TEST CASE 3 - A freed buffer is reused for its size class only") {
+    ScopedPool pool;
+    const double* first;
+    {
+      const EuclideanVector v(10);
+      first = v.data();
+    }
+    // 10 and 12 dimensions share a two cache line size class; 20 does not.
+    const EuclideanVector other(20, 1.0);
+    REQUIRE(other.data() != first);
+    const EuclideanVector reused(12, 1.0);
+    REQUIRE(reused.data() == first);
+    REQUIRE(reused.Sum() == 12);
+
+    // Assigning a vector of the same size class keeps the buffer.
+    EuclideanVector target(11);
+    const auto* buffer = target.data();
+    target = reused;
+    REQUIRE(target.data() == buffer);
+    REQUIRE(target == reused);
+  }
+
+  SECTION("TEST CASE 4 - The byte cap and dimension limit send buffers to the heap") {
+    VectorPoolOptions options;
+    options.max_cached_bytes = 3 * 64;
+    options.max_pooled_dimensions = 32;
+    ScopedPool pool(options);
+    {
+      std::vector<EuclideanVector> vectors;
+      vectors.reserve(5);
+      for (auto i = 0; i < 5; ++i) {
+        vectors.emplace_back(8);
+      }
+    }
+    auto statistics = GetVectorPoolStatistics();
+    REQUIRE(statistics.recycled == 3);
+    REQUIRE(statistics.released == 2);
+    REQUIRE(statistics.cached_bytes == 3 * 64);
+    {
+      const EuclideanVector large(33);
+    }
+    statistics = GetVectorPoolStatistics();
+    REQUIRE(statistics.released == 3);
+    REQUIRE(statistics.misses == 6);
+  }
+
+  SECTION("TEST CASE 5 - Threads hand their cached buffers back when they exit") {
+    ScopedPool pool;
+    std::vector<std::thread> threads;
+    for (auto t = 0; t < 4; ++t) {
+      threads.emplace_back([t] {
+        std::vector<EuclideanVector> vectors;
+        for (auto i = 0; i < 200; ++i) {
+          vectors.emplace_back(5 + t, i);
+          if (vectors.size() > 50) {
+            vectors.erase(vectors.begin(), vectors.begin() + 25);
+          }
+        }
+      });
+    }
+    for (auto& thread : threads) {
+      thread.join();
+    }
+    auto statistics = GetVectorPoolStatistics();
+    REQUIRE(statistics.hits + statistics.misses == statistics.recycled + statistics.released);
+    REQUIRE(statistics.cached_bytes == statistics.misses * 64);
+    // The buffers the threads left behind are reused here.
+    ResetVectorPoolStatistics();
+    std::vector<EuclideanVector> vectors(8, EuclideanVector(7));
+    REQUIRE(GetVectorPoolStatistics().misses == 0);
+  }
+
+  SECTION("TEST CASE 6 - Disabling the pool frees the free lists") {
+    {
+      ScopedPool pool;
+      const EuclideanVector v(50);
+    }
+    REQUIRE(GetVectorPoolStatistics().cached_bytes == 0);
+    const EuclideanVector v(50, 1.0);
+    REQUIRE(IsCacheLineAligned(v));
+    REQUIRE(GetVectorPoolStatistics().hits == 0);
+  }
+}